@@ -0,0 +1,259 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// Native-side counterpart of `binding_benchmarks.ts`.
+//
+// Measures the cost of the TensorFlow C API calls that the binding makes for
+// `createTensor()`, `executeOp()`, `tensorDataSync()` and string tensors,
+// without N-API. The difference to the numbers measured through the binding
+// is the overhead of the JavaScript <-> native boundary.
+//
+// Results are printed to stdout, one JSON object per line.
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+#include "tensorflow/c/c_api.h"
+#include "tensorflow/c/eager/c_api.h"
+
+namespace {
+
+// Minimum wall time spent on each benchmark.
+const double kMinDurationNanos = 2e8;
+
+void CheckOk(TF_Status *status, const char *what) {
+  if (TF_GetCode(status) != TF_OK) {
+    fprintf(stderr, "%s failed: %s\n", what, TF_Message(status));
+    exit(1);
+  }
+}
+
+double NowNanos() {
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Runs `fn` until at least kMinDurationNanos have passed and prints the mean
+// time per call.
+void Run(const std::string &name, const std::string &params,
+         const std::function<void()> &fn) {
+  // Warm up, e.g., kernel caches.
+  for (int i = 0; i < 10; ++i) {
+    fn();
+  }
+  int64_t iterations = 0;
+  const double start = NowNanos();
+  double elapsed = 0;
+  int64_t batch = 1;
+  while (elapsed < kMinDurationNanos) {
+    for (int64_t i = 0; i < batch; ++i) {
+      fn();
+    }
+    iterations += batch;
+    batch *= 2;
+    elapsed = NowNanos() - start;
+  }
+  printf(
+      "{\"suite\": \"native\", \"name\": \"%s\", %s\"iterations\": %lld, "
+      "\"nsPerCall\": %.1f}\n",
+      name.c_str(), params.c_str(), static_cast<long long>(iterations),
+      elapsed / iterations);
+  fflush(stdout);
+}
+
+std::string Params(const char *dtype, int64_t size) {
+  char buffer[100];
+  snprintf(buffer, sizeof(buffer), "\"dtype\": \"%s\", \"size\": %lld, ",
+           dtype, static_cast<long long>(size));
+  return buffer;
+}
+
+TFE_TensorHandle *NewHandle(TF_DataType dtype, const void *data,
+                            int64_t num_elements, TF_Status *status) {
+  const int64_t dims[] = {num_elements};
+  const size_t byte_size = num_elements * TF_DataTypeSize(dtype);
+  TF_Tensor *tensor = TF_AllocateTensor(dtype, dims, 1, byte_size);
+  memcpy(TF_TensorData(tensor), data, byte_size);
+  TFE_TensorHandle *handle = TFE_NewTensorHandle(tensor, status);
+  TF_DeleteTensor(tensor);
+  CheckOk(status, "TFE_NewTensorHandle");
+  return handle;
+}
+
+// Equivalent of the binding's createTensor(): copy values into a new tensor.
+void BenchmarkCreateTensor(TF_Status *status) {
+  for (int64_t size : {1, 1000, 1000000}) {
+    std::vector<float> floats(size, 1.0f);
+    Run("createTensor", Params("float32", size), [&] {
+      TFE_DeleteTensorHandle(
+          NewHandle(TF_FLOAT, floats.data(), size, status));
+    });
+    std::vector<int32_t> ints(size, 1);
+    Run("createTensor", Params("int32", size), [&] {
+      TFE_DeleteTensorHandle(NewHandle(TF_INT32, ints.data(), size, status));
+    });
+  }
+}
+
+// Equivalent of the binding's executeOp() for trivial ops with 0, 2 and 7
+// attributes.
+void BenchmarkExecuteOp(TFE_Context *context, TF_Status *status) {
+  const float value = 1.0f;
+  TFE_TensorHandle *x = NewHandle(TF_FLOAT, &value, 1, status);
+  const int32_t shape_value = 1;
+  TFE_TensorHandle *shape = NewHandle(TF_INT32, &shape_value, 1, status);
+  const int32_t begin_value = 0;
+  TFE_TensorHandle *begin = NewHandle(TF_INT32, &begin_value, 1, status);
+
+  Run("executeOp", "\"op\": \"NoOp\", \"numAttrs\": 0, ", [&] {
+    TFE_Op *op = TFE_NewOp(context, "NoOp", status);
+    CheckOk(status, "TFE_NewOp");
+    int num_retvals = 0;
+    TFE_Execute(op, nullptr, &num_retvals, status);
+    CheckOk(status, "TFE_Execute");
+    TFE_DeleteOp(op);
+  });
+
+  Run("executeOp", "\"op\": \"Reshape\", \"numAttrs\": 2, ", [&] {
+    TFE_Op *op = TFE_NewOp(context, "Reshape", status);
+    CheckOk(status, "TFE_NewOp");
+    TFE_OpAddInput(op, x, status);
+    TFE_OpAddInput(op, shape, status);
+    TFE_OpSetAttrType(op, "T", TF_FLOAT);
+    TFE_OpSetAttrType(op, "Tshape", TF_INT32);
+    TFE_TensorHandle *retval;
+    int num_retvals = 1;
+    TFE_Execute(op, &retval, &num_retvals, status);
+    CheckOk(status, "TFE_Execute");
+    TFE_DeleteTensorHandle(retval);
+    TFE_DeleteOp(op);
+  });
+
+  Run("executeOp", "\"op\": \"StridedSlice\", \"numAttrs\": 7, ", [&] {
+    TFE_Op *op = TFE_NewOp(context, "StridedSlice", status);
+    CheckOk(status, "TFE_NewOp");
+    TFE_OpAddInput(op, x, status);
+    TFE_OpAddInput(op, begin, status);
+    TFE_OpAddInput(op, shape, status);
+    TFE_OpAddInput(op, shape, status);
+    TFE_OpSetAttrType(op, "T", TF_FLOAT);
+    TFE_OpSetAttrType(op, "Index", TF_INT32);
+    TFE_OpSetAttrInt(op, "begin_mask", 0);
+    TFE_OpSetAttrInt(op, "end_mask", 0);
+    TFE_OpSetAttrInt(op, "ellipsis_mask", 0);
+    TFE_OpSetAttrInt(op, "new_axis_mask", 0);
+    TFE_OpSetAttrInt(op, "shrink_axis_mask", 0);
+    TFE_TensorHandle *retval;
+    int num_retvals = 1;
+    TFE_Execute(op, &retval, &num_retvals, status);
+    CheckOk(status, "TFE_Execute");
+    TFE_DeleteTensorHandle(retval);
+    TFE_DeleteOp(op);
+  });
+
+  TFE_DeleteTensorHandle(x);
+  TFE_DeleteTensorHandle(shape);
+  TFE_DeleteTensorHandle(begin);
+}
+
+// Equivalent of the binding's tensorDataSync(): resolve and copy out.
+void BenchmarkTensorDataSync(TF_Status *status) {
+  for (int64_t size : {1, 1000, 1000000}) {
+    std::vector<float> values(size, 1.0f);
+    std::vector<float> output(size);
+    TFE_TensorHandle *handle =
+        NewHandle(TF_FLOAT, values.data(), size, status);
+    Run("tensorDataSync", Params("float32", size), [&] {
+      TF_Tensor *tensor = TFE_TensorHandleResolve(handle, status);
+      CheckOk(status, "TFE_TensorHandleResolve");
+      memcpy(output.data(), TF_TensorData(tensor), TF_TensorByteSize(tensor));
+      TF_DeleteTensor(tensor);
+    });
+    TFE_DeleteTensorHandle(handle);
+  }
+}
+
+// Encodes `size` strings of `length` bytes into a string tensor, then
+// resolves and decodes them again.
+void BenchmarkStringRoundTrip(TF_Status *status) {
+  const size_t length = 16;
+  const std::string value(length, 'x');
+  for (int64_t size : {1, 1000}) {
+    Run("stringRoundTrip", Params("string", size), [&] {
+      const size_t offsets_size = size * sizeof(uint64_t);
+      const size_t data_size =
+          offsets_size + size * TF_StringEncodedSize(length);
+      const int64_t dims[] = {size};
+      TF_Tensor *tensor = TF_AllocateTensor(TF_STRING, dims, 1, data_size);
+      uint64_t *offsets = static_cast<uint64_t *>(TF_TensorData(tensor));
+      char *data_start = static_cast<char *>(TF_TensorData(tensor)) +
+                         offsets_size;
+      char *data = data_start;
+      for (int64_t i = 0; i < size; ++i) {
+        offsets[i] = data - data_start;
+        data += TF_StringEncode(value.data(), length, data,
+                                data_size - (data - data_start), status);
+        CheckOk(status, "TF_StringEncode");
+      }
+      TFE_TensorHandle *handle = TFE_NewTensorHandle(tensor, status);
+      CheckOk(status, "TFE_NewTensorHandle");
+      TF_DeleteTensor(tensor);
+
+      TF_Tensor *resolved = TFE_TensorHandleResolve(handle, status);
+      CheckOk(status, "TFE_TensorHandleResolve");
+      const char *resolved_data =
+          static_cast<const char *>(TF_TensorData(resolved)) + offsets_size;
+      const uint64_t *resolved_offsets =
+          static_cast<const uint64_t *>(TF_TensorData(resolved));
+      for (int64_t i = 0; i < size; ++i) {
+        const char *decoded;
+        size_t decoded_length;
+        TF_StringDecode(resolved_data + resolved_offsets[i],
+                        data_size - offsets_size - resolved_offsets[i],
+                        &decoded, &decoded_length, status);
+        CheckOk(status, "TF_StringDecode");
+      }
+      TF_DeleteTensor(resolved);
+      TFE_DeleteTensorHandle(handle);
+    });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  TF_Status *status = TF_NewStatus();
+  TFE_ContextOptions *options = TFE_NewContextOptions();
+  TFE_Context *context = TFE_NewContext(options, status);
+  CheckOk(status, "TFE_NewContext");
+  TFE_DeleteContextOptions(options);
+
+  BenchmarkCreateTensor(status);
+  BenchmarkExecuteOp(context, status);
+  BenchmarkTensorDataSync(status);
+  BenchmarkStringRoundTrip(status);
+
+  TFE_DeleteContext(context);
+  TF_DeleteStatus(status);
+  return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+/**
+ * Microbenchmarks of the N-API binding.
+ *
+ * Measures the per-call cost of `createTensor()` by dtype and size,
+ * `executeOp()` for trivial ops with 0, 2 and 7 attributes,
+ * `tensorDataSync()` by size and string tensor round-trips. If the native
+ * harness has been built (`yarn build-benchmarks`), its results for the same
+ * operations without N-API are included, so that the binding overhead can be
+ * read off directly.
+ *
+ * Usage:
+ *   yarn benchmark-binding [--output=results.json]
+ *
+ * Results are written as JSON to stdout, or to the `--output` file.
+ */
+
+import {execFileSync} from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import {TFJSBinding} from '../src/tfjs_binding';
+
+// tslint:disable-next-line:no-require-imports
+const binary = require('node-pre-gyp');
+const bindingPath =
+    binary.find(path.resolve(path.join(__dirname, '/../package.json')));
+// tslint:disable-next-line:no-require-imports
+const binding = require(bindingPath) as TFJSBinding;
+
+const NATIVE_HARNESS_PATH =
+    path.join(__dirname, '..', 'build', 'Release', 'binding_benchmark');
+
+// Minimum wall time spent on each benchmark.
+const MIN_DURATION_MS = 200;
+
+export interface BenchmarkResult {
+  suite: 'binding'|'native';
+  name: string;
+  iterations: number;
+  nsPerCall: number;
+  [param: string]: string|number;
+}
+
+function nowNanos(): number {
+  const [seconds, nanos] = process.hrtime();
+  return seconds * 1e9 + nanos;
+}
+
+/**
+ * Runs `fn` until at least `MIN_DURATION_MS` have passed and returns the mean
+ * time per call.
+ */
+function run(
+    name: string, params: {[param: string]: string | number},
+    fn: () => void): BenchmarkResult {
+  // Warm up, e.g., the JIT and kernel caches.
+  for (let i = 0; i < 10; ++i) {
+    fn();
+  }
+  let iterations = 0;
+  let batch = 1;
+  const start = nowNanos();
+  let elapsed = 0;
+  while (elapsed < MIN_DURATION_MS * 1e6) {
+    for (let i = 0; i < batch; ++i) {
+      fn();
+    }
+    iterations += batch;
+    batch *= 2;
+    elapsed = nowNanos() - start;
+  }
+  return {
+    suite: 'binding',
+    name,
+    ...params,
+    iterations,
+    nsPerCall: elapsed / iterations
+  };
+}
+
+const SIZES = [1, 1000, 1000000];
+
+function benchmarkCreateTensor(): BenchmarkResult[] {
+  const results: BenchmarkResult[] = [];
+  for (const size of SIZES) {
+    const floats = new Float32Array(size).fill(1);
+    results.push(run('createTensor', {dtype: 'float32', size}, () => {
+      binding.deleteTensor(
+          binding.createTensor([size], binding.TF_FLOAT, floats));
+    }));
+    const ints = new Int32Array(size).fill(1);
+    results.push(run('createTensor', {dtype: 'int32', size}, () => {
+      binding.deleteTensor(
+          binding.createTensor([size], binding.TF_INT32, ints));
+    }));
+    const bools = new Uint8Array(size).fill(1);
+    results.push(run('createTensor', {dtype: 'bool', size}, () => {
+      binding.deleteTensor(
+          binding.createTensor([size], binding.TF_BOOL, bools));
+    }));
+  }
+  return results;
+}
+
+function benchmarkExecuteOp(): BenchmarkResult[] {
+  const x = binding.createTensor([1], binding.TF_FLOAT, new Float32Array([1]));
+  const shape =
+      binding.createTensor([1], binding.TF_INT32, new Int32Array([1]));
+  const begin =
+      binding.createTensor([1], binding.TF_INT32, new Int32Array([0]));
+  const typeAttr = (name: string, value: number) =>
+      ({name, type: binding.TF_ATTR_TYPE, value});
+  const intAttr = (name: string, value: number) =>
+      ({name, type: binding.TF_ATTR_INT, value});
+
+  // The attributes are built on every call, as the backend does.
+  const results = [
+    run('executeOp', {op: 'NoOp', numAttrs: 0}, () => {
+      binding.executeOp('NoOp', [], [], 0);
+    }),
+    run('executeOp', {op: 'Reshape', numAttrs: 2}, () => {
+      const opAttrs = [
+        typeAttr('T', binding.TF_FLOAT), typeAttr('Tshape', binding.TF_INT32)
+      ];
+      const [y] = binding.executeOp('Reshape', opAttrs, [x, shape], 1);
+      binding.deleteTensor(y.id);
+    }),
+    // StridedSlice has the most attributes of the trivial CPU kernels.
+    run('executeOp', {op: 'StridedSlice', numAttrs: 7}, () => {
+      const opAttrs = [
+        typeAttr('T', binding.TF_FLOAT), typeAttr('Index', binding.TF_INT32),
+        intAttr('begin_mask', 0), intAttr('end_mask', 0),
+        intAttr('ellipsis_mask', 0), intAttr('new_axis_mask', 0),
+        intAttr('shrink_axis_mask', 0)
+      ];
+      const [y] = binding.executeOp(
+          'StridedSlice', opAttrs, [x, begin, shape, shape], 1);
+      binding.deleteTensor(y.id);
+    })
+  ];
+  [x, shape, begin].forEach(id => binding.deleteTensor(id));
+  return results;
+}
+
+function benchmarkTensorDataSync(): BenchmarkResult[] {
+  return SIZES.map(size => {
+    const id = binding.createTensor(
+        [size], binding.TF_FLOAT, new Float32Array(size).fill(1));
+    const result = run('tensorDataSync', {dtype: 'float32', size}, () => {
+      binding.tensorDataSync(id);
+    });
+    binding.deleteTensor(id);
+    return result;
+  });
+}
+
+function benchmarkStringRoundTrip(): BenchmarkResult[] {
+  const value = new Uint8Array(16).fill('x'.charCodeAt(0));
+  return [1, 1000].map(size => {
+    const values: Uint8Array[] = [];
+    for (let i = 0; i < size; ++i) {
+      values.push(value);
+    }
+    return run('stringRoundTrip', {dtype: 'string', size}, () => {
+      const id = binding.createTensor([size], binding.TF_STRING, values);
+      binding.tensorDataSync(id);
+      binding.deleteTensor(id);
+    });
+  });
+}
+
+function runNativeHarness(): BenchmarkResult[] {
+  if (!fs.existsSync(NATIVE_HARNESS_PATH)) {
+    console.error(
+        `Native harness not found at ${NATIVE_HARNESS_PATH}, skipping. ` +
+        `Build it with \`yarn build-benchmarks\`.`);
+    return [];
+  }
+  const output = execFileSync(NATIVE_HARNESS_PATH, {encoding: 'utf8'});
+  return output.split('\n')
+      .filter(line => line.trim().length > 0)
+      .map(line => JSON.parse(line) as BenchmarkResult);
+}
+
+function main() {
+  const outputArg = process.argv.find(arg => arg.startsWith('--output='));
+
+  const results = [
+    ...benchmarkCreateTensor(), ...benchmarkExecuteOp(),
+    ...benchmarkTensorDataSync(), ...benchmarkStringRoundTrip(),
+    ...runNativeHarness()
+  ];
+  const report = JSON.stringify(
+      {
+        environment: {
+          tfVersion: binding.TF_Version,
+          nodeVersion: process.version,
+          platform: `${os.platform()}-${os.arch()}`,
+          cpus: os.cpus().length > 0 ? os.cpus()[0].model : '',
+          numCpus: os.cpus().length
+        },
+        results
+      },
+      null, 2);
+
+  if (outputArg != null) {
+    fs.writeFileSync(outputArg.slice('--output='.length), report);
+  } else {
+    console.log(report);
+  }
+}
+
+main();
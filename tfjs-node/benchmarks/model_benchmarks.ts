@@ -0,0 +1,343 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+/**
+ * End-to-end model throughput and latency benchmarks.
+ *
+ * Loads models through the `file://` IO handler and runs them at several
+ * batch sizes and concurrency levels. For every combination, reports the
+ * throughput, p50/p99 latency, event-loop delay, RSS and tensor memory.
+ *
+ * Synthetic reference models (an MLP, a small CNN and an embedding+LSTM
+ * model) are generated locally on first use, so no network is needed.
+ *
+ * Usage:
+ *   yarn benchmark-models [--models=mlp,cnn,lstm] [--batch-sizes=1,8,32]
+ *       [--concurrency=1,4,16] [--duration=5] [--batch-scheduler]
+ *       [--layers-model=path/to/model.json] [--graph-model=path/to/model.json]
+ *       [--output=results.json]
+ *
+ * Results are written as JSON to stdout, or to the `--output` file.
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import * as tf from '../src/index';
+
+const MODELS_DIR = path.join(os.tmpdir(), 'tfjs-node-benchmark-models');
+
+interface Options {
+  models: string[];
+  batchSizes: number[];
+  concurrency: number[];
+  durationSeconds: number;
+  batchScheduler: boolean;
+  layersModel: string;
+  graphModel: string;
+  output: string;
+}
+
+interface ModelResult {
+  model: string;
+  batchSize: number;
+  concurrency: number;
+  batchScheduler: boolean;
+  requests: number;
+  examplesPerSecond: number;
+  p50LatencyMs: number;
+  p99LatencyMs: number;
+  meanEventLoopDelayMs: number;
+  maxEventLoopDelayMs: number;
+  rssBytes: number;
+  numTensors: number;
+  tensorBytes: number;
+}
+
+function parseOptions(): Options {
+  const args: {[name: string]: string} = {};
+  for (const arg of process.argv.slice(2)) {
+    const match = /^--([^=]+)(?:=(.*))?$/.exec(arg);
+    if (match == null) {
+      throw new Error(`Unknown argument: ${arg}`);
+    }
+    args[match[1]] = match[2] == null ? 'true' : match[2];
+  }
+  const list = (value: string, defaultValue: string) =>
+      (value == null ? defaultValue : value).split(',');
+  return {
+    models: args['models'] == null && (args['layers-model'] != null ||
+                                       args['graph-model'] != null) ?
+        [] :
+        list(args['models'], 'mlp,cnn,lstm'),
+    batchSizes: list(args['batch-sizes'], '1,8,32').map(Number),
+    concurrency: list(args['concurrency'], '1,4,16').map(Number),
+    durationSeconds: Number(args['duration'] || 5),
+    batchScheduler: args['batch-scheduler'] === 'true',
+    layersModel: args['layers-model'],
+    graphModel: args['graph-model'],
+    output: args['output']
+  };
+}
+
+/** Builds the synthetic reference models. */
+function createReferenceModel(name: string): tf.LayersModel {
+  const model = tf.sequential();
+  switch (name) {
+    case 'mlp':
+      model.add(tf.layers.dense(
+          {units: 256, activation: 'relu', inputShape: [784]}));
+      model.add(tf.layers.dense({units: 256, activation: 'relu'}));
+      model.add(tf.layers.dense({units: 10, activation: 'softmax'}));
+      break;
+    case 'cnn':
+      model.add(tf.layers.conv2d({
+        filters: 16,
+        kernelSize: 3,
+        activation: 'relu',
+        inputShape: [28, 28, 1]
+      }));
+      model.add(tf.layers.maxPooling2d({poolSize: 2}));
+      model.add(
+          tf.layers.conv2d({filters: 32, kernelSize: 3, activation: 'relu'}));
+      model.add(tf.layers.maxPooling2d({poolSize: 2}));
+      model.add(tf.layers.flatten());
+      model.add(tf.layers.dense({units: 10, activation: 'softmax'}));
+      break;
+    case 'lstm':
+      model.add(tf.layers.embedding(
+          {inputDim: 1000, outputDim: 32, inputLength: 32}));
+      model.add(tf.layers.lstm({units: 64}));
+      model.add(tf.layers.dense({units: 1, activation: 'sigmoid'}));
+      break;
+    default:
+      throw new Error(`Unknown reference model: ${name}`);
+  }
+  return model;
+}
+
+/** Returns the path of a reference model, saving it first if needed. */
+async function getReferenceModelPath(name: string): Promise<string> {
+  const modelDir = path.join(MODELS_DIR, name);
+  const modelPath = path.join(modelDir, 'model.json');
+  if (!fs.existsSync(modelPath)) {
+    const model = createReferenceModel(name);
+    await model.save(`file://${modelDir}`);
+  }
+  return modelPath;
+}
+
+/** Creates a random input for a model input of the given shape and dtype. */
+function createInput(
+    shape: number[], dtype: tf.DataType, batchSize: number): tf.Tensor {
+  const inputShape = [batchSize, ...shape.slice(1).map(d => d == null ? 1 : d)];
+  if (dtype === 'int32') {
+    return tf.randomUniform(inputShape, 0, 10, 'int32');
+  }
+  // Layers models declare float32 inputs, also for embedding layers; values
+  // in [0, 10) are valid token ids for the reference models.
+  return tf.randomUniform(inputShape, 0, 10).floor();
+}
+
+/**
+ * Samples the event-loop delay. Uses `perf_hooks.monitorEventLoopDelay()`
+ * where available (Node.js >= 11.10), and timer drift otherwise.
+ */
+class EventLoopDelaySampler {
+  // tslint:disable-next-line:no-any
+  private histogram: any;
+  private timer: NodeJS.Timer;
+  private delays: number[] = [];
+
+  start() {
+    // tslint:disable-next-line:no-require-imports
+    const perfHooks = require('perf_hooks');
+    if (perfHooks.monitorEventLoopDelay != null) {
+      this.histogram = perfHooks.monitorEventLoopDelay({resolution: 10});
+      this.histogram.enable();
+    } else {
+      const intervalMs = 10;
+      let last = Date.now();
+      this.timer = setInterval(() => {
+        const now = Date.now();
+        this.delays.push(Math.max(0, now - last - intervalMs));
+        last = now;
+      }, intervalMs);
+    }
+  }
+
+  /** Stops sampling and returns the mean and max delay in milliseconds. */
+  stop(): {mean: number, max: number} {
+    if (this.histogram != null) {
+      this.histogram.disable();
+      return {mean: this.histogram.mean / 1e6, max: this.histogram.max / 1e6};
+    }
+    clearInterval(this.timer);
+    const sum = this.delays.reduce((a, b) => a + b, 0);
+    return {
+      mean: this.delays.length > 0 ? sum / this.delays.length : 0,
+      max: this.delays.length > 0 ? Math.max(...this.delays) : 0
+    };
+  }
+}
+
+function percentile(sortedValues: number[], p: number): number {
+  if (sortedValues.length === 0) {
+    return 0;
+  }
+  const index = Math.min(
+      sortedValues.length - 1, Math.floor(p / 100 * sortedValues.length));
+  return sortedValues[index];
+}
+
+/**
+ * Runs `concurrency` request loops against the model for the given duration.
+ * Each request creates its input, runs the model and reads the output back.
+ */
+async function benchmarkModel(
+    name: string, model: tf.InferenceModel, inputShape: number[],
+    inputDtype: tf.DataType, batchSize: number, concurrency: number,
+    options: Options): Promise<ModelResult> {
+  const scheduler =
+      options.batchScheduler ? tf.node.batchScheduler(model) : null;
+  const predict = async(input: tf.Tensor): Promise<tf.Tensor|tf.Tensor[]> =>
+      scheduler != null ? scheduler.predict(input) : model.predict(input, {});
+
+  // Warm up.
+  const warmupOutput = await predict(createInput(inputShape, inputDtype, 1));
+  tf.dispose(warmupOutput);
+
+  const latencies: number[] = [];
+  const sampler = new EventLoopDelaySampler();
+  const start = tf.util.now();
+  const end = start + options.durationSeconds * 1000;
+  sampler.start();
+
+  const loop = async () => {
+    while (tf.util.now() < end) {
+      const requestStart = tf.util.now();
+      const input = createInput(inputShape, inputDtype, batchSize);
+      const output = await predict(input);
+      const outputs = Array.isArray(output) ? output : [output];
+      await Promise.all(outputs.map(t => t.data()));
+      latencies.push(tf.util.now() - requestStart);
+      tf.dispose([input, ...outputs]);
+      // Let the other request loops run.
+      await new Promise(resolve => setImmediate(resolve));
+    }
+  };
+  const loops: Array<Promise<void>> = [];
+  for (let i = 0; i < concurrency; ++i) {
+    loops.push(loop());
+  }
+  await Promise.all(loops);
+
+  const elapsedSeconds = (tf.util.now() - start) / 1000;
+  const eventLoopDelay = sampler.stop();
+  latencies.sort((a, b) => a - b);
+  const memory = tf.memory();
+  return {
+    model: name,
+    batchSize,
+    concurrency,
+    batchScheduler: options.batchScheduler,
+    requests: latencies.length,
+    examplesPerSecond: latencies.length * batchSize / elapsedSeconds,
+    p50LatencyMs: percentile(latencies, 50),
+    p99LatencyMs: percentile(latencies, 99),
+    meanEventLoopDelayMs: eventLoopDelay.mean,
+    maxEventLoopDelayMs: eventLoopDelay.max,
+    rssBytes: process.memoryUsage().rss,
+    numTensors: memory.numTensors,
+    tensorBytes: memory.numBytes
+  };
+}
+
+async function main() {
+  const options = parseOptions();
+
+  const models: Array<{
+    name: string,
+    model: tf.InferenceModel,
+    inputShape: number[],
+    inputDtype: tf.DataType
+  }> = [];
+  const addLayersModel = async (name: string, modelPath: string) => {
+    const model = await tf.loadLayersModel(`file://${modelPath}`);
+    models.push({
+      name,
+      model,
+      inputShape: model.inputs[0].shape,
+      inputDtype: model.inputs[0].dtype
+    });
+  };
+  for (const name of options.models) {
+    await addLayersModel(name, await getReferenceModelPath(name));
+  }
+  if (options.layersModel != null) {
+    await addLayersModel(options.layersModel, options.layersModel);
+  }
+  if (options.graphModel != null) {
+    const model = await tf.loadGraphModel(`file://${options.graphModel}`);
+    models.push({
+      name: options.graphModel,
+      model,
+      inputShape: model.inputs[0].shape,
+      inputDtype: model.inputs[0].dtype
+    });
+  }
+
+  const results: ModelResult[] = [];
+  for (const {name, model, inputShape, inputDtype} of models) {
+    for (const batchSize of options.batchSizes) {
+      for (const concurrency of options.concurrency) {
+        const result = await benchmarkModel(
+            name, model, inputShape, inputDtype, batchSize, concurrency,
+            options);
+        console.error(
+            `${name} batchSize=${batchSize} concurrency=${concurrency}: ` +
+            `${result.examplesPerSecond.toFixed(1)} examples/s, ` +
+            `p50=${result.p50LatencyMs.toFixed(2)}ms ` +
+            `p99=${result.p99LatencyMs.toFixed(2)}ms`);
+        results.push(result);
+      }
+    }
+  }
+
+  const report = JSON.stringify(
+      {
+        environment: {
+          tfjsNodeVersion: tf.version['tfjs-node'],
+          nodeVersion: process.version,
+          platform: `${os.platform()}-${os.arch()}`,
+          numCpus: os.cpus().length
+        },
+        results
+      },
+      null, 2);
+  if (options.output != null) {
+    fs.writeFileSync(options.output, report);
+  } else {
+    console.log(report);
+  }
+}
+
+main().catch(e => {
+  console.error(e);
+  process.exit(1);
+});
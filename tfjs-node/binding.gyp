@@ -22,11 +22,17 @@
       '<@(tensorflow_include_dir)/tensorflow/c/c_api.h',
       '<@(tensorflow_include_dir)/tensorflow/c/eager/c_api.h',
     ],
-    'tensorflow-library-action': 'symlink'
+    'tensorflow-library-action': 'symlink',
+    # Set to 'true' (e.g., with `--build_benchmarks=true`) to also build the
+    # native benchmark harness in benchmarks/.
+    'build_benchmarks%': 'false'
   },
   'targets' : [{
     'target_name' : 'tfjs_binding',
     'sources' : [
+      'binding/chunk_copy_pool.cc',
+      'binding/op_metrics.cc',
+      'binding/summary_write_queue.cc',
       'binding/tfjs_backend.cc',
       'binding/tfjs_binding.cc'
     ],
@@ -104,5 +110,52 @@
     ],
   "defines": [
       "NAPI_VERSION=<(napi_build_version)"
+  ],
+  'conditions' : [
+    [
+      'build_benchmarks=="true"', {
+        'targets' : [{
+          'target_name' : 'binding_benchmark',
+          'type' : 'executable',
+          'sources' : [
+            'benchmarks/binding_benchmark.cc'
+          ],
+          'include_dirs' : [ '<(tensorflow_include_dir)' ],
+          'conditions' : [
+            [
+              'OS=="linux"', {
+                'libraries' : [
+                  '-Wl,-rpath,\$$ORIGIN/../../deps/lib',
+                  '-ltensorflow',
+                  '-ltensorflow_framework',
+                ],
+                'library_dirs' : ['<(module_root_dir)/deps/lib'],
+              }
+            ],
+            [
+              'OS=="mac"', {
+                'libraries' : [
+                  '<(module_root_dir)/deps/lib/libtensorflow.dylib',
+                  '<(module_root_dir)/deps/lib/libtensorflow_framework.dylib',
+                ],
+                'xcode_settings': {
+                  'OTHER_LDFLAGS': [
+                    '-Wl,-rpath,@loader_path/../../deps/lib'
+                  ]
+                },
+              }
+            ],
+            [
+              'OS=="win"', {
+                'defines': ['COMPILER_MSVC'],
+                'libraries': ['tensorflow'],
+                'library_dirs' : ['<(module_root_dir)/deps/lib'],
+                'msvs_disabled_warnings': [ 4190 ]
+              },
+            ]
+          ],
+        }]
+      }
+    ]
   ]
 }
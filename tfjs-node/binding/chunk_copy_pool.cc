@@ -0,0 +1,95 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "chunk_copy_pool.h"
+
+#include <string.h>
+
+namespace tfnodejs {
+
+ChunkCopyPool::ChunkCopyPool(size_t num_threads)
+    : chunks_(nullptr),
+      next_chunk_(0),
+      generation_(0),
+      num_busy_workers_(0),
+      stopping_(false) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&ChunkCopyPool::Run, this);
+  }
+}
+
+ChunkCopyPool::~ChunkCopyPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_available_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ChunkCopyPool::Copy(const std::vector<ChunkCopy>& chunks) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_ = &chunks;
+    next_chunk_ = 0;
+    ++generation_;
+    num_busy_workers_ = workers_.size();
+  }
+  work_available_.notify_all();
+
+  CopyPending(chunks);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this] { return num_busy_workers_ == 0; });
+  chunks_ = nullptr;
+}
+
+void ChunkCopyPool::Run() {
+  uint64_t last_generation = 0;
+  while (true) {
+    const std::vector<ChunkCopy>* chunks;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock, [this, last_generation] {
+        return stopping_ || generation_ != last_generation;
+      });
+      if (stopping_) {
+        return;
+      }
+      last_generation = generation_;
+      chunks = chunks_;
+    }
+
+    CopyPending(*chunks);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_busy_workers_;
+    }
+    work_done_.notify_one();
+  }
+}
+
+void ChunkCopyPool::CopyPending(const std::vector<ChunkCopy>& chunks) {
+  for (size_t i = next_chunk_++; i < chunks.size(); i = next_chunk_++) {
+    memcpy(chunks[i].dst, chunks[i].src, chunks[i].byte_length);
+  }
+}
+
+}  // namespace tfnodejs
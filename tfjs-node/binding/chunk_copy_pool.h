@@ -0,0 +1,77 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef TF_NODEJS_CHUNK_COPY_POOL_H_
+#define TF_NODEJS_CHUNK_COPY_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tfnodejs {
+
+// A typed array to copy into a tensor, see CreateTensorFromChunks().
+struct ChunkCopy {
+  const void* src;
+  size_t byte_length;
+  char* dst;
+};
+
+// Copies chunks of memory on a fixed set of threads.
+//
+// The threads are started once and wait between calls, so that large uploads
+// don't pay for creating and joining threads every time.
+class ChunkCopyPool {
+ public:
+  // Starts `num_threads` worker threads. The thread calling `Copy()` also
+  // copies chunks, so `num_threads` may be 0.
+  explicit ChunkCopyPool(size_t num_threads);
+  ~ChunkCopyPool();
+
+  // Copies every chunk and blocks until all of them are copied. Must not be
+  // called concurrently.
+  void Copy(const std::vector<ChunkCopy>& chunks);
+
+ private:
+  void Run();
+  // Copies chunks of `chunks` until none are left.
+  void CopyPending(const std::vector<ChunkCopy>& chunks);
+
+  std::mutex mutex_;
+  // Signaled when a new set of chunks is available or the pool is stopped.
+  std::condition_variable work_available_;
+  // Signaled when a worker is done with the current set of chunks.
+  std::condition_variable work_done_;
+  const std::vector<ChunkCopy>* chunks_;
+  // Index of the next chunk to copy. Incremented without holding `mutex_`.
+  std::atomic<size_t> next_chunk_;
+  // Incremented for every call to `Copy()`, so that each worker takes part in
+  // each call exactly once.
+  uint64_t generation_;
+  size_t num_busy_workers_;
+  bool stopping_;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace tfnodejs
+
+#endif  // TF_NODEJS_CHUNK_COPY_POOL_H_
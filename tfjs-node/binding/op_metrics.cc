@@ -0,0 +1,107 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "op_metrics.h"
+
+namespace tfnodejs {
+
+static std::atomic<uint64_t> next_instance_id(0);
+
+OpMetrics::OpMetrics()
+    : instance_id_(next_instance_id.fetch_add(1)),
+      num_allocations_(0),
+      num_allocated_bytes_(0),
+      num_uploads_(0),
+      num_upload_bytes_(0),
+      num_readbacks_(0),
+      num_readback_bytes_(0) {}
+
+OpMetrics::OpCounters* OpMetrics::GetOpCounters(const std::string& op_name) {
+  // Per-thread cache of the counters of every op name, by instance. Lookups
+  // of cached names don't allocate.
+  thread_local std::unordered_map<
+      uint64_t, std::unordered_map<std::string, OpCounters*>>
+      cache;
+  std::unordered_map<std::string, OpCounters*>& instance_cache =
+      cache[instance_id_];
+  auto cached = instance_cache.find(op_name);
+  if (cached != instance_cache.end()) {
+    return cached->second;
+  }
+
+  OpCounters* counters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<OpCounters>& entry = op_counters_[op_name];
+    if (!entry) {
+      entry.reset(new OpCounters());
+      entry->count = 0;
+      entry->total_nanos = 0;
+      for (int i = 0; i < kNumLatencyBuckets; i++) {
+        entry->latency_buckets[i] = 0;
+      }
+    }
+    counters = entry.get();
+  }
+  instance_cache[op_name] = counters;
+  return counters;
+}
+
+void OpMetrics::RecordOp(const std::string& op_name, uint64_t nanos) {
+  OpCounters* counters = GetOpCounters(op_name);
+  counters->count.fetch_add(1, std::memory_order_relaxed);
+  counters->total_nanos.fetch_add(nanos, std::memory_order_relaxed);
+
+  // Find the smallest bucket whose bound (2^i microseconds) holds `nanos`.
+  const uint64_t micros = (nanos + 999) / 1000;
+  int bucket = 0;
+  while (bucket < kNumLatencyBuckets - 1 &&
+         micros > (static_cast<uint64_t>(1) << bucket)) {
+    bucket++;
+  }
+  counters->latency_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<OpMetrics::OpSnapshot> OpMetrics::SnapshotOps() {
+  std::vector<OpSnapshot> snapshots;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : op_counters_) {
+    OpSnapshot snapshot;
+    snapshot.op_name = entry.first;
+    snapshot.count = entry.second->count.load(std::memory_order_relaxed);
+    snapshot.total_nanos =
+        entry.second->total_nanos.load(std::memory_order_relaxed);
+    for (int i = 0; i < kNumLatencyBuckets; i++) {
+      snapshot.latency_buckets.push_back(
+          entry.second->latency_buckets[i].load(std::memory_order_relaxed));
+    }
+    snapshots.push_back(snapshot);
+  }
+  return snapshots;
+}
+
+std::vector<std::pair<const char*, uint64_t>> OpMetrics::SnapshotCounters()
+    const {
+  return {{"numAllocations", num_allocations_.load()},
+          {"numAllocatedBytes", num_allocated_bytes_.load()},
+          {"numUploads", num_uploads_.load()},
+          {"numUploadBytes", num_upload_bytes_.load()},
+          {"numReadbacks", num_readbacks_.load()},
+          {"numReadbackBytes", num_readback_bytes_.load()}};
+}
+
+}  // namespace tfnodejs
@@ -0,0 +1,114 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef TF_NODEJS_OP_METRICS_H_
+#define TF_NODEJS_OP_METRICS_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tfnodejs {
+
+// Always-on counters for op executions and tensor transfers.
+//
+// Recording is lock-free: counters are relaxed atomics, and every thread
+// caches the per-op counters it has used, so the mutex is only taken the
+// first time a thread executes an op with a given name.
+class OpMetrics {
+ public:
+  // Op latencies are counted in log2-spaced buckets: bucket `i` counts
+  // latencies of at most 2^i microseconds, the last bucket counts the rest.
+  static const int kNumLatencyBuckets = 25;
+
+  struct OpCounters {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total_nanos;
+    std::atomic<uint64_t> latency_buckets[kNumLatencyBuckets];
+  };
+
+  // A consistent-enough copy of the counters of one op, for reporting.
+  struct OpSnapshot {
+    std::string op_name;
+    uint64_t count;
+    uint64_t total_nanos;
+    std::vector<uint64_t> latency_buckets;
+  };
+
+  OpMetrics();
+
+  // Records one execution of `op_name` that took `nanos` nanoseconds.
+  void RecordOp(const std::string& op_name, uint64_t nanos);
+
+  // Records tensor data that TensorFlow allocated for an op output or an
+  // upload.
+  void RecordAllocation(int64_t num_bytes) {
+    Add(&num_allocations_, 1);
+    Add(&num_allocated_bytes_, num_bytes);
+  }
+
+  // Records the creation of a tensor from JS data.
+  void RecordUpload(int64_t num_bytes) {
+    Add(&num_uploads_, 1);
+    Add(&num_upload_bytes_, num_bytes);
+  }
+
+  // Records a read of tensor data back to JS.
+  void RecordReadback(int64_t num_bytes) {
+    Add(&num_readbacks_, 1);
+    Add(&num_readback_bytes_, num_bytes);
+  }
+
+  // Returns the counters of every op that has been executed, by name.
+  std::vector<OpSnapshot> SnapshotOps();
+
+  // Returns the global counters by name.
+  std::vector<std::pair<const char*, uint64_t>> SnapshotCounters() const;
+
+ private:
+  static void Add(std::atomic<uint64_t>* counter, int64_t value) {
+    counter->fetch_add(static_cast<uint64_t>(value), std::memory_order_relaxed);
+  }
+
+  OpCounters* GetOpCounters(const std::string& op_name);
+
+  // Distinguishes instances in the per-thread caches, since the address of a
+  // destroyed instance may be reused.
+  const uint64_t instance_id_;
+
+  std::mutex mutex_;
+  // Entries are never removed, so the counters stay valid for the lifetime of
+  // this instance.
+  std::map<std::string, std::unique_ptr<OpCounters>> op_counters_;
+
+  std::atomic<uint64_t> num_allocations_;
+  std::atomic<uint64_t> num_allocated_bytes_;
+  std::atomic<uint64_t> num_uploads_;
+  std::atomic<uint64_t> num_upload_bytes_;
+  std::atomic<uint64_t> num_readbacks_;
+  std::atomic<uint64_t> num_readback_bytes_;
+};
+
+}  // namespace tfnodejs
+
+#endif  // TF_NODEJS_OP_METRICS_H_
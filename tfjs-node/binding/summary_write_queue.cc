@@ -0,0 +1,259 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include "summary_write_queue.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+#include "tf_auto_status.h"
+#include "tf_auto_tensor.h"
+#include "tfe_auto_op.h"
+
+namespace tfnodejs {
+
+// Upper bound on the number of pending jobs, so that a writer that can't keep
+// up doesn't grow memory unbounded.
+static const size_t kMaxQueuedJobs = 1024;
+
+// Creates a scalar tensor handle of a fixed-size dtype.
+static TFE_TensorHandle* NewScalarHandle(TF_DataType dtype, const void* value,
+                                         size_t byte_size,
+                                         TF_Status* tf_status) {
+  TF_AutoTensor tensor(TF_AllocateTensor(dtype, nullptr, 0, byte_size));
+  memcpy(TF_TensorData(tensor.tensor), value, byte_size);
+  return TFE_NewTensorHandle(tensor.tensor, tf_status);
+}
+
+// Creates a scalar string tensor handle.
+static TFE_TensorHandle* NewStringScalarHandle(const std::string& value,
+                                               TF_Status* tf_status) {
+  const size_t offsets_size = sizeof(uint64_t);
+  const size_t data_size = offsets_size + TF_StringEncodedSize(value.size());
+  TF_AutoTensor tensor(TF_AllocateTensor(TF_STRING, nullptr, 0, data_size));
+
+  char* tensor_data = static_cast<char*>(TF_TensorData(tensor.tensor));
+  *reinterpret_cast<uint64_t*>(tensor_data) = 0;
+  TF_StringEncode(value.data(), value.size(), tensor_data + offsets_size,
+                  data_size - offsets_size, tf_status);
+  if (TF_GetCode(tf_status) != TF_OK) {
+    return nullptr;
+  }
+  return TFE_NewTensorHandle(tensor.tensor, tf_status);
+}
+
+SummaryWriteQueue::SummaryWriteQueue(TFE_Context* tfe_context)
+    : tfe_context_(tfe_context),
+      job_running_(false),
+      stopping_(false),
+      num_dropped_(0) {
+  worker_ = std::thread(&SummaryWriteQueue::Run, this);
+}
+
+SummaryWriteQueue::~SummaryWriteQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_available_.notify_all();
+  worker_.join();
+
+  for (auto& kv : tag_handles_) {
+    TFE_DeleteTensorHandle(kv.second);
+  }
+}
+
+void SummaryWriteQueue::EnqueueScalars(int32_t writer_id,
+                                       TFE_TensorHandle* writer_handle,
+                                       int64_t step,
+                                       std::vector<std::string> tags,
+                                       std::vector<float> values) {
+  std::vector<TFE_TensorHandle*> value_handles(tags.size(), nullptr);
+  Enqueue(Job{writer_id, writer_handle, step, std::move(tags),
+              std::move(values), std::move(value_handles)});
+}
+
+void SummaryWriteQueue::EnqueueScalarTensor(int32_t writer_id,
+                                            TFE_TensorHandle* writer_handle,
+                                            int64_t step, std::string tag,
+                                            TFE_TensorHandle* value_handle) {
+  Enqueue(Job{writer_id, writer_handle, step,
+              std::vector<std::string>{std::move(tag)},
+              std::vector<float>{0.0f},
+              std::vector<TFE_TensorHandle*>{value_handle}});
+}
+
+void SummaryWriteQueue::Enqueue(Job job) {
+  {
+    // Called on the JS thread, so this must not wait for the worker.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (jobs_.size() < kMaxQueuedJobs) {
+      LogDroppedSummaries();
+      jobs_.push_back(std::move(job));
+    } else {
+      Job& last = jobs_.back();
+      if (last.writer_id == job.writer_id && last.step == job.step) {
+        last.tags.insert(last.tags.end(), job.tags.begin(), job.tags.end());
+        last.values.insert(last.values.end(), job.values.begin(),
+                           job.values.end());
+        last.value_handles.insert(last.value_handles.end(),
+                                  job.value_handles.begin(),
+                                  job.value_handles.end());
+        TFE_DeleteTensorHandle(job.writer_handle);
+      } else {
+        num_dropped_ += job.tags.size();
+        DeleteJobHandles(job);
+      }
+      return;
+    }
+  }
+  work_available_.notify_one();
+}
+
+void SummaryWriteQueue::LogDroppedSummaries() {
+  if (num_dropped_ > 0) {
+    fprintf(stderr,
+            "Dropped %zu TensorBoard summaries because writing them could "
+            "not keep up\n",
+            num_dropped_);
+    num_dropped_ = 0;
+  }
+}
+
+void SummaryWriteQueue::DeleteJobHandles(const Job& job) {
+  TFE_DeleteTensorHandle(job.writer_handle);
+  for (TFE_TensorHandle* value_handle : job.value_handles) {
+    if (value_handle != nullptr) {
+      TFE_DeleteTensorHandle(value_handle);
+    }
+  }
+}
+
+void SummaryWriteQueue::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  job_done_.wait(lock, [this] { return jobs_.empty() && !job_running_; });
+  LogDroppedSummaries();
+}
+
+std::string SummaryWriteQueue::TakeError() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string error;
+  error.swap(error_);
+  return error;
+}
+
+void SummaryWriteQueue::Run() {
+  TF_AutoStatus tf_status;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        // Stopping, and every job has been executed.
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      job_running_ = true;
+    }
+
+    TF_SetStatus(tf_status.status, TF_OK, "");
+    ExecuteJob(job, tf_status.status);
+    DeleteJobHandles(job);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_running_ = false;
+      if (TF_GetCode(tf_status.status) != TF_OK && error_.empty()) {
+        error_ = TF_Message(tf_status.status);
+      }
+    }
+    job_done_.notify_all();
+  }
+}
+
+void SummaryWriteQueue::ExecuteJob(const Job& job, TF_Status* tf_status) {
+  TFE_TensorHandle* step_handle =
+      NewScalarHandle(TF_INT64, &job.step, sizeof(job.step), tf_status);
+  if (TF_GetCode(tf_status) != TF_OK) {
+    return;
+  }
+
+  for (size_t i = 0; i < job.tags.size(); ++i) {
+    TFE_TensorHandle* tag_handle = GetTagHandle(job.tags[i], tf_status);
+    if (TF_GetCode(tf_status) != TF_OK) {
+      break;
+    }
+    // Values that are not tensors yet get a float tensor, which is deleted
+    // after the write. Tensor values are deleted with the job.
+    TFE_TensorHandle* value_handle = job.value_handles[i];
+    const bool owns_value_handle = value_handle == nullptr;
+    if (owns_value_handle) {
+      value_handle = NewScalarHandle(TF_FLOAT, &job.values[i],
+                                     sizeof(job.values[i]), tf_status);
+      if (TF_GetCode(tf_status) != TF_OK) {
+        break;
+      }
+    }
+
+    TFE_AutoOp tfe_op(
+        TFE_NewOp(tfe_context_, "WriteScalarSummary", tf_status));
+    if (TF_GetCode(tf_status) == TF_OK) {
+      TFE_OpAddInput(tfe_op.op, job.writer_handle, tf_status);
+    }
+    if (TF_GetCode(tf_status) == TF_OK) {
+      TFE_OpAddInput(tfe_op.op, step_handle, tf_status);
+    }
+    if (TF_GetCode(tf_status) == TF_OK) {
+      TFE_OpAddInput(tfe_op.op, tag_handle, tf_status);
+    }
+    if (TF_GetCode(tf_status) == TF_OK) {
+      TFE_OpAddInput(tfe_op.op, value_handle, tf_status);
+    }
+    if (TF_GetCode(tf_status) == TF_OK) {
+      TFE_OpSetAttrType(tfe_op.op, "T",
+                        TFE_TensorHandleDataType(value_handle));
+      TFE_TensorHandle* retvals[1];
+      int num_retvals = 0;
+      TFE_Execute(tfe_op.op, retvals, &num_retvals, tf_status);
+    }
+    if (owns_value_handle) {
+      TFE_DeleteTensorHandle(value_handle);
+    }
+    if (TF_GetCode(tf_status) != TF_OK) {
+      break;
+    }
+  }
+  TFE_DeleteTensorHandle(step_handle);
+}
+
+TFE_TensorHandle* SummaryWriteQueue::GetTagHandle(const std::string& tag,
+                                                  TF_Status* tf_status) {
+  auto entry = tag_handles_.find(tag);
+  if (entry != tag_handles_.end()) {
+    return entry->second;
+  }
+  TFE_TensorHandle* handle = NewStringScalarHandle(tag, tf_status);
+  if (TF_GetCode(tf_status) != TF_OK) {
+    return nullptr;
+  }
+  tag_handles_.insert(std::make_pair(tag, handle));
+  return handle;
+}
+
+}  // namespace tfnodejs
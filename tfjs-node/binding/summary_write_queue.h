@@ -0,0 +1,112 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef TF_NODEJS_SUMMARY_WRITE_QUEUE_H_
+#define TF_NODEJS_SUMMARY_WRITE_QUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tensorflow/c/eager/c_api.h"
+
+namespace tfnodejs {
+
+// Executes TensorBoard summary writes on a background thread.
+//
+// Jobs are executed in the order they are enqueued. Tag (name) tensors are
+// cached per tag and the step tensor is shared by all summaries of a job, so
+// that a bulk write only creates one value tensor per summary.
+//
+// Enqueueing never blocks. When the queue is full, summaries are merged into
+// the last pending job if it has the same writer and step; otherwise they are
+// dropped, and the number of dropped summaries is logged to stderr once the
+// queue accepts jobs again or is flushed.
+class SummaryWriteQueue {
+ public:
+  explicit SummaryWriteQueue(TFE_Context* tfe_context);
+  ~SummaryWriteQueue();
+
+  // Enqueues scalar summaries that share one step. Takes ownership of
+  // `writer_handle`, which must be a summary writer resource handle that is
+  // not used by any other thread. `writer_id` identifies the writer resource
+  // across handles.
+  void EnqueueScalars(int32_t writer_id, TFE_TensorHandle* writer_handle,
+                      int64_t step, std::vector<std::string> tags,
+                      std::vector<float> values);
+
+  // Enqueues a scalar summary whose value is a tensor. Takes ownership of
+  // `writer_handle` (see `EnqueueScalars()`) and of `value_handle`, a handle
+  // to a scalar tensor that is read on the worker thread.
+  void EnqueueScalarTensor(int32_t writer_id, TFE_TensorHandle* writer_handle,
+                           int64_t step, std::string tag,
+                           TFE_TensorHandle* value_handle);
+
+  // Blocks until every enqueued job has been executed.
+  void Flush();
+
+  // Returns and clears the message of the first failed write, if any.
+  std::string TakeError();
+
+ private:
+  struct Job {
+    int32_t writer_id;
+    TFE_TensorHandle* writer_handle;
+    int64_t step;
+    std::vector<std::string> tags;
+    std::vector<float> values;
+    // One entry per tag. If not null, the value of the summary is read from
+    // this handle instead of `values`. Owned by the job.
+    std::vector<TFE_TensorHandle*> value_handles;
+  };
+
+  // Adds `job` to the queue, or merges or drops it if the queue is full.
+  void Enqueue(Job job);
+  // Logs and resets `num_dropped_`. Must be called with `mutex_` held.
+  void LogDroppedSummaries();
+  // Deletes the handles owned by `job`.
+  static void DeleteJobHandles(const Job& job);
+  void Run();
+  void ExecuteJob(const Job& job, TF_Status* tf_status);
+  TFE_TensorHandle* GetTagHandle(const std::string& tag, TF_Status* tf_status);
+
+  TFE_Context* tfe_context_;
+
+  std::mutex mutex_;
+  // Signaled when a job is enqueued or the queue is stopped.
+  std::condition_variable work_available_;
+  // Signaled when a job is finished or removed from the queue.
+  std::condition_variable job_done_;
+  std::deque<Job> jobs_;
+  bool job_running_;
+  bool stopping_;
+  std::string error_;
+  // Number of summaries dropped since the queue was last not full.
+  size_t num_dropped_;
+
+  // Only accessed from the worker thread.
+  std::map<std::string, TFE_TensorHandle*> tag_handles_;
+
+  std::thread worker_;
+};
+
+}  // namespace tfnodejs
+
+#endif  // TF_NODEJS_SUMMARY_WRITE_QUEUE_H_
@@ -23,10 +23,13 @@
 #include "utils.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 
 namespace tfnodejs {
 
@@ -50,52 +53,96 @@ static void DeallocTensor(void *data, size_t len, void *arg) {
   delete auto_ref;
 }
 
-// Creates a TFE_TensorHandle from a JS typed array.
-TFE_TensorHandle *CreateTFE_TensorHandleFromTypedArray(napi_env env,
-                                                       int64_t *shape,
-                                                       uint32_t shape_length,
-                                                       TF_DataType dtype,
-                                                       napi_value array_value) {
-  napi_status nstatus;
-  napi_typedarray_type array_type;
-  size_t array_length;
-  void *array_data;
-  nstatus =
-      napi_get_typedarray_info(env, array_value, &array_type, &array_length,
-                               &array_data, nullptr, nullptr);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+// Alignment of buffers returned by AllocTensorBuffer(). This covers the
+// largest alignment Eigen requires (AVX-512), so TensorFlow can always use the
+// memory in place.
+static const size_t kTensorBufferAlignment = 64;
+
+static void *AllocateAlignedBuffer(size_t byte_length) {
+  // Zero-length allocations may return nullptr, always reserve some memory.
+  const size_t size = std::max(byte_length, kTensorBufferAlignment);
+#ifdef _WIN32
+  return _aligned_malloc(size, kTensorBufferAlignment);
+#else
+  void *data = nullptr;
+  if (posix_memalign(&data, kTensorBufferAlignment, size) != 0) {
+    return nullptr;
+  }
+  return data;
+#endif
+}
 
-  // Double check the underlying TF_Tensor type matches the supplied
-  // typed-array.
-  size_t width = 0;
+// Callback to free the aligned memory of an external ArrayBuffer:
+static void FreeAlignedBuffer(napi_env env, void *data, void *hint) {
+#ifdef _WIN32
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+// Returns the byte size of the elements of a typed array, after checking that
+// the typed array can hold the data of a tensor of type `dtype`. Returns 0 and
+// throws a JS error if it can't.
+static size_t GetTypedArrayElementWidth(napi_env env,
+                                        napi_typedarray_type array_type,
+                                        TF_DataType dtype) {
   switch (array_type) {
     case napi_float32_array:
       if (dtype != TF_FLOAT) {
         NAPI_THROW_ERROR(env, "Tensor type does not match Float32Array");
-        return nullptr;
+        return 0;
       }
-      width = sizeof(float);
-      break;
+      return sizeof(float);
     case napi_int32_array:
       if (dtype != TF_INT32 && dtype != TF_INT64) {
         // Currently, both int32- and int64-type Tensors are represented
         // as Int32Arrays in JavaScript. See int64_tensors.ts for details
         // about the latter.
         NAPI_THROW_ERROR(env, "Tensor type does not match Int32Array");
-        return nullptr;
+        return 0;
       }
-      width = sizeof(int32_t);
-      break;
+      return sizeof(int32_t);
     case napi_uint8_array:
-      if (dtype != TF_BOOL) {
+      if (dtype != TF_BOOL && dtype != TF_QUINT8) {
         NAPI_THROW_ERROR(env, "Tensor type does not match Uint8Array");
-        return nullptr;
+        return 0;
       }
-      width = sizeof(uint8_t);
-      break;
+      return sizeof(uint8_t);
+    case napi_int8_array:
+      if (dtype != TF_QINT8) {
+        NAPI_THROW_ERROR(env, "Tensor type does not match Int8Array");
+        return 0;
+      }
+      return sizeof(int8_t);
     default:
       REPORT_UNKNOWN_TYPED_ARRAY_TYPE(env, array_type);
-      return nullptr;
+      return 0;
+  }
+}
+
+// Creates a TFE_TensorHandle from a JS typed array. If TensorFlow had to copy
+// the typed-array memory instead of sharing it, `data_copied` is set to true.
+TFE_TensorHandle *CreateTFE_TensorHandleFromTypedArray(napi_env env,
+                                                       int64_t *shape,
+                                                       uint32_t shape_length,
+                                                       TF_DataType dtype,
+                                                       napi_value array_value,
+                                                       bool *data_copied) {
+  napi_status nstatus;
+  napi_typedarray_type array_type;
+  size_t array_length;
+  void *array_data;
+  nstatus =
+      napi_get_typedarray_info(env, array_value, &array_type, &array_length,
+                               &array_data, nullptr, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Double check the underlying TF_Tensor type matches the supplied
+  // typed-array.
+  const size_t width = GetTypedArrayElementWidth(env, array_type, dtype);
+  if (width == 0) {
+    return nullptr;
   }
 
   // Double check that width matches TF data type size:
@@ -170,6 +217,11 @@ TFE_TensorHandle *CreateTFE_TensorHandleFromTypedArray(napi_env env,
   TF_AutoTensor tensor(TF_NewTensor(dtype, shape, shape_length, array_data,
                                     byte_size, DeallocTensor, auto_ref));
 
+  // TF_NewTensor() copies memory that is not aligned for Eigen and releases
+  // the typed array right away. This is never the case for buffers from
+  // AllocTensorBuffer().
+  *data_copied = byte_size > 0 && TF_TensorData(tensor.tensor) != array_data;
+
   TF_AutoStatus tf_status;
   TFE_TensorHandle *tfe_tensor_handle =
       TFE_NewTensorHandle(tensor.tensor, tf_status.status);
@@ -257,13 +309,15 @@ TFE_TensorHandle *CreateTFE_TensorHandleFromJSValues(napi_env env,
                                                      int64_t *shape,
                                                      uint32_t shape_length,
                                                      TF_DataType dtype,
-                                                     napi_value array_value) {
+                                                     napi_value array_value,
+                                                     bool *data_copied) {
   bool is_typed_array;
   napi_status nstatus = napi_is_typedarray(env, array_value, &is_typed_array);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  *data_copied = false;
   if (is_typed_array) {
     return CreateTFE_TensorHandleFromTypedArray(env, shape, shape_length, dtype,
-                                                array_value);
+                                                array_value, data_copied);
   } else {
     return CreateTFE_TensorHandleFromStringArray(env, shape, shape_length,
                                                  dtype, array_value);
@@ -413,6 +467,8 @@ void CopyTFE_TensorHandleDataToResourceArray(
   void *tensor_data = TF_TensorData(tensor.tensor);
   ENSURE_VALUE_IS_NOT_NULL(env, tensor_data);
 
+  // The TensorFlow C API serializes scalar resource handles only. Resource
+  // tensors of any shape can still be used as op inputs by ID.
   size_t num_elements = GetTensorNumElements(tensor.tensor);
   if (num_elements != 1) {
     NAPI_THROW_ERROR(env,
@@ -420,6 +476,7 @@ void CopyTFE_TensorHandleDataToResourceArray(
                      "supports only exactly 1 element, but encountered "
                      "DT_RESOURCE tensor with %zu elements.",
                      num_elements);
+    return;
   }
 
   TF_AutoStatus status;
@@ -446,6 +503,62 @@ void CopyTFE_TensorHandleDataToResourceArray(
   ENSURE_NAPI_OK(env, nstatus);
 }
 
+// Copies the data of a numeric tensor into an existing JS typed array of the
+// matching type and byte length.
+void CopyTFE_TensorHandleDataIntoTypedArray(napi_env env,
+                                            TFE_TensorHandle *tfe_tensor_handle,
+                                            napi_value array_value) {
+  napi_status nstatus;
+  napi_typedarray_type array_type;
+  size_t array_length;
+  void *array_data;
+  nstatus =
+      napi_get_typedarray_info(env, array_value, &array_type, &array_length,
+                               &array_data, nullptr, nullptr);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  napi_typedarray_type expected_array_type;
+  size_t width;
+  TF_DataType tensor_data_type = TFE_TensorHandleDataType(tfe_tensor_handle);
+  switch (tensor_data_type) {
+    case TF_COMPLEX64:
+    case TF_FLOAT:
+      expected_array_type = napi_float32_array;
+      width = sizeof(float);
+      break;
+    case TF_INT32:
+      expected_array_type = napi_int32_array;
+      width = sizeof(int32_t);
+      break;
+    case TF_BOOL:
+      expected_array_type = napi_uint8_array;
+      width = sizeof(uint8_t);
+      break;
+    default:
+      REPORT_UNKNOWN_TF_DATA_TYPE(env, tensor_data_type);
+      return;
+  }
+  if (array_type != expected_array_type) {
+    NAPI_THROW_ERROR(env, "Typed array type does not match the tensor type");
+    return;
+  }
+
+  TF_AutoStatus tf_status;
+  TF_AutoTensor tensor(
+      TFE_TensorHandleResolve(tfe_tensor_handle, tf_status.status));
+  ENSURE_TF_OK(env, tf_status);
+
+  size_t byte_length = TF_TensorByteSize(tensor.tensor);
+  if (array_length * width != byte_length) {
+    NAPI_THROW_ERROR(env,
+                     "Typed array byte length (%zu) does not match the tensor "
+                     "byte size (%zu)",
+                     array_length * width, byte_length);
+    return;
+  }
+  memcpy(array_data, TF_TensorData(tensor.tensor), byte_length);
+}
+
 // Handles converting the stored TF_Tensor data into the correct JS value.
 void CopyTFE_TensorHandleDataToJSData(napi_env env, TFE_Context *tfe_context,
                                       TFE_TensorHandle *tfe_tensor_handle,
@@ -473,8 +586,15 @@ void CopyTFE_TensorHandleDataToJSData(napi_env env, TFE_Context *tfe_context,
       typed_array_type = napi_int32_array;
       break;
     case TF_BOOL:
+    case TF_QUINT8:
       typed_array_type = napi_uint8_array;
       break;
+    case TF_QINT8:
+      typed_array_type = napi_int8_array;
+      break;
+    case TF_QINT32:
+      typed_array_type = napi_int32_array;
+      break;
     case TF_STRING:
       is_string = true;
       break;
@@ -580,12 +700,32 @@ void AssignOpAttr(napi_env env, TFE_Op *tfe_op, napi_value attr_value) {
     case TF_ATTR_STRING: {
       // NOTE: String attribute values do not have to be utf8 encoded strings
       // (could be arbitrary byte sequences).
-      std::string str_value;
-      nstatus = GetStringParam(env, js_value, str_value);
-      ENSURE_NAPI_OK(env, nstatus);
+      if (IsArray(env, nstatus, &js_value)) {
+        uint32_t length;
+        nstatus = napi_get_array_length(env, js_value, &length);
+        ENSURE_NAPI_OK(env, nstatus);
+        std::vector<std::string> str_values(length);
+        std::unique_ptr<const void *[]> values(new const void *[length]);
+        std::unique_ptr<size_t[]> lengths(new size_t[length]);
+        for (uint32_t i = 0; i < length; ++i) {
+          napi_value element;
+          nstatus = napi_get_element(env, js_value, i, &element);
+          ENSURE_NAPI_OK(env, nstatus);
+          nstatus = GetStringParam(env, element, str_values[i]);
+          ENSURE_NAPI_OK(env, nstatus);
+          values[i] = str_values[i].data();
+          lengths[i] = str_values[i].size();
+        }
+        TFE_OpSetAttrStringList(tfe_op, attr_name, values.get(), lengths.get(),
+                                static_cast<int>(length));
+      } else {
+        std::string str_value;
+        nstatus = GetStringParam(env, js_value, str_value);
+        ENSURE_NAPI_OK(env, nstatus);
 
-      TFE_OpSetAttrString(tfe_op, attr_name, str_value.c_str(),
-                          str_value.size());
+        TFE_OpSetAttrString(tfe_op, attr_name, str_value.c_str(),
+                            str_value.size());
+      }
       break;
     }
 
@@ -669,22 +809,72 @@ void AssignOpAttr(napi_env env, TFE_Op *tfe_op, napi_value attr_value) {
     }
 
     case TF_ATTR_TYPE: {
-      TF_DataType tf_data_type;
-      nstatus = napi_get_value_int32(
-          env, js_value, reinterpret_cast<int32_t *>(&tf_data_type));
-      ENSURE_NAPI_OK(env, nstatus);
+      if (IsArray(env, nstatus, &js_value)) {
+        uint32_t length;
+        nstatus = napi_get_array_length(env, js_value, &length);
+        ENSURE_NAPI_OK(env, nstatus);
+        std::unique_ptr<TF_DataType[]> data(new TF_DataType[length]);
+        for (uint32_t i = 0; i < length; ++i) {
+          napi_value element;
+          nstatus = napi_get_element(env, js_value, i, &element);
+          ENSURE_NAPI_OK(env, nstatus);
+          int32_t value;
+          nstatus = napi_get_value_int32(env, element, &value);
+          ENSURE_NAPI_OK(env, nstatus);
+          data[i] = static_cast<TF_DataType>(value);
+        }
+        TFE_OpSetAttrTypeList(tfe_op, attr_name, data.get(),
+                              static_cast<int>(length));
+      } else {
+        TF_DataType tf_data_type;
+        nstatus = napi_get_value_int32(
+            env, js_value, reinterpret_cast<int32_t *>(&tf_data_type));
+        ENSURE_NAPI_OK(env, nstatus);
 
-      TFE_OpSetAttrType(tfe_op, attr_name, tf_data_type);
+        TFE_OpSetAttrType(tfe_op, attr_name, tf_data_type);
+      }
       break;
     }
 
     case TF_ATTR_SHAPE: {
-      std::vector<int64_t> shape_vector;
-      ExtractArrayShape(env, js_value, &shape_vector);
+      // A single shape is an array of numbers, a list of shapes is an array of
+      // arrays. An empty array is a single scalar shape.
+      uint32_t length;
+      nstatus = napi_get_array_length(env, js_value, &length);
+      ENSURE_NAPI_OK(env, nstatus);
+      bool is_shape_list = false;
+      if (length > 0) {
+        napi_value first_element;
+        nstatus = napi_get_element(env, js_value, 0, &first_element);
+        ENSURE_NAPI_OK(env, nstatus);
+        is_shape_list = IsArray(env, nstatus, &first_element);
+      }
 
       TF_AutoStatus tf_status;
-      TFE_OpSetAttrShape(tfe_op, attr_name, shape_vector.data(),
-                         shape_vector.size(), tf_status.status);
+      if (is_shape_list) {
+        std::vector<std::vector<int64_t>> shapes(length);
+        std::unique_ptr<const int64_t *[]> dims(new const int64_t *[length]);
+        std::unique_ptr<int[]> num_dims(new int[length]);
+        for (uint32_t i = 0; i < length; ++i) {
+          napi_value element;
+          nstatus = napi_get_element(env, js_value, i, &element);
+          ENSURE_NAPI_OK(env, nstatus);
+          ExtractArrayShape(env, element, &shapes[i]);
+          if (IsExceptionPending(env)) {
+            return;
+          }
+          dims[i] = shapes[i].data();
+          num_dims[i] = static_cast<int>(shapes[i].size());
+        }
+        TFE_OpSetAttrShapeList(tfe_op, attr_name, dims.get(), num_dims.get(),
+                               static_cast<int>(length), tf_status.status);
+      } else {
+        std::vector<int64_t> shape_vector;
+        ExtractArrayShape(env, js_value, &shape_vector);
+
+        TFE_OpSetAttrShape(tfe_op, attr_name, shape_vector.data(),
+                           shape_vector.size(), tf_status.status);
+      }
       ENSURE_TF_OK(env, tf_status);
       break;
     }
@@ -695,51 +885,85 @@ void AssignOpAttr(napi_env env, TFE_Op *tfe_op, napi_value attr_value) {
   }
 }
 
-TFJSBackend::TFJSBackend(napi_env env) : next_tensor_id_(0) {
+TFJSBackend::TFJSBackend(napi_env env)
+    : tfe_context_(nullptr),
+      next_tensor_id_(0),
+      num_tensor_bytes_(0),
+      num_shared_uploads_(0),
+      num_copied_uploads_(0),
+      num_device_copies_(0) {}
+
+bool TFJSBackend::EnsureContext(napi_env env) {
+  if (tfe_context_ != nullptr) {
+    return true;
+  }
+
   TF_AutoStatus tf_status;
   TFE_ContextOptions *tfe_options = TFE_NewContextOptions();
-  tfe_context_ = TFE_NewContext(tfe_options, tf_status.status);
+  TFE_Context *tfe_context = TFE_NewContext(tfe_options, tf_status.status);
+  TFE_DeleteContextOptions(tfe_options);
   if (TF_GetCode(tf_status.status) != TF_OK) {
     NAPI_THROW_ERROR(env, "Exception creating TFE_Context");
+    return false;
   }
 
-  TFE_DeleteContextOptions(tfe_options);
-
   TF_DeviceList *device_list =
-      TFE_ContextListDevices(tfe_context_, tf_status.status);
+      TFE_ContextListDevices(tfe_context, tf_status.status);
   if (TF_GetCode(tf_status.status) != TF_OK) {
+    TFE_DeleteContext(tfe_context);
     NAPI_THROW_ERROR(env, "Exception creating TFE_Context");
+    return false;
   }
 
   // TODO(kreeger): Add better support for this in the future through the JS
   // API. https://github.com/tensorflow/tfjs/issues/320
   std::string cpu_device_name;
+  std::string gpu_device_name;
   const int num_devices = TF_DeviceListCount(device_list);
   for (int i = 0; i < num_devices; i++) {
     const char *device_type =
         TF_DeviceListType(device_list, i, tf_status.status);
-    ENSURE_TF_OK(env, tf_status);
+    if (TF_GetCode(tf_status.status) != TF_OK) {
+      break;
+    }
 
     // Keep a reference to the host CPU device:
     if (strcmp(device_type, "CPU") == 0) {
       cpu_device_name =
           std::string(TF_DeviceListName(device_list, i, tf_status.status));
-      ENSURE_TF_OK(env, tf_status);
     } else if (strcmp(device_type, "GPU") == 0) {
-      device_name =
+      gpu_device_name =
           std::string(TF_DeviceListName(device_list, i, tf_status.status));
-      ENSURE_TF_OK(env, tf_status);
     }
+    if (TF_GetCode(tf_status.status) != TF_OK) {
+      break;
+    }
+  }
+  TF_DeleteDeviceList(device_list);
+  if (TF_GetCode(tf_status.status) != TF_OK) {
+    TFE_DeleteContext(tfe_context);
+    ENSURE_TF_OK_RETVAL(env, tf_status, false);
   }
 
   // If no GPU devices found, fallback to host CPU:
-  if (device_name.empty()) {
-    device_name = cpu_device_name;
-  }
-  TF_DeleteDeviceList(device_list);
+  device_name = gpu_device_name.empty() ? cpu_device_name : gpu_device_name;
+  tfe_context_ = tfe_context;
+  return true;
+}
+
+void TFJSBackend::InitContext(napi_env env) { EnsureContext(env); }
+
+napi_value TFJSBackend::IsContextInitialized(napi_env env) {
+  napi_value result;
+  napi_status nstatus =
+      napi_get_boolean(env, tfe_context_ != nullptr, &result);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return result;
 }
 
 TFJSBackend::~TFJSBackend() {
+  // Pending summary writes use the context, stop the queue first.
+  summary_write_queue_.reset();
   for (auto &kv : tfe_handle_map_) {
     TFE_DeleteTensorHandle(kv.second);
   }
@@ -750,14 +974,71 @@ TFJSBackend::~TFJSBackend() {
 
 TFJSBackend *TFJSBackend::Create(napi_env env) { return new TFJSBackend(env); }
 
-int32_t TFJSBackend::InsertHandle(TFE_TensorHandle *tfe_handle) {
-  return tfe_handle_map_.insert(std::make_pair(next_tensor_id_++, tfe_handle))
-      .first->first;
+// Returns the size of the tensor data held by a handle. String, resource and
+// variant tensors have no fixed element size and are counted as empty.
+static int64_t GetTensorHandleByteSize(TFE_TensorHandle *tfe_handle) {
+  const size_t width = TF_DataTypeSize(TFE_TensorHandleDataType(tfe_handle));
+  if (width == 0) {
+    return 0;
+  }
+  TF_AutoStatus tf_status;
+  const int64_t num_elements =
+      TFE_TensorHandleNumElements(tfe_handle, tf_status.status);
+  if (TF_GetCode(tf_status.status) != TF_OK) {
+    return 0;
+  }
+  return num_elements * static_cast<int64_t>(width);
+}
+
+int32_t TFJSBackend::InsertHandle(napi_env env, TFE_TensorHandle *tfe_handle,
+                                  bool owns_memory) {
+  const int32_t tensor_id = next_tensor_id_++;
+  // Report the native memory to V8, so that tensors that are not disposed add
+  // GC pressure.
+  if (owns_memory) {
+    const int64_t byte_size = GetTensorHandleByteSize(tfe_handle);
+    if (byte_size > 0) {
+      int64_t adjusted_value;
+      napi_adjust_external_memory(env, byte_size, &adjusted_value);
+      num_tensor_bytes_ += byte_size;
+      owned_tensor_bytes_[tensor_id] = byte_size;
+    }
+    op_metrics_.RecordAllocation(byte_size);
+  }
+  tfe_handle_map_[tensor_id] = tfe_handle;
+  return tensor_id;
+}
+
+TFE_TensorHandle *TFJSBackend::MoveToDevice(napi_env env,
+                                            TFE_TensorHandle *tfe_handle) {
+  TF_AutoStatus tf_status;
+  const char *handle_device_name =
+      TFE_TensorHandleDeviceName(tfe_handle, tf_status.status);
+  if (TF_GetCode(tf_status.status) != TF_OK) {
+    TFE_DeleteTensorHandle(tfe_handle);
+  }
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+
+  if (device_name == handle_device_name) {
+    return tfe_handle;
+  }
+  TFE_TensorHandle *new_handle = CopyTFE_TensorHandleToDevice(
+      env, device_name.c_str(), tfe_handle, tfe_context_);
+
+  TFE_DeleteTensorHandle(tfe_handle);
+  if (IsExceptionPending(env)) {
+    return nullptr;
+  }
+  num_device_copies_++;
+  return new_handle;
 }
 
 napi_value TFJSBackend::CreateTensor(napi_env env, napi_value shape_value,
                                      napi_value dtype_value,
                                      napi_value array_value) {
+  if (!EnsureContext(env)) {
+    return nullptr;
+  }
   napi_status nstatus;
 
   std::vector<int64_t> shape_vector;
@@ -771,152 +1052,658 @@ napi_value TFJSBackend::CreateTensor(napi_env env, napi_value shape_value,
   nstatus = napi_get_value_int32(env, dtype_value, &dtype_int32);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
+  bool data_copied;
   TFE_TensorHandle *tfe_handle = CreateTFE_TensorHandleFromJSValues(
       env, shape_vector.data(), shape_vector.size(),
-      static_cast<TF_DataType>(dtype_int32), array_value);
+      static_cast<TF_DataType>(dtype_int32), array_value, &data_copied);
 
   // Check to see if an exception exists, if so return a failure.
   if (IsExceptionPending(env)) {
     return nullptr;
   }
 
+  if (dtype_int32 != TF_STRING) {
+    if (data_copied) {
+      num_copied_uploads_++;
+    } else {
+      num_shared_uploads_++;
+    }
+  }
+  op_metrics_.RecordUpload(GetTensorHandleByteSize(tfe_handle));
+
+  // Uploads that share the memory of the typed array don't allocate, and V8
+  // already accounts for that memory.
+  bool owns_memory = data_copied || dtype_int32 == TF_STRING;
+
   // Copy non-int32 and non-string tensors to a device. Most GPU kernels expect
-  // to have int32 tensors in host memory.
+  // to have int32 tensors in host memory. New handles are placed on the host
+  // CPU, so the copy is skipped when that is the device in use.
   if (dtype_int32 != TF_INT32 && dtype_int32 != TF_STRING) {
-    // Note that this is a shallow copy and will share the underlying buffer
-    // if copying to the same device.
-    TFE_TensorHandle *new_handle = CopyTFE_TensorHandleToDevice(
-        env, device_name.c_str(), tfe_handle, tfe_context_);
-
-    TFE_DeleteTensorHandle(tfe_handle);
-    tfe_handle = new_handle;
+    TFE_TensorHandle *host_handle = tfe_handle;
+    tfe_handle = MoveToDevice(env, tfe_handle);
+    if (tfe_handle == nullptr) {
+      return nullptr;
+    }
+    owns_memory = owns_memory || tfe_handle != host_handle;
   }
 
   napi_value output_tensor_id;
-  nstatus = napi_create_int32(env, InsertHandle(tfe_handle), &output_tensor_id);
+  nstatus = napi_create_int32(env, InsertHandle(env, tfe_handle, owns_memory),
+                              &output_tensor_id);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
   return output_tensor_id;
 }
 
-void TFJSBackend::DeleteTensor(napi_env env, napi_value tensor_id_value) {
-  int32_t tensor_id;
-  ENSURE_NAPI_OK(env, napi_get_value_int32(env, tensor_id_value, &tensor_id));
+// Chunks are copied on several threads when the tensor has at least this many
+// bytes. Below that, waking the threads costs more than the copies.
+static const size_t kParallelCopyMinBytes = 1 << 20;
+static const unsigned int kMaxCopyThreads = 4;
 
-  auto tensor_entry = tfe_handle_map_.find(tensor_id);
-  if (tensor_entry == tfe_handle_map_.end()) {
-    NAPI_THROW_ERROR(env,
-                     "Delete called on a Tensor not referenced (tensor_id: %d)",
-                     tensor_id);
-    return;
+napi_value TFJSBackend::CreateTensorFromChunks(napi_env env,
+                                               napi_value shape_value,
+                                               napi_value dtype_value,
+                                               napi_value chunks_value) {
+  if (!EnsureContext(env)) {
+    return nullptr;
   }
+  napi_status nstatus;
 
-  TFE_DeleteTensorHandle(tensor_entry->second);
-  tfe_handle_map_.erase(tensor_entry);
-}
-
-napi_value TFJSBackend::GetTensorData(napi_env env,
-                                      napi_value tensor_id_value) {
-  int32_t tensor_id;
-  ENSURE_NAPI_OK_RETVAL(
-      env, napi_get_value_int32(env, tensor_id_value, &tensor_id), nullptr);
-
-  auto tensor_entry = tfe_handle_map_.find(tensor_id);
-  if (tensor_entry == tfe_handle_map_.end()) {
-    NAPI_THROW_ERROR(
-        env, "Get data called on a Tensor not referenced (tensor_id: %d)",
-        tensor_id);
+  std::vector<int64_t> shape_vector;
+  ExtractArrayShape(env, shape_value, &shape_vector);
+  // Check to see if an exception exists, if so return a failure.
+  if (IsExceptionPending(env)) {
     return nullptr;
   }
 
-  napi_value js_value;
-  CopyTFE_TensorHandleDataToJSData(env, tfe_context_, tensor_entry->second,
-                                   &js_value);
-  return js_value;
-}
-
-napi_value TFJSBackend::ExecuteOp(napi_env env, napi_value op_name_value,
-                                  napi_value op_attr_inputs,
-                                  napi_value input_tensor_ids,
-                                  napi_value num_output_values) {
-  napi_status nstatus;
-
-  std::string op_name;
-  nstatus = GetStringParam(env, op_name_value, op_name);
+  int32_t dtype_int32;
+  nstatus = napi_get_value_int32(env, dtype_value, &dtype_int32);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  const TF_DataType dtype = static_cast<TF_DataType>(dtype_int32);
+  if (TF_DataTypeSize(dtype) == 0) {
+    NAPI_THROW_ERROR(env, "Unsupported dtype for chunks: %d", dtype_int32);
+    return nullptr;
+  }
 
-  TF_AutoStatus tf_status;
-  TFE_AutoOp tfe_op(TFE_NewOp(tfe_context_, op_name.c_str(), tf_status.status));
-  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  size_t num_elements = 1;
+  for (const int64_t dim : shape_vector) {
+    num_elements *= dim;
+  }
+  const size_t byte_size = num_elements * TF_DataTypeSize(dtype);
 
-  uint32_t num_input_ids;
-  nstatus = napi_get_array_length(env, input_tensor_ids, &num_input_ids);
+  uint32_t num_chunks;
+  nstatus = napi_get_array_length(env, chunks_value, &num_chunks);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  for (uint32_t i = 0; i < num_input_ids; i++) {
-    napi_value cur_input_id;
-    nstatus = napi_get_element(env, input_tensor_ids, i, &cur_input_id);
+  // Check all chunks before allocating the tensor or copying any of them.
+  std::vector<ChunkCopy> chunks(num_chunks);
+  size_t chunks_byte_size = 0;
+  for (uint32_t i = 0; i < num_chunks; i++) {
+    napi_value chunk_value;
+    nstatus = napi_get_element(env, chunks_value, i, &chunk_value);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    ENSURE_VALUE_IS_TYPED_ARRAY_RETVAL(env, chunk_value, nullptr);
 
-    int32_t cur_input_tensor_id;
-    nstatus = napi_get_value_int32(env, cur_input_id, &cur_input_tensor_id);
+    napi_typedarray_type array_type;
+    size_t array_length;
+    void *array_data;
+    nstatus =
+        napi_get_typedarray_info(env, chunk_value, &array_type, &array_length,
+                                 &array_data, nullptr, nullptr);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    auto input_tensor_entry = tfe_handle_map_.find(cur_input_tensor_id);
-    if (input_tensor_entry == tfe_handle_map_.end()) {
-      NAPI_THROW_ERROR(env, "Input Tensor ID not referenced (tensor_id: %d)",
-                       cur_input_tensor_id);
+    const size_t width = GetTypedArrayElementWidth(env, array_type, dtype);
+    if (width == 0) {
       return nullptr;
     }
-
-    TFE_OpAddInput(tfe_op.op, input_tensor_entry->second, tf_status.status);
-    ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+    chunks[i].src = array_data;
+    chunks[i].byte_length = array_length * width;
+    chunks_byte_size += chunks[i].byte_length;
+  }
+  if (chunks_byte_size != byte_size) {
+    NAPI_THROW_ERROR(env,
+                     "Shape does not match the chunks in "
+                     "createTensorFromChunks() (byte_size=%zu, "
+                     "chunks_byte_size=%zu)",
+                     byte_size, chunks_byte_size);
+    return nullptr;
+  }
+
+  TF_AutoTensor tensor(
+      TF_AllocateTensor(dtype, shape_vector.data(), shape_vector.size(),
+                        byte_size));
+  char *dst = static_cast<char *>(TF_TensorData(tensor.tensor));
+  for (ChunkCopy &chunk : chunks) {
+    chunk.dst = dst;
+    dst += chunk.byte_length;
+  }
+
+  // JS is blocked during the copies, so the typed arrays can't change.
+  if (byte_size < kParallelCopyMinBytes || num_chunks < 2) {
+    for (const ChunkCopy &chunk : chunks) {
+      memcpy(chunk.dst, chunk.src, chunk.byte_length);
+    }
+  } else {
+    if (chunk_copy_pool_ == nullptr) {
+      // The calling thread copies too, so it doesn't count as a worker.
+      const unsigned int num_threads = std::min<unsigned int>(
+          kMaxCopyThreads, std::thread::hardware_concurrency());
+      chunk_copy_pool_.reset(
+          new ChunkCopyPool(num_threads > 1 ? num_threads - 1 : 0));
+    }
+    chunk_copy_pool_->Copy(chunks);
+  }
+
+  TF_AutoStatus tf_status;
+  TFE_TensorHandle *tfe_handle =
+      TFE_NewTensorHandle(tensor.tensor, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  op_metrics_.RecordUpload(GetTensorHandleByteSize(tfe_handle));
+
+  // See CreateTensor() for why int32 tensors stay on the host.
+  if (dtype != TF_INT32) {
+    tfe_handle = MoveToDevice(env, tfe_handle);
+    if (tfe_handle == nullptr) {
+      return nullptr;
+    }
+  }
+
+  napi_value output_tensor_id;
+  nstatus = napi_create_int32(env, InsertHandle(env, tfe_handle, true),
+                              &output_tensor_id);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return output_tensor_id;
+}
+
+napi_value TFJSBackend::AllocTensorBuffer(napi_env env,
+                                          napi_value byte_length_value) {
+  int64_t byte_length;
+  ENSURE_NAPI_OK_RETVAL(
+      env, napi_get_value_int64(env, byte_length_value, &byte_length),
+      nullptr);
+  if (byte_length < 0) {
+    NAPI_THROW_ERROR(env, "Invalid byte length for a tensor buffer: %lld",
+                     static_cast<long long>(byte_length));
+    return nullptr;
+  }
+
+  void *data = AllocateAlignedBuffer(static_cast<size_t>(byte_length));
+  if (data == nullptr) {
+    NAPI_THROW_ERROR(env, "Failed to allocate a tensor buffer of %lld bytes",
+                     static_cast<long long>(byte_length));
+    return nullptr;
+  }
+  // Typed arrays are zero-initialized in JS.
+  memset(data, 0, static_cast<size_t>(byte_length));
+
+  napi_value array_buffer;
+  napi_status nstatus = napi_create_external_arraybuffer(
+      env, data, static_cast<size_t>(byte_length), FreeAlignedBuffer, nullptr,
+      &array_buffer);
+  if (nstatus != napi_ok) {
+    FreeAlignedBuffer(env, data, nullptr);
+  }
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return array_buffer;
+}
+
+// Copies the selected channels of RGBA pixels to `dst`, optionally scaling
+// the values to [0, 1].
+template <typename T>
+static void CopyPixelChannels(const uint8_t *rgba, int64_t num_pixels,
+                              int32_t num_channels, bool normalize, T *dst) {
+  const T scale = normalize ? static_cast<T>(1) / static_cast<T>(255)
+                            : static_cast<T>(1);
+  for (int64_t i = 0; i < num_pixels; ++i) {
+    const uint8_t *pixel = rgba + i * 4;
+    for (int32_t channel = 0; channel < num_channels; ++channel) {
+      *dst++ = static_cast<T>(pixel[channel]) * scale;
+    }
+  }
+}
+
+napi_value TFJSBackend::CreateTensorFromPixels(
+    napi_env env, napi_value pixels_value, napi_value height_value,
+    napi_value width_value, napi_value num_channels_value,
+    napi_value dtype_value, napi_value normalize_value) {
+  if (!EnsureContext(env)) {
+    return nullptr;
+  }
+  napi_status nstatus;
+
+  napi_typedarray_type array_type;
+  size_t array_length;
+  void *array_data;
+  nstatus = napi_get_typedarray_info(env, pixels_value, &array_type,
+                                     &array_length, &array_data, nullptr,
+                                     nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  if (array_type != napi_uint8_array &&
+      array_type != napi_uint8_clamped_array) {
+    NAPI_THROW_ERROR(env, "Pixels must be an Uint8Array or Uint8ClampedArray");
+    return nullptr;
+  }
+
+  int64_t height, width;
+  int32_t num_channels, dtype_int32;
+  bool normalize;
+  nstatus = napi_get_value_int64(env, height_value, &height);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_get_value_int64(env, width_value, &width);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_get_value_int32(env, num_channels_value, &num_channels);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_get_value_int32(env, dtype_value, &dtype_int32);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_get_value_bool(env, normalize_value, &normalize);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  const TF_DataType dtype = static_cast<TF_DataType>(dtype_int32);
+  if (dtype != TF_INT32 && dtype != TF_FLOAT) {
+    NAPI_THROW_ERROR(env, "Unsupported dtype for pixels: %d", dtype_int32);
+    return nullptr;
+  }
+  if (num_channels < 1 || num_channels > 4) {
+    NAPI_THROW_ERROR(env, "Invalid number of channels: %d", num_channels);
+    return nullptr;
+  }
+  if (height < 0 || width < 0 ||
+      static_cast<size_t>(height * width * 4) != array_length) {
+    NAPI_THROW_ERROR(env,
+                     "Expected %lld RGBA values for a %lldx%lld image, but "
+                     "got %zu",
+                     static_cast<long long>(height * width * 4),
+                     static_cast<long long>(height),
+                     static_cast<long long>(width), array_length);
+    return nullptr;
+  }
+
+  const int64_t shape[3] = {height, width, num_channels};
+  const int64_t num_pixels = height * width;
+  TF_AutoTensor tensor(TF_AllocateTensor(
+      dtype, shape, 3, num_pixels * num_channels * TF_DataTypeSize(dtype)));
+  const uint8_t *rgba = static_cast<const uint8_t *>(array_data);
+  if (dtype == TF_FLOAT) {
+    CopyPixelChannels(rgba, num_pixels, num_channels, normalize,
+                      static_cast<float *>(TF_TensorData(tensor.tensor)));
+  } else {
+    CopyPixelChannels(rgba, num_pixels, num_channels, false,
+                      static_cast<int32_t *>(TF_TensorData(tensor.tensor)));
+  }
+
+  TF_AutoStatus tf_status;
+  TFE_TensorHandle *tfe_handle =
+      TFE_NewTensorHandle(tensor.tensor, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  op_metrics_.RecordUpload(GetTensorHandleByteSize(tfe_handle));
+
+  if (dtype == TF_FLOAT) {
+    tfe_handle = MoveToDevice(env, tfe_handle);
+    if (tfe_handle == nullptr) {
+      return nullptr;
+    }
+  }
+
+  napi_value output_tensor_id;
+  nstatus = napi_create_int32(env, InsertHandle(env, tfe_handle, true),
+                              &output_tensor_id);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return output_tensor_id;
+}
+
+// Releases the tensor whose memory is shared by a view, see
+// CreateTensorView().
+static void DeleteViewedTensor(void *data, size_t len, void *arg) {
+  TF_DeleteTensor(static_cast<TF_Tensor *>(arg));
+}
+
+napi_value TFJSBackend::CreateTensorView(napi_env env,
+                                         napi_value tensor_id_value,
+                                         napi_value element_offset_value,
+                                         napi_value shape_value) {
+  napi_status nstatus;
+
+  int32_t tensor_id;
+  nstatus = napi_get_value_int32(env, tensor_id_value, &tensor_id);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  auto tensor_entry = tfe_handle_map_.find(tensor_id);
+  if (tensor_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(
+        env, "Create view called on a Tensor not referenced (tensor_id: %d)",
+        tensor_id);
+    return nullptr;
+  }
+  TFE_TensorHandle *tfe_handle = tensor_entry->second;
+
+  int64_t element_offset;
+  nstatus = napi_get_value_int64(env, element_offset_value, &element_offset);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  std::vector<int64_t> shape_vector;
+  ExtractArrayShape(env, shape_value, &shape_vector);
+  // Check to see if an exception exists, if so return a failure.
+  if (IsExceptionPending(env)) {
+    return nullptr;
+  }
+
+  napi_value output_tensor_id;
+  const TF_DataType dtype = TFE_TensorHandleDataType(tfe_handle);
+  const size_t width = TF_DataTypeSize(dtype);
+  TF_AutoStatus tf_status;
+  const char *handle_device_name =
+      TFE_TensorHandleDeviceName(tfe_handle, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  // Resolving a handle on another device copies its data to the host, so only
+  // host tensors are shared.
+  if (width == 0 || strstr(handle_device_name, "device:CPU:") == nullptr) {
+    nstatus = napi_create_int32(env, -1, &output_tensor_id);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    return output_tensor_id;
+  }
+
+  int64_t num_elements = 1;
+  for (const int64_t dim : shape_vector) {
+    num_elements *= dim;
+  }
+  const int64_t num_parent_elements =
+      TFE_TensorHandleNumElements(tfe_handle, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  if (element_offset < 0 ||
+      element_offset + num_elements > num_parent_elements) {
+    NAPI_THROW_ERROR(env,
+                     "View of %lld elements at offset %lld is out of the "
+                     "bounds of a tensor of %lld elements",
+                     static_cast<long long>(num_elements),
+                     static_cast<long long>(element_offset),
+                     static_cast<long long>(num_parent_elements));
+    return nullptr;
+  }
+
+  // The resolved tensor shares the buffer of the handle and keeps it alive
+  // until the view is deleted, even if the handle is deleted first.
+  TF_Tensor *parent_tensor =
+      TFE_TensorHandleResolve(tfe_handle, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+
+  // NOTE: TF_NewTensor() copies the data (and releases the parent right away)
+  // if the offset breaks the alignment TensorFlow requires.
+  char *data = static_cast<char *>(TF_TensorData(parent_tensor)) +
+               element_offset * width;
+  TF_AutoTensor view_tensor(TF_NewTensor(
+      dtype, shape_vector.data(), shape_vector.size(), data,
+      num_elements * width, DeleteViewedTensor, parent_tensor));
+
+  TFE_TensorHandle *view_handle =
+      TFE_NewTensorHandle(view_tensor.tensor, tf_status.status);
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+
+  // The memory belongs to the viewed tensor.
+  nstatus = napi_create_int32(env, InsertHandle(env, view_handle, false),
+                              &output_tensor_id);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return output_tensor_id;
+}
+
+napi_value TFJSBackend::GetTensorUploadStats(napi_env env) {
+  napi_status nstatus;
+
+  napi_value stats;
+  nstatus = napi_create_object(env, &stats);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  const std::pair<const char *, int64_t> counters[] = {
+      {"numShared", num_shared_uploads_},
+      {"numCopied", num_copied_uploads_},
+      {"numDeviceCopies", num_device_copies_}};
+  for (const auto &counter : counters) {
+    napi_value value;
+    nstatus =
+        napi_create_double(env, static_cast<double>(counter.second), &value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, stats, counter.first, value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+  return stats;
+}
+
+void TFJSBackend::DeleteTensor(napi_env env, napi_value tensor_id_value) {
+  int32_t tensor_id;
+  ENSURE_NAPI_OK(env, napi_get_value_int32(env, tensor_id_value, &tensor_id));
+
+  auto tensor_entry = tfe_handle_map_.find(tensor_id);
+  if (tensor_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(env,
+                     "Delete called on a Tensor not referenced (tensor_id: %d)",
+                     tensor_id);
+    return;
+  }
+
+  auto bytes_entry = owned_tensor_bytes_.find(tensor_id);
+  if (bytes_entry != owned_tensor_bytes_.end()) {
+    int64_t adjusted_value;
+    napi_adjust_external_memory(env, -bytes_entry->second, &adjusted_value);
+    num_tensor_bytes_ -= bytes_entry->second;
+    owned_tensor_bytes_.erase(bytes_entry);
+  }
+
+  TFE_DeleteTensorHandle(tensor_entry->second);
+  tfe_handle_map_.erase(tensor_entry);
+}
+
+napi_value TFJSBackend::GetMemoryInfo(napi_env env) {
+  napi_status nstatus;
+
+  napi_value memory_info;
+  nstatus = napi_create_object(env, &memory_info);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value num_tensors_value;
+  nstatus = napi_create_double(
+      env, static_cast<double>(tfe_handle_map_.size()), &num_tensors_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus = napi_set_named_property(env, memory_info, "numTensors",
+                                    num_tensors_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value num_bytes_value;
+  nstatus = napi_create_double(env, static_cast<double>(num_tensor_bytes_),
+                               &num_bytes_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  nstatus =
+      napi_set_named_property(env, memory_info, "numBytes", num_bytes_value);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  return memory_info;
+}
+
+napi_value TFJSBackend::GetMetrics(napi_env env) {
+  napi_status nstatus;
+
+  napi_value metrics;
+  nstatus = napi_create_object(env, &metrics);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  const std::vector<OpMetrics::OpSnapshot> op_snapshots =
+      op_metrics_.SnapshotOps();
+  napi_value ops;
+  nstatus = napi_create_array_with_length(env, op_snapshots.size(), &ops);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  for (uint32_t i = 0; i < op_snapshots.size(); i++) {
+    const OpMetrics::OpSnapshot &snapshot = op_snapshots[i];
+    napi_value op;
+    nstatus = napi_create_object(env, &op);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    napi_value name;
+    nstatus = napi_create_string_utf8(env, snapshot.op_name.c_str(),
+                                      snapshot.op_name.size(), &name);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, op, "name", name);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    napi_value count;
+    nstatus = napi_create_double(env, static_cast<double>(snapshot.count),
+                                 &count);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, op, "count", count);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    napi_value total_nanos;
+    nstatus = napi_create_double(
+        env, static_cast<double>(snapshot.total_nanos), &total_nanos);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, op, "totalNanos", total_nanos);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    napi_value buckets;
+    nstatus = napi_create_array_with_length(
+        env, snapshot.latency_buckets.size(), &buckets);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    for (uint32_t j = 0; j < snapshot.latency_buckets.size(); j++) {
+      napi_value bucket;
+      nstatus = napi_create_double(
+          env, static_cast<double>(snapshot.latency_buckets[j]), &bucket);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+      nstatus = napi_set_element(env, buckets, j, bucket);
+      ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    }
+    nstatus = napi_set_named_property(env, op, "latencyBuckets", buckets);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+    nstatus = napi_set_element(env, ops, i, op);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+  nstatus = napi_set_named_property(env, metrics, "ops", ops);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  for (const auto &counter : op_metrics_.SnapshotCounters()) {
+    napi_value value;
+    nstatus =
+        napi_create_double(env, static_cast<double>(counter.second), &value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    nstatus = napi_set_named_property(env, metrics, counter.first, value);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  }
+  return metrics;
+}
+
+napi_value TFJSBackend::GetTensorData(napi_env env,
+                                      napi_value tensor_id_value) {
+  int32_t tensor_id;
+  ENSURE_NAPI_OK_RETVAL(
+      env, napi_get_value_int32(env, tensor_id_value, &tensor_id), nullptr);
+
+  auto tensor_entry = tfe_handle_map_.find(tensor_id);
+  if (tensor_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(
+        env, "Get data called on a Tensor not referenced (tensor_id: %d)",
+        tensor_id);
+    return nullptr;
+  }
+
+  op_metrics_.RecordReadback(GetTensorHandleByteSize(tensor_entry->second));
+  napi_value js_value;
+  CopyTFE_TensorHandleDataToJSData(env, tfe_context_, tensor_entry->second,
+                                   &js_value);
+  return js_value;
+}
+
+void TFJSBackend::GetTensorDataInto(napi_env env, napi_value tensor_id_value,
+                                    napi_value array_value) {
+  int32_t tensor_id;
+  ENSURE_NAPI_OK(env, napi_get_value_int32(env, tensor_id_value, &tensor_id));
+
+  auto tensor_entry = tfe_handle_map_.find(tensor_id);
+  if (tensor_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(
+        env, "Get data called on a Tensor not referenced (tensor_id: %d)",
+        tensor_id);
+    return;
+  }
+
+  op_metrics_.RecordReadback(GetTensorHandleByteSize(tensor_entry->second));
+  CopyTFE_TensorHandleDataIntoTypedArray(env, tensor_entry->second,
+                                         array_value);
+}
+
+bool TFJSBackend::SetupOp(napi_env env, TFE_Op *tfe_op,
+                          napi_value op_attr_inputs,
+                          napi_value input_tensor_ids) {
+  napi_status nstatus;
+  TF_AutoStatus tf_status;
+
+  uint32_t num_input_ids;
+  nstatus = napi_get_array_length(env, input_tensor_ids, &num_input_ids);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
+
+  for (uint32_t i = 0; i < num_input_ids; i++) {
+    napi_value cur_input_id;
+    nstatus = napi_get_element(env, input_tensor_ids, i, &cur_input_id);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
+
+    int32_t cur_input_tensor_id;
+    nstatus = napi_get_value_int32(env, cur_input_id, &cur_input_tensor_id);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
+
+    auto input_tensor_entry = tfe_handle_map_.find(cur_input_tensor_id);
+    if (input_tensor_entry == tfe_handle_map_.end()) {
+      NAPI_THROW_ERROR(env, "Input Tensor ID not referenced (tensor_id: %d)",
+                       cur_input_tensor_id);
+      return false;
+    }
+
+    TFE_OpAddInput(tfe_op, input_tensor_entry->second, tf_status.status);
+    ENSURE_TF_OK_RETVAL(env, tf_status, false);
   }
 
   uint32_t op_attrs_length;
   nstatus = napi_get_array_length(env, op_attr_inputs, &op_attrs_length);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
 
   for (uint32_t i = 0; i < op_attrs_length; i++) {
     napi_value cur_op_attr;
     nstatus = napi_get_element(env, op_attr_inputs, i, &cur_op_attr);
-    ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+    ENSURE_NAPI_OK_RETVAL(env, nstatus, false);
 
-    AssignOpAttr(env, tfe_op.op, cur_op_attr);
+    AssignOpAttr(env, tfe_op, cur_op_attr);
 
     // Check to see if an exception exists, if so return a failure.
     if (IsExceptionPending(env)) {
-      return nullptr;
+      return false;
     }
   }
+  return true;
+}
 
-  int32_t num_outputs;
-  nstatus = napi_get_value_int32(env, num_output_values, &num_outputs);
-  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
-
-  // Push `nullptr` to get a valid pointer in the call to `TFE_Execute()`
-  // below.
-  std::vector<TFE_TensorHandle *> result_handles(num_outputs, nullptr);
+// Returns whether the outputs of an op share the buffers of its inputs (or of
+// a variable) instead of allocating memory.
+static bool OutputsAliasInputs(const std::string &op_name) {
+  return op_name == "ReadVariableOp" || op_name == "Identity" ||
+         op_name == "Reshape" || op_name == "Squeeze" ||
+         op_name == "ExpandDims" || op_name == "StopGradient";
+}
 
-  int size = result_handles.size();
-  TFE_Execute(tfe_op.op, result_handles.data(), &size, tf_status.status);
-  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+napi_value TFJSBackend::CreateOutputTensorInfos(
+    napi_env env, const std::vector<TFE_TensorHandle *> &handles,
+    bool owns_memory) {
+  napi_status nstatus;
 
   napi_value output_tensor_infos;
-  nstatus = napi_create_array_with_length(env, size, &output_tensor_infos);
+  nstatus =
+      napi_create_array_with_length(env, handles.size(), &output_tensor_infos);
   ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-  for (int32_t i = 0; i < num_outputs; i++) {
+  for (size_t i = 0; i < handles.size(); i++) {
     // Output tensor info object:
     napi_value tensor_info_value;
     nstatus = napi_create_object(env, &tensor_info_value);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
-    TFE_TensorHandle *handle = result_handles[i];
+    TFE_TensorHandle *handle = handles[i];
 
     // Output tensor ID:
     napi_value output_tensor_id_value;
-    nstatus =
-        napi_create_int32(env, InsertHandle(handle), &output_tensor_id_value);
+    nstatus = napi_create_int32(env, InsertHandle(env, handle, owns_memory),
+                                &output_tensor_id_value);
     ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
 
     nstatus = napi_set_named_property(env, tensor_info_value, "id",
@@ -947,4 +1734,341 @@ napi_value TFJSBackend::ExecuteOp(napi_env env, napi_value op_name_value,
   return output_tensor_infos;
 }
 
+napi_value TFJSBackend::ExecuteOp(napi_env env, napi_value op_name_value,
+                                  napi_value op_attr_inputs,
+                                  napi_value input_tensor_ids,
+                                  napi_value num_output_values) {
+  if (!EnsureContext(env)) {
+    return nullptr;
+  }
+  napi_status nstatus;
+
+  std::string op_name;
+  nstatus = GetStringParam(env, op_name_value, op_name);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  TF_AutoStatus tf_status;
+  TFE_AutoOp tfe_op(TFE_NewOp(tfe_context_, op_name.c_str(), tf_status.status));
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+
+  if (!SetupOp(env, tfe_op.op, op_attr_inputs, input_tensor_ids)) {
+    return nullptr;
+  }
+
+  int32_t num_outputs;
+  nstatus = napi_get_value_int32(env, num_output_values, &num_outputs);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Push `nullptr` to get a valid pointer in the call to `TFE_Execute()`
+  // below.
+  std::vector<TFE_TensorHandle *> result_handles(num_outputs, nullptr);
+
+  int size = result_handles.size();
+  const auto start_time = std::chrono::steady_clock::now();
+  TFE_Execute(tfe_op.op, result_handles.data(), &size, tf_status.status);
+  op_metrics_.RecordOp(op_name,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start_time)
+                           .count());
+  ENSURE_TF_OK_RETVAL(env, tf_status, nullptr);
+  result_handles.resize(size);
+
+  return CreateOutputTensorInfos(env, result_handles,
+                                 !OutputsAliasInputs(op_name));
+}
+
+// An op execution that runs on the libuv thread pool, see ExecuteOpAsync().
+struct TFJSBackend::AsyncOpExecution {
+  TFJSBackend *backend;
+  std::string op_name;
+  TFE_Op *tfe_op;
+  std::vector<TFE_TensorHandle *> result_handles;
+  TF_Status *tf_status;
+  napi_deferred deferred;
+  napi_async_work work;
+
+  ~AsyncOpExecution() {
+    if (tfe_op != nullptr) {
+      TFE_DeleteOp(tfe_op);
+    }
+    TF_DeleteStatus(tf_status);
+  }
+};
+
+napi_value TFJSBackend::ExecuteOpAsync(napi_env env, napi_value op_name_value,
+                                       napi_value op_attr_inputs,
+                                       napi_value input_tensor_ids,
+                                       napi_value num_output_values) {
+  if (!EnsureContext(env)) {
+    return nullptr;
+  }
+  napi_status nstatus;
+
+  std::unique_ptr<AsyncOpExecution> execution(new AsyncOpExecution());
+  execution->backend = this;
+  execution->tfe_op = nullptr;
+  execution->tf_status = TF_NewStatus();
+  execution->work = nullptr;
+
+  nstatus = GetStringParam(env, op_name_value, execution->op_name);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  execution->tfe_op = TFE_NewOp(tfe_context_, execution->op_name.c_str(),
+                                execution->tf_status);
+  if (TF_GetCode(execution->tf_status) != TF_OK) {
+    NAPI_THROW_ERROR(env, "Invalid TF_Status: %u\nMessage: %s",
+                     TF_GetCode(execution->tf_status),
+                     TF_Message(execution->tf_status));
+    return nullptr;
+  }
+
+  // The op holds references to its inputs, so the input tensors may be
+  // deleted before the execution completes.
+  if (!SetupOp(env, execution->tfe_op, op_attr_inputs, input_tensor_ids)) {
+    return nullptr;
+  }
+
+  int32_t num_outputs;
+  nstatus = napi_get_value_int32(env, num_output_values, &num_outputs);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+  execution->result_handles.resize(num_outputs, nullptr);
+
+  napi_value resource_name;
+  nstatus = napi_create_string_utf8(env, execution->op_name.c_str(),
+                                    NAPI_AUTO_LENGTH, &resource_name);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  napi_value promise;
+  nstatus = napi_create_promise(env, &execution->deferred, &promise);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = napi_create_async_work(env, nullptr, resource_name,
+                                   ExecuteAsyncOp, CompleteAsyncOp,
+                                   execution.get(), &execution->work);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  nstatus = napi_queue_async_work(env, execution->work);
+  if (nstatus != napi_ok) {
+    napi_delete_async_work(env, execution->work);
+  }
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  // Owned by CompleteAsyncOp() from now on.
+  execution.release();
+  return promise;
+}
+
+void TFJSBackend::ExecuteAsyncOp(napi_env env, void *data) {
+  // Runs on a thread pool thread: must not call into N-API.
+  AsyncOpExecution *execution = static_cast<AsyncOpExecution *>(data);
+  int size = execution->result_handles.size();
+  const auto start_time = std::chrono::steady_clock::now();
+  TFE_Execute(execution->tfe_op, execution->result_handles.data(), &size,
+              execution->tf_status);
+  execution->backend->op_metrics_.RecordOp(
+      execution->op_name,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_time)
+          .count());
+  if (TF_GetCode(execution->tf_status) == TF_OK) {
+    execution->result_handles.resize(size);
+  } else {
+    execution->result_handles.clear();
+  }
+}
+
+void TFJSBackend::CompleteAsyncOp(napi_env env, napi_status status,
+                                  void *data) {
+  std::unique_ptr<AsyncOpExecution> execution(
+      static_cast<AsyncOpExecution *>(data));
+  napi_delete_async_work(env, execution->work);
+
+  napi_value result = nullptr;
+  if (status == napi_ok && TF_GetCode(execution->tf_status) == TF_OK) {
+    result = execution->backend->CreateOutputTensorInfos(
+        env, execution->result_handles,
+        !OutputsAliasInputs(execution->op_name));
+  } else {
+    for (TFE_TensorHandle *handle : execution->result_handles) {
+      TFE_DeleteTensorHandle(handle);
+    }
+  }
+
+  if (result != nullptr) {
+    napi_resolve_deferred(env, execution->deferred, result);
+    return;
+  }
+
+  napi_value error;
+  if (IsExceptionPending(env)) {
+    napi_get_and_clear_last_exception(env, &error);
+  } else {
+    const std::string message =
+        status != napi_ok ? "Async op execution was cancelled"
+                          : std::string("Invalid TF_Status: ") +
+                                std::to_string(TF_GetCode(
+                                    execution->tf_status)) +
+                                "\nMessage: " +
+                                TF_Message(execution->tf_status);
+    napi_value message_value;
+    napi_create_string_utf8(env, message.c_str(), NAPI_AUTO_LENGTH,
+                            &message_value);
+    napi_create_error(env, nullptr, message_value, &error);
+  }
+  napi_reject_deferred(env, execution->deferred, error);
+}
+
+void TFJSBackend::WriteScalarSummaries(napi_env env,
+                                       napi_value writer_id_value,
+                                       napi_value step_value,
+                                       napi_value tags_value,
+                                       napi_value values_value) {
+  napi_status nstatus;
+
+  int32_t writer_id;
+  nstatus = napi_get_value_int32(env, writer_id_value, &writer_id);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  auto writer_entry = tfe_handle_map_.find(writer_id);
+  if (writer_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(env,
+                     "Summary writer Tensor not referenced (tensor_id: %d)",
+                     writer_id);
+    return;
+  }
+
+  int64_t step;
+  nstatus = napi_get_value_int64(env, step_value, &step);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  uint32_t num_tags;
+  nstatus = napi_get_array_length(env, tags_value, &num_tags);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  std::vector<std::string> tags(num_tags);
+  for (uint32_t i = 0; i < num_tags; i++) {
+    napi_value tag_value;
+    nstatus = napi_get_element(env, tags_value, i, &tag_value);
+    ENSURE_NAPI_OK(env, nstatus);
+
+    nstatus = GetStringParam(env, tag_value, tags[i]);
+    ENSURE_NAPI_OK(env, nstatus);
+  }
+
+  napi_typedarray_type array_type;
+  size_t num_values;
+  void *values_data;
+  nstatus = napi_get_typedarray_info(env, values_value, &array_type,
+                                     &num_values, &values_data, nullptr,
+                                     nullptr);
+  ENSURE_NAPI_OK(env, nstatus);
+  if (array_type != napi_float32_array || num_values != num_tags) {
+    NAPI_THROW_ERROR(env,
+                     "Expected a Float32Array with one value per summary tag");
+    return;
+  }
+  const float *values_begin = static_cast<const float *>(values_data);
+  std::vector<float> values(values_begin, values_begin + num_values);
+
+  if (!EnsureSummaryWriteQueue(env)) {
+    return;
+  }
+
+  // The worker thread gets its own handle to the writer resource, since
+  // handles in `tfe_handle_map_` may be deleted while the write is pending.
+  TF_AutoStatus tf_status;
+  TFE_TensorHandle *writer_handle =
+      TFE_TensorHandleCopySharingTensor(writer_entry->second, tf_status.status);
+  ENSURE_TF_OK(env, tf_status);
+
+  summary_write_queue_->EnqueueScalars(writer_id, writer_handle, step,
+                                       std::move(tags), std::move(values));
+}
+
+void TFJSBackend::WriteScalarSummaryTensor(napi_env env,
+                                           napi_value writer_id_value,
+                                           napi_value step_value,
+                                           napi_value tag_value,
+                                           napi_value value_id_value) {
+  napi_status nstatus;
+
+  int32_t writer_id;
+  nstatus = napi_get_value_int32(env, writer_id_value, &writer_id);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  auto writer_entry = tfe_handle_map_.find(writer_id);
+  if (writer_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(env,
+                     "Summary writer Tensor not referenced (tensor_id: %d)",
+                     writer_id);
+    return;
+  }
+
+  int64_t step;
+  nstatus = napi_get_value_int64(env, step_value, &step);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  std::string tag;
+  nstatus = GetStringParam(env, tag_value, tag);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  int32_t value_id;
+  nstatus = napi_get_value_int32(env, value_id_value, &value_id);
+  ENSURE_NAPI_OK(env, nstatus);
+
+  auto value_entry = tfe_handle_map_.find(value_id);
+  if (value_entry == tfe_handle_map_.end()) {
+    NAPI_THROW_ERROR(env, "Tensor not referenced (tensor_id: %d)", value_id);
+    return;
+  }
+
+  if (!EnsureSummaryWriteQueue(env)) {
+    return;
+  }
+
+  // Like the writer, the value gets its own handle. It shares the tensor, so
+  // the value is only read on the worker thread.
+  TF_AutoStatus tf_status;
+  TFE_TensorHandle *writer_handle =
+      TFE_TensorHandleCopySharingTensor(writer_entry->second, tf_status.status);
+  ENSURE_TF_OK(env, tf_status);
+  TFE_TensorHandle *value_handle =
+      TFE_TensorHandleCopySharingTensor(value_entry->second, tf_status.status);
+  if (TF_GetCode(tf_status.status) != TF_OK) {
+    TFE_DeleteTensorHandle(writer_handle);
+  }
+  ENSURE_TF_OK(env, tf_status);
+
+  summary_write_queue_->EnqueueScalarTensor(writer_id, writer_handle, step,
+                                            std::move(tag), value_handle);
+}
+
+bool TFJSBackend::EnsureSummaryWriteQueue(napi_env env) {
+  if (summary_write_queue_ == nullptr) {
+    if (!EnsureContext(env)) {
+      return false;
+    }
+    summary_write_queue_.reset(new SummaryWriteQueue(tfe_context_));
+    return true;
+  }
+  // Surface errors of previous writes as early as possible.
+  std::string error = summary_write_queue_->TakeError();
+  if (!error.empty()) {
+    NAPI_THROW_ERROR(env, "Failed to write summary: %s", error.c_str());
+    return false;
+  }
+  return true;
+}
+
+void TFJSBackend::FlushSummaryWrites(napi_env env) {
+  if (summary_write_queue_ == nullptr) {
+    return;
+  }
+  summary_write_queue_->Flush();
+  std::string error = summary_write_queue_->TakeError();
+  if (!error.empty()) {
+    NAPI_THROW_ERROR(env, "Failed to write summary: %s", error.c_str());
+  }
+}
+
 }  // namespace tfnodejs
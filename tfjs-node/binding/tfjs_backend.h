@@ -22,6 +22,10 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
+#include "chunk_copy_pool.h"
+#include "op_metrics.h"
+#include "summary_write_queue.h"
 #include "tensorflow/c/eager/c_api.h"
 
 namespace tfnodejs {
@@ -40,15 +44,87 @@ class TFJSBackend {
   napi_value CreateTensor(napi_env env, napi_value shape_value,
                           napi_value dtype_value, napi_value array_value);
 
+  // Creates a tensor with given shape from the concatenation of typed arrays
+  // and returns its ID. The tensor is allocated once and every chunk is copied
+  // into place, on a pool of threads for large tensors.
+  // - shape_value (number[])
+  // - dtype_value (number)
+  // - chunks_value (TypedArray[])
+  napi_value CreateTensorFromChunks(napi_env env, napi_value shape_value,
+                                    napi_value dtype_value,
+                                    napi_value chunks_value);
+
+  // Allocates a zero-initialized ArrayBuffer over native memory that is
+  // aligned so that TensorFlow can use it without copying. Typed arrays over
+  // this buffer are always uploaded zero-copy by CreateTensor().
+  // - byte_length_value (number)
+  napi_value AllocTensorBuffer(napi_env env, napi_value byte_length_value);
+
+  // Creates an int32 or float32 tensor with shape [height, width,
+  // num_channels] from RGBA pixels, keeping the first num_channels channels
+  // of every pixel, and returns its ID. Float values are divided by 255 if
+  // normalize_value is true.
+  // - pixels_value (Uint8Array|Uint8ClampedArray)
+  // - height_value, width_value, num_channels_value (number)
+  // - dtype_value (number, TF_INT32 or TF_FLOAT)
+  // - normalize_value (boolean)
+  napi_value CreateTensorFromPixels(napi_env env, napi_value pixels_value,
+                                    napi_value height_value,
+                                    napi_value width_value,
+                                    napi_value num_channels_value,
+                                    napi_value dtype_value,
+                                    napi_value normalize_value);
+
+  // Creates a tensor with the given shape that shares the memory of an
+  // existing tensor, starting at element_offset_value, and returns its ID.
+  // Returns -1 if the memory can't be shared because the tensor is not placed
+  // on the host CPU or has no fixed element size (e.g., strings).
+  // - tensor_id_value (number)
+  // - element_offset_value (number)
+  // - shape_value (number[])
+  napi_value CreateTensorView(napi_env env, napi_value tensor_id_value,
+                              napi_value element_offset_value,
+                              napi_value shape_value);
+
+  // Returns an object with the number of typed-array uploads in CreateTensor()
+  // that shared the JS memory (numShared), that TensorFlow had to copy
+  // (numCopied), and the number of copies to a different device
+  // (numDeviceCopies).
+  napi_value GetTensorUploadStats(napi_env env);
+
   // Deletes a created Tensor.
   // - tensor_id_value (number)
   void DeleteTensor(napi_env env, napi_value tensor_id_value);
 
+  // Returns an object with the number of live tensors (numTensors) and the
+  // bytes of tensor data they hold (numBytes). The bytes are also reported to
+  // V8 as external memory.
+  napi_value GetMemoryInfo(napi_env env);
+
+  // Returns the always-on metrics: an `ops` array with the execution count,
+  // total latency (totalNanos) and latency histogram (latencyBuckets, see
+  // OpMetrics) of every executed op, and counters of tensor allocations,
+  // uploads and readbacks (with their bytes).
+  napi_value GetMetrics(napi_env env);
+
+  // Creates the TFE_Context now instead of on the first op execution.
+  void InitContext(napi_env env);
+
+  // Returns whether the TFE_Context has been created.
+  napi_value IsContextInitialized(napi_env env);
+
   // Returns a typed-array as a `napi_value` with the data associated with the
   // TF/TFE pointers.
   // - tensor_id_value (number)
   napi_value GetTensorData(napi_env env, napi_value tensor_id_value);
 
+  // Copies the data associated with the TF/TFE pointers into an existing
+  // typed-array of the matching type and length.
+  // - tensor_id_value (number)
+  // - array_value (TypedArray)
+  void GetTensorDataInto(napi_env env, napi_value tensor_id_value,
+                         napi_value array_value);
+
   // Executes a TFE Op and returns an array of objects containing tensor
   // attributes (id, dtype, shape).
   // - op_name_value (string)
@@ -59,16 +135,95 @@ class TFJSBackend {
                        napi_value op_attr_inputs, napi_value input_tensor_ids,
                        napi_value num_output_values);
 
+  // Same as ExecuteOp(), but executes the op on the libuv thread pool and
+  // returns a promise of the array of output tensor attributes.
+  napi_value ExecuteOpAsync(napi_env env, napi_value op_name_value,
+                            napi_value op_attr_inputs,
+                            napi_value input_tensor_ids,
+                            napi_value num_output_values);
+
+  // Enqueues scalar summaries that share one step to be written on a
+  // background thread.
+  // - writer_id_value (number)
+  // - step_value (number)
+  // - tags_value (string[])
+  // - values_value (Float32Array)
+  void WriteScalarSummaries(napi_env env, napi_value writer_id_value,
+                            napi_value step_value, napi_value tags_value,
+                            napi_value values_value);
+
+  // Enqueues a scalar summary whose value is a scalar tensor. The value is
+  // read on the background thread, in order with the other summaries.
+  // - writer_id_value (number)
+  // - step_value (number)
+  // - tag_value (string)
+  // - value_id_value (number)
+  void WriteScalarSummaryTensor(napi_env env, napi_value writer_id_value,
+                                napi_value step_value, napi_value tag_value,
+                                napi_value value_id_value);
+
+  // Blocks until all enqueued summaries have been written. Throws if any of
+  // the writes failed.
+  void FlushSummaryWrites(napi_env env);
+
  private:
   TFJSBackend(napi_env env);
   ~TFJSBackend();
 
-  int32_t InsertHandle(TFE_TensorHandle* tfe_handle);
+  // Adds a handle to `tfe_handle_map_` and returns its ID. If `owns_memory`
+  // is true, TensorFlow allocated the tensor data for this handle, and its
+  // bytes are reported to V8 and counted as live tensor bytes. Handles that
+  // share a V8 ArrayBuffer or the buffer of another tensor are not counted.
+  int32_t InsertHandle(napi_env env, TFE_TensorHandle* tfe_handle,
+                       bool owns_memory);
+
+  // Creates the TFE_Context and selects the device to execute ops on, unless
+  // that was already done. The context is created on first use, so that
+  // loading the binding stays cheap. Returns false and throws a JS error if
+  // the context cannot be created.
+  bool EnsureContext(napi_env env);
+
+  // Creates the queue of summary writes, unless that was already done.
+  // Returns false and throws a JS error if the context cannot be created or
+  // a previous write failed.
+  bool EnsureSummaryWriteQueue(napi_env env);
+
+  // Copies a host tensor to the device used for op execution, unless it is
+  // already placed there. Takes ownership of `tfe_handle` and returns the
+  // handle to use, or nullptr after throwing a JS error.
+  TFE_TensorHandle* MoveToDevice(napi_env env, TFE_TensorHandle* tfe_handle);
+
+  // Adds the inputs and attributes to an op. Returns false and throws a JS
+  // error on failure.
+  bool SetupOp(napi_env env, TFE_Op* tfe_op, napi_value op_attr_inputs,
+               napi_value input_tensor_ids);
+
+  // Takes ownership of the output handles of an op and returns an array of
+  // objects containing their tensor attributes (id, dtype, shape). See
+  // InsertHandle() for `owns_memory`.
+  napi_value CreateOutputTensorInfos(
+      napi_env env, const std::vector<TFE_TensorHandle*>& handles,
+      bool owns_memory);
+
+  struct AsyncOpExecution;
+  static void ExecuteAsyncOp(napi_env env, void* data);
+  static void CompleteAsyncOp(napi_env env, napi_status status, void* data);
 
   TFE_Context* tfe_context_;
   std::map<int32_t, TFE_TensorHandle*> tfe_handle_map_;
   int32_t next_tensor_id_;
+  // Bytes of tensor data owned by the handles in `tfe_handle_map_`, in total
+  // and for each handle that owns memory.
+  int64_t num_tensor_bytes_;
+  std::map<int32_t, int64_t> owned_tensor_bytes_;
   std::string device_name;
+  int64_t num_shared_uploads_;
+  int64_t num_copied_uploads_;
+  int64_t num_device_copies_;
+  std::unique_ptr<SummaryWriteQueue> summary_write_queue_;
+  // Started on the first large CreateTensorFromChunks() call.
+  std::unique_ptr<ChunkCopyPool> chunk_copy_pool_;
+  OpMetrics op_metrics_;
 };
 
 }  // namespace tfnodejs
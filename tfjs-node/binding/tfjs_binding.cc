@@ -65,6 +65,113 @@ static napi_value CreateTensor(napi_env env, napi_callback_info info) {
   return gBackend->CreateTensor(env, args[0], args[1], args[2]);
 }
 
+static napi_value CreateTensorFromChunks(napi_env env,
+                                         napi_callback_info info) {
+  napi_status nstatus;
+
+  // Takes 3 params: shape, dtype, chunks:
+  size_t argc = 3;
+  napi_value args[3];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  if (argc < 3) {
+    NAPI_THROW_ERROR(
+        env, "Invalid number of args passed to createTensorFromChunks()");
+    return nullptr;
+  }
+
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[2], nullptr);
+
+  return gBackend->CreateTensorFromChunks(env, args[0], args[1], args[2]);
+}
+
+static napi_value AllocTensorBuffer(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  // Alloc tensor buffer takes 1 param: byte length;
+  size_t argc = 1;
+  napi_value args[1];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  if (argc < 1) {
+    NAPI_THROW_ERROR(env,
+                     "Invalid number of args passed to allocTensorBuffer()");
+    return nullptr;
+  }
+
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+
+  return gBackend->AllocTensorBuffer(env, args[0]);
+}
+
+static napi_value CreateTensorFromPixels(napi_env env,
+                                         napi_callback_info info) {
+  napi_status nstatus;
+
+  // Takes 6 params: pixels, height, width, num-channels, dtype, normalize:
+  size_t argc = 6;
+  napi_value args[6];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  if (argc < 6) {
+    NAPI_THROW_ERROR(env,
+                     "Invalid number of args passed to "
+                     "createTensorFromPixels()");
+    return nullptr;
+  }
+
+  ENSURE_VALUE_IS_TYPED_ARRAY_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[2], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[4], nullptr);
+
+  return gBackend->CreateTensorFromPixels(env, args[0], args[1], args[2],
+                                          args[3], args[4], args[5]);
+}
+
+static napi_value CreateTensorView(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  // Takes 3 params: tensor ID, element offset, shape:
+  size_t argc = 3;
+  napi_value args[3];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  if (argc < 3) {
+    NAPI_THROW_ERROR(env,
+                     "Invalid number of args passed to createTensorView()");
+    return nullptr;
+  }
+
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[2], nullptr);
+
+  return gBackend->CreateTensorView(env, args[0], args[1], args[2]);
+}
+
+static napi_value GetTensorUploadStats(napi_env env,
+                                       napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return gBackend->GetTensorUploadStats(env);
+}
+
 static napi_value DeleteTensor(napi_env env, napi_callback_info info) {
   napi_status nstatus;
 
@@ -86,6 +193,48 @@ static napi_value DeleteTensor(napi_env env, napi_callback_info info) {
   return js_this;
 }
 
+static napi_value GetMemoryInfo(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return gBackend->GetMemoryInfo(env);
+}
+
+static napi_value GetMetrics(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return gBackend->GetMetrics(env);
+}
+
+static napi_value InitContext(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  gBackend->InitContext(env);
+  return js_this;
+}
+
+static napi_value IsContextInitialized(napi_env env,
+                                       napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  return gBackend->IsContextInitialized(env);
+}
+
 static napi_value TensorDataSync(napi_env env, napi_callback_info info) {
   napi_status nstatus;
 
@@ -106,6 +255,28 @@ static napi_value TensorDataSync(napi_env env, napi_callback_info info) {
   return gBackend->GetTensorData(env, args[0]);
 }
 
+static napi_value TensorDataInto(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  // Tensor data-into takes 2 params: tensor ID, typed-array;
+  size_t argc = 2;
+  napi_value args[2];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, js_this);
+
+  if (argc < 2) {
+    NAPI_THROW_ERROR(env, "Invalid number of args passed to tensorDataInto()");
+    return js_this;
+  }
+
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], js_this);
+  ENSURE_VALUE_IS_TYPED_ARRAY_RETVAL(env, args[1], js_this);
+
+  gBackend->GetTensorDataInto(env, args[0], args[1]);
+  return js_this;
+}
+
 static napi_value ExecuteOp(napi_env env, napi_callback_info info) {
   napi_status nstatus;
 
@@ -130,6 +301,94 @@ static napi_value ExecuteOp(napi_env env, napi_callback_info info) {
   return gBackend->ExecuteOp(env, args[0], args[1], args[2], args[3]);
 }
 
+static napi_value ExecuteOpAsync(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  // Takes the same 4 params as executeOp():
+  size_t argc = 4;
+  napi_value args[4];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, nullptr);
+
+  if (argc < 4) {
+    NAPI_THROW_ERROR(env, "Invalid number of args passed to executeOpAsync()");
+    return nullptr;
+  }
+
+  ENSURE_VALUE_IS_STRING_RETVAL(env, args[0], nullptr);
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[1], nullptr);
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[2], nullptr);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], nullptr);
+
+  return gBackend->ExecuteOpAsync(env, args[0], args[1], args[2], args[3]);
+}
+
+static napi_value WriteScalarSummaries(napi_env env,
+                                       napi_callback_info info) {
+  napi_status nstatus;
+
+  // Write scalar summaries takes 4 params: writer-tensor-id, step, tags,
+  // values:
+  size_t argc = 4;
+  napi_value args[4];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, js_this);
+
+  if (argc < 4) {
+    NAPI_THROW_ERROR(
+        env, "Invalid number of args passed to writeScalarSummaries()");
+    return js_this;
+  }
+
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], js_this);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], js_this);
+  ENSURE_VALUE_IS_ARRAY_RETVAL(env, args[2], js_this);
+  ENSURE_VALUE_IS_TYPED_ARRAY_RETVAL(env, args[3], js_this);
+
+  gBackend->WriteScalarSummaries(env, args[0], args[1], args[2], args[3]);
+  return js_this;
+}
+
+static napi_value WriteScalarSummaryTensor(napi_env env,
+                                           napi_callback_info info) {
+  napi_status nstatus;
+
+  // Write scalar summary tensor takes 4 params: writer-tensor-id, step, tag,
+  // value-tensor-id:
+  size_t argc = 4;
+  napi_value args[4];
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, &argc, args, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, js_this);
+
+  if (argc < 4) {
+    NAPI_THROW_ERROR(
+        env, "Invalid number of args passed to writeScalarSummaryTensor()");
+    return js_this;
+  }
+
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[0], js_this);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[1], js_this);
+  ENSURE_VALUE_IS_STRING_RETVAL(env, args[2], js_this);
+  ENSURE_VALUE_IS_NUMBER_RETVAL(env, args[3], js_this);
+
+  gBackend->WriteScalarSummaryTensor(env, args[0], args[1], args[2], args[3]);
+  return js_this;
+}
+
+static napi_value FlushSummaryWrites(napi_env env, napi_callback_info info) {
+  napi_status nstatus;
+
+  napi_value js_this;
+  nstatus = napi_get_cb_info(env, info, nullptr, nullptr, &js_this, nullptr);
+  ENSURE_NAPI_OK_RETVAL(env, nstatus, js_this);
+
+  gBackend->FlushSummaryWrites(env);
+  return js_this;
+}
+
 static napi_value InitTFNodeJSBinding(napi_env env, napi_value exports) {
   napi_status nstatus;
 
@@ -145,12 +404,40 @@ static napi_value InitTFNodeJSBinding(napi_env env, napi_value exports) {
   napi_property_descriptor exports_properties[] = {
       {"createTensor", nullptr, CreateTensor, nullptr, nullptr, nullptr,
        napi_default, nullptr},
+      {"createTensorFromChunks", nullptr, CreateTensorFromChunks, nullptr,
+       nullptr, nullptr, napi_default, nullptr},
+      {"createTensorFromPixels", nullptr, CreateTensorFromPixels, nullptr,
+       nullptr, nullptr, napi_default, nullptr},
+      {"createTensorView", nullptr, CreateTensorView, nullptr, nullptr,
+       nullptr, napi_default, nullptr},
       {"deleteTensor", nullptr, DeleteTensor, nullptr, nullptr, nullptr,
        napi_default, nullptr},
+      {"allocTensorBuffer", nullptr, AllocTensorBuffer, nullptr, nullptr,
+       nullptr, napi_default, nullptr},
+      {"getTensorUploadStats", nullptr, GetTensorUploadStats, nullptr, nullptr,
+       nullptr, napi_default, nullptr},
+      {"getMemoryInfo", nullptr, GetMemoryInfo, nullptr, nullptr, nullptr,
+       napi_default, nullptr},
+      {"getMetrics", nullptr, GetMetrics, nullptr, nullptr, nullptr,
+       napi_default, nullptr},
+      {"initContext", nullptr, InitContext, nullptr, nullptr, nullptr,
+       napi_default, nullptr},
+      {"isContextInitialized", nullptr, IsContextInitialized, nullptr,
+       nullptr, nullptr, napi_default, nullptr},
       {"tensorDataSync", nullptr, TensorDataSync, nullptr, nullptr, nullptr,
        napi_default, nullptr},
+      {"tensorDataInto", nullptr, TensorDataInto, nullptr, nullptr, nullptr,
+       napi_default, nullptr},
       {"executeOp", nullptr, ExecuteOp, nullptr, nullptr, nullptr, napi_default,
        nullptr},
+      {"executeOpAsync", nullptr, ExecuteOpAsync, nullptr, nullptr, nullptr,
+       napi_default, nullptr},
+      {"writeScalarSummaries", nullptr, WriteScalarSummaries, nullptr, nullptr,
+       nullptr, napi_default, nullptr},
+      {"writeScalarSummaryTensor", nullptr, WriteScalarSummaryTensor, nullptr,
+       nullptr, nullptr, napi_default, nullptr},
+      {"flushSummaryWrites", nullptr, FlushSummaryWrites, nullptr, nullptr,
+       nullptr, napi_default, nullptr},
       {"TF_Version", nullptr, nullptr, nullptr, nullptr, tf_version,
        napi_default, nullptr},
   };
@@ -169,6 +456,10 @@ static napi_value InitTFNodeJSBinding(napi_env env, napi_value exports) {
   EXPORT_INT_PROPERTY(TF_STRING);
   EXPORT_INT_PROPERTY(TF_RESOURCE);
   EXPORT_INT_PROPERTY(TF_UINT8);
+  EXPORT_INT_PROPERTY(TF_VARIANT);
+  EXPORT_INT_PROPERTY(TF_QINT8);
+  EXPORT_INT_PROPERTY(TF_QUINT8);
+  EXPORT_INT_PROPERTY(TF_QINT32);
 
   // Op AttrType
   EXPORT_INT_PROPERTY(TF_ATTR_STRING);
@@ -0,0 +1,220 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {scalar, Tensor2D, Tensor3D, tidy, util} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/** The samples and sample rate of a decoded WAV file. */
+export interface DecodedWav {
+  /**
+   * A 2D Tensor of dtype `float32` with shape [samples, channels] and values
+   * in the range [-1, 1].
+   */
+  audio: Tensor2D;
+
+  /** The number of samples per second. */
+  sampleRate: number;
+}
+
+export interface MfccBatchArgs {
+  /** Number of channels to decode, or -1 for all channels. Default: `-1`. */
+  desiredChannels?: number;
+
+  /**
+   * Number of samples to decode, or -1 for all samples. Shorter files are
+   * padded with zeros. Default: `-1`.
+   */
+  desiredSamples?: number;
+
+  /** The spectrogram window size, in samples. */
+  windowSize: number;
+
+  /** The number of samples between the starts of two windows. */
+  stride: number;
+
+  /** Default: `4000`. */
+  upperFrequencyLimit?: number;
+
+  /** Default: `20`. */
+  lowerFrequencyLimit?: number;
+
+  /** Default: `40`. */
+  filterbankChannelCount?: number;
+
+  /** Default: `13`. */
+  dctCoefficientCount?: number;
+}
+
+/**
+ * Decode a 16-bit PCM WAV file.
+ *
+ * @param contents The WAV-encoded audio in an Uint8Array.
+ * @param desiredChannels An optional int. Defaults to -1. Number of channels
+ *     to decode, -1 uses the number of channels in the file.
+ * @param desiredSamples An optional int. Defaults to -1. Number of samples
+ *     to decode, -1 decodes all samples. Shorter files are padded with zeros.
+ * @returns The samples, as a 2D Tensor of dtype `float32` with shape
+ *     [samples, channels], and the sample rate.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Audio', namespace: 'node'}
+ */
+export function decodeWav(
+    contents: Uint8Array, desiredChannels = -1,
+    desiredSamples = -1): DecodedWav {
+  ensureTensorflowBackend();
+  const [audio, sampleRate] =
+      nodeBackend().decodeWav(contents, desiredChannels, desiredSamples);
+  const rate = sampleRate.dataSync()[0];
+  sampleRate.dispose();
+  return {audio, sampleRate: rate};
+}
+
+/**
+ * Compute the spectrogram of audio samples.
+ *
+ * @param input A 2D Tensor of dtype `float32` with shape [samples, channels],
+ *     e.g., the audio returned by `tf.node.decodeWav()`.
+ * @param windowSize The window size, in samples.
+ * @param stride The number of samples between the starts of two windows.
+ * @param magnitudeSquared An optional bool. Defaults to false. If true,
+ *     return the squared magnitude of each frequency bin, which is the input
+ *     expected by `tf.node.mfcc()`.
+ * @returns A 3D Tensor of dtype `float32` with shape [channels, windows,
+ *     bins], with one bin per frequency up to half of the next power of two
+ *     of `windowSize`.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Audio', namespace: 'node'}
+ */
+export function audioSpectrogram(
+    input: Tensor2D, windowSize: number, stride: number,
+    magnitudeSquared = false): Tensor3D {
+  util.assert(
+      input.rank === 2 && input.dtype === 'float32',
+      () => `audioSpectrogram() expects a 2D float32 tensor, but got a ` +
+          `${input.rank}D ${input.dtype} tensor`);
+  ensureTensorflowBackend();
+  return nodeBackend().audioSpectrogram(
+      input, windowSize, stride, magnitudeSquared);
+}
+
+/**
+ * Compute the mel-frequency cepstral coefficients (MFCCs) of a spectrogram.
+ *
+ * @param spectrogram A 3D Tensor returned by `tf.node.audioSpectrogram()`
+ *     with `magnitudeSquared` set to true.
+ * @param sampleRate The sample rate of the audio.
+ * @param upperFrequencyLimit An optional float. Defaults to 4000. The
+ *     highest frequency to use, in Hz.
+ * @param lowerFrequencyLimit An optional float. Defaults to 20. The lowest
+ *     frequency to use, in Hz.
+ * @param filterbankChannelCount An optional int. Defaults to 40. Resolution
+ *     of the mel bank.
+ * @param dctCoefficientCount An optional int. Defaults to 13. Number of
+ *     coefficients per window.
+ * @returns A 3D Tensor of dtype `float32` with shape [channels, windows,
+ *     dctCoefficientCount].
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Audio', namespace: 'node'}
+ */
+export function mfcc(
+    spectrogram: Tensor3D, sampleRate: number, upperFrequencyLimit = 4000,
+    lowerFrequencyLimit = 20, filterbankChannelCount = 40,
+    dctCoefficientCount = 13): Tensor3D {
+  ensureTensorflowBackend();
+  return tidy(() => {
+    return nodeBackend().mfcc(
+        spectrogram, scalar(sampleRate, 'int32'), upperFrequencyLimit,
+        lowerFrequencyLimit, filterbankChannelCount, dctCoefficientCount);
+  });
+}
+
+/**
+ * Compute the MFCCs of a batch of WAV files off the main thread.
+ *
+ * Each file is decoded, converted to a spectrogram (with squared
+ * magnitudes) and then to MFCCs by TensorFlow ops that execute on the libuv
+ * thread pool, so the event loop is not blocked and several files are
+ * processed in parallel.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ * const fs = require('fs');
+ *
+ * const wavs = ['yes.wav', 'no.wav'].map(file => fs.readFileSync(file));
+ * const features = await tf.node.mfccBatch(
+ *     wavs, {desiredSamples: 16000, windowSize: 480, stride: 160});
+ * ```
+ *
+ * @param contents The WAV-encoded audio files.
+ * @param args The decoding, spectrogram and MFCC arguments.
+ * @returns One 3D Tensor of dtype `float32` with shape [channels, windows,
+ *     dctCoefficientCount] per file.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Audio', namespace: 'node'}
+ */
+export async function mfccBatch(
+    contents: Uint8Array[], args: MfccBatchArgs): Promise<Tensor3D[]> {
+  ensureTensorflowBackend();
+  const backend = nodeBackend();
+  const desiredChannels =
+      args.desiredChannels == null ? -1 : args.desiredChannels;
+  const desiredSamples = args.desiredSamples == null ? -1 : args.desiredSamples;
+  const upperFrequencyLimit =
+      args.upperFrequencyLimit == null ? 4000 : args.upperFrequencyLimit;
+  const lowerFrequencyLimit =
+      args.lowerFrequencyLimit == null ? 20 : args.lowerFrequencyLimit;
+  const filterbankChannelCount =
+      args.filterbankChannelCount == null ? 40 : args.filterbankChannelCount;
+  const dctCoefficientCount =
+      args.dctCoefficientCount == null ? 13 : args.dctCoefficientCount;
+
+  const computeMfcc = async (wav: Uint8Array): Promise<Tensor3D> => {
+    const [audio, sampleRate] =
+        await backend.decodeWavAsync(wav, desiredChannels, desiredSamples);
+    try {
+      const spectrogram = await backend.audioSpectrogramAsync(
+          audio, args.windowSize, args.stride, true);
+      try {
+        return await backend.mfccAsync(
+            spectrogram, sampleRate, upperFrequencyLimit, lowerFrequencyLimit,
+            filterbankChannelCount, dctCoefficientCount);
+      } finally {
+        spectrogram.dispose();
+      }
+    } finally {
+      audio.dispose();
+      sampleRate.dispose();
+    }
+  };
+
+  // Wait for every file, so that no tensor is leaked when one of them fails.
+  const results = await Promise.all(contents.map(
+      wav => computeMfcc(wav).then(
+          features => ({features, error: null as Error}),
+          (error: Error) => ({features: null as Tensor3D, error}))));
+  const failure = results.find(result => result.error != null);
+  if (failure != null) {
+    results.forEach(result => result.features && result.features.dispose());
+    throw failure.error;
+  }
+  return results.map(result => result.features);
+}
@@ -0,0 +1,141 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+/** Encodes 16-bit PCM samples as a WAV file. */
+function encodeWav(
+    samples: number[], sampleRate: number, numChannels = 1): Uint8Array {
+  const dataSize = samples.length * 2;
+  const buffer = Buffer.alloc(44 + dataSize);
+  buffer.write('RIFF', 0);
+  buffer.writeUInt32LE(36 + dataSize, 4);
+  buffer.write('WAVE', 8);
+  buffer.write('fmt ', 12);
+  buffer.writeUInt32LE(16, 16);
+  buffer.writeUInt16LE(1, 20);  // PCM
+  buffer.writeUInt16LE(numChannels, 22);
+  buffer.writeUInt32LE(sampleRate, 24);
+  buffer.writeUInt32LE(sampleRate * numChannels * 2, 28);
+  buffer.writeUInt16LE(numChannels * 2, 32);
+  buffer.writeUInt16LE(16, 34);
+  buffer.write('data', 36);
+  buffer.writeUInt32LE(dataSize, 40);
+  samples.forEach((sample, i) => buffer.writeInt16LE(sample, 44 + i * 2));
+  return new Uint8Array(buffer);
+}
+
+/** Returns a 16-bit PCM sine wave. */
+function sineWave(
+    frequency: number, sampleRate: number, numSamples: number): number[] {
+  const samples: number[] = [];
+  for (let i = 0; i < numSamples; ++i) {
+    samples.push(Math.round(
+        16000 * Math.sin(2 * Math.PI * frequency * i / sampleRate)));
+  }
+  return samples;
+}
+
+describe('audio', () => {
+  it('decodeWav', async () => {
+    const wav = encodeWav([0, 16384, -16384, 8192], 16000);
+    const {audio, sampleRate} = tf.node.decodeWav(wav);
+    expect(sampleRate).toEqual(16000);
+    expect(audio.shape).toEqual([4, 1]);
+    expect(audio.dtype).toEqual('float32');
+    tf.test_util.expectArraysClose(await audio.data(), [0, 0.5, -0.5, 0.25]);
+  });
+
+  it('decodeWav stereo with desired samples', async () => {
+    const wav = encodeWav([16384, -16384, 8192, -8192], 8000, 2);
+    const {audio, sampleRate} = tf.node.decodeWav(wav, -1, 3);
+    expect(sampleRate).toEqual(8000);
+    expect(audio.shape).toEqual([3, 2]);
+    tf.test_util.expectArraysClose(
+        await audio.data(), [0.5, -0.5, 0.25, -0.25, 0, 0]);
+  });
+
+  it('decodeWav throws on invalid contents', () => {
+    expect(() => tf.node.decodeWav(new Uint8Array([1, 2, 3]))).toThrow();
+  });
+
+  it('audioSpectrogram', async () => {
+    const wav = encodeWav(sineWave(1000, 16000, 1024), 16000);
+    const {audio} = tf.node.decodeWav(wav);
+    const spectrogram = tf.node.audioSpectrogram(audio, 256, 128);
+    // 1 + (1024 - 256) / 128 windows, 256 / 2 + 1 frequency bins.
+    expect(spectrogram.shape).toEqual([1, 7, 129]);
+    // The peak is in the bin of 1000Hz: 1000 / 16000 * 256.
+    const peakBins = await spectrogram.argMax(2).data();
+    expect(Array.from(peakBins)).toEqual([16, 16, 16, 16, 16, 16, 16]);
+  });
+
+  it('audioSpectrogram rejects non-2D inputs', () => {
+    expect(() => tf.node.audioSpectrogram(tf.zeros([4]) as tf.Tensor2D, 2, 1))
+        .toThrowError(/2D float32/);
+  });
+
+  it('mfcc', () => {
+    const wav = encodeWav(sineWave(440, 16000, 1600), 16000);
+    const {audio, sampleRate} = tf.node.decodeWav(wav);
+    const spectrogram = tf.node.audioSpectrogram(audio, 480, 160, true);
+    const features = tf.node.mfcc(spectrogram, sampleRate);
+    expect(features.shape).toEqual([1, 8, 13]);
+    const fewerFeatures =
+        tf.node.mfcc(spectrogram, sampleRate, 4000, 20, 40, 10);
+    expect(fewerFeatures.shape).toEqual([1, 8, 10]);
+  });
+
+  it('mfccBatch matches the synchronous ops', async () => {
+    const wavs = [
+      encodeWav(sineWave(440, 16000, 1600), 16000),
+      encodeWav(sineWave(880, 16000, 1200), 16000)
+    ];
+    const numTensors = tf.memory().numTensors;
+    const features =
+        await tf.node.mfccBatch(wavs, {windowSize: 480, stride: 160});
+    expect(tf.memory().numTensors).toEqual(numTensors + 2);
+    expect(features[0].shape).toEqual([1, 8, 13]);
+    expect(features[1].shape).toEqual([1, 5, 13]);
+
+    for (let i = 0; i < wavs.length; ++i) {
+      const expected = tf.tidy(() => {
+        const {audio, sampleRate} = tf.node.decodeWav(wavs[i]);
+        return tf.node.mfcc(
+            tf.node.audioSpectrogram(audio, 480, 160, true), sampleRate);
+      });
+      tf.test_util.expectArraysClose(
+          await features[i].data(), await expected.data());
+    }
+  });
+
+  it('mfccBatch rejects if a file cannot be decoded', async done => {
+    const numTensors = tf.memory().numTensors;
+    try {
+      await tf.node.mfccBatch(
+          [
+            encodeWav(sineWave(440, 16000, 1600), 16000),
+            new Uint8Array([1, 2, 3])
+          ],
+          {windowSize: 480, stride: 160});
+      done.fail('mfccBatch() should have failed');
+    } catch (e) {
+      expect(tf.memory().numTensors).toEqual(numTensors);
+      done();
+    }
+  });
+});
@@ -0,0 +1,256 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {concat, InferenceModel, split, Tensor, tidy, util} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend} from './ops/op_utils';
+
+export interface BatchSchedulerArgs {
+  /**
+   * Maximum number of examples (summed over the leading dimension of the
+   * queued inputs) that are executed together in one batch.
+   *
+   * Default: `32`.
+   */
+  maxBatchSize?: number;
+
+  /**
+   * Maximum time, in milliseconds, that the first request of a batch waits
+   * for other requests to join before the batch is executed anyway. This
+   * bounds the latency added by batching.
+   *
+   * Default: `5`.
+   */
+  batchTimeoutMillis?: number;
+}
+
+type PredictResult = Tensor|Tensor[];
+
+/** A single `predict()` call waiting in a queue. */
+interface PendingRequest {
+  inputs: Tensor[];
+  batchSize: number;
+  resolve: (result: PredictResult) => void;
+  reject: (error: Error) => void;
+}
+
+/** Requests that share one input signature. */
+interface RequestQueue {
+  requests: PendingRequest[];
+  numExamples: number;
+  hasTimer: boolean;
+}
+
+/**
+ * Queues concurrent `predict()` calls that share an input signature and
+ * executes them as a single batch.
+ *
+ * Users are expected to access this class through the `batchScheduler()`
+ * factory method instead.
+ */
+export class BatchScheduler {
+  private readonly maxBatchSize: number;
+  private readonly batchTimeoutMillis: number;
+  private readonly queues: {[signature: string]: RequestQueue} = {};
+
+  constructor(
+      private readonly model: InferenceModel, args?: BatchSchedulerArgs) {
+    ensureTensorflowBackend();
+    args = args == null ? {} : args;
+    this.maxBatchSize = args.maxBatchSize == null ? 32 : args.maxBatchSize;
+    this.batchTimeoutMillis =
+        args.batchTimeoutMillis == null ? 5 : args.batchTimeoutMillis;
+    util.assert(
+        Number.isInteger(this.maxBatchSize) && this.maxBatchSize > 0,
+        () => `Expected maxBatchSize to be a positive integer, but got ` +
+            `${this.maxBatchSize}`);
+    util.assert(
+        this.batchTimeoutMillis >= 0,
+        () => `Expected batchTimeoutMillis to be non-negative, but got ` +
+            `${this.batchTimeoutMillis}`);
+  }
+
+  /**
+   * Schedules `inputs` for execution with the model.
+   *
+   * The returned promise resolves to the slice of the batched model output
+   * that corresponds to `inputs`. The caller owns both `inputs` and the
+   * resolved output tensors.
+   *
+   * @param inputs A single input tensor, or an array of them for models with
+   *   multiple inputs. All inputs must have the same size along their first
+   *   (batch) dimension.
+   */
+  predict(inputs: Tensor|Tensor[]): Promise<PredictResult> {
+    const inputArray = Array.isArray(inputs) ? inputs : [inputs];
+    util.assert(
+        inputArray.length > 0, () => 'predict() requires at least one input');
+    const batchSize = inputArray[0].shape[0];
+    for (const input of inputArray) {
+      util.assert(
+          input.rank > 0 && input.shape[0] === batchSize,
+          () => `All inputs must have the same batch size (${batchSize}), ` +
+              `but got an input with shape [${input.shape}]`);
+    }
+
+    const signature = getInputSignature(inputArray);
+    return new Promise<PredictResult>((resolve, reject) => {
+      let queue = this.queues[signature];
+      if (queue == null) {
+        queue = {requests: [], numExamples: 0, hasTimer: false};
+        this.queues[signature] = queue;
+      }
+      queue.requests.push({inputs: inputArray, batchSize, resolve, reject});
+      queue.numExamples += batchSize;
+
+      if (queue.numExamples >= this.maxBatchSize) {
+        this.dispatch(signature);
+      } else if (!queue.hasTimer) {
+        queue.hasTimer = true;
+        const timedQueue = queue;
+        setTimeout(() => {
+          // The queue may already have been dispatched because it filled up.
+          if (this.queues[signature] === timedQueue) {
+            this.dispatch(signature);
+          }
+        }, this.batchTimeoutMillis);
+      }
+    });
+  }
+
+  /**
+   * Executes every request that is queued at this moment, regardless of the
+   * batch size and timeout.
+   */
+  flush() {
+    for (const signature of Object.keys(this.queues)) {
+      this.dispatch(signature);
+    }
+  }
+
+  /** Executes the queued requests of one signature in batches. */
+  private dispatch(signature: string) {
+    const queue = this.queues[signature];
+    if (queue == null) {
+      return;
+    }
+    delete this.queues[signature];
+
+    // Requests are grouped in arrival order. A request that is larger than
+    // `maxBatchSize` on its own is executed as a batch by itself.
+    let batch: PendingRequest[] = [];
+    let numExamples = 0;
+    for (const request of queue.requests) {
+      if (batch.length > 0 &&
+          numExamples + request.batchSize > this.maxBatchSize) {
+        this.executeBatch(batch);
+        batch = [];
+        numExamples = 0;
+      }
+      batch.push(request);
+      numExamples += request.batchSize;
+    }
+    if (batch.length > 0) {
+      this.executeBatch(batch);
+    }
+  }
+
+  private executeBatch(batch: PendingRequest[]) {
+    let results: PredictResult[];
+    try {
+      results = tidy(() => {
+        const numInputs = batch[0].inputs.length;
+        const batchedInputs: Tensor[] = [];
+        for (let i = 0; i < numInputs; ++i) {
+          batchedInputs.push(
+              batch.length === 1 ? batch[0].inputs[i] :
+                                   concat(batch.map(r => r.inputs[i]), 0));
+        }
+        const output = this.model.predict(
+            batchedInputs.length === 1 ? batchedInputs[0] : batchedInputs, {});
+        return splitOutput(output as PredictResult, batch);
+      });
+    } catch (e) {
+      for (const request of batch) {
+        request.reject(e);
+      }
+      return;
+    }
+    for (let i = 0; i < batch.length; ++i) {
+      batch[i].resolve(results[i]);
+    }
+  }
+}
+
+/**
+ * Returns a key that identifies inputs that can be concatenated along their
+ * first dimension.
+ */
+function getInputSignature(inputs: Tensor[]): string {
+  return inputs.map(input => `${input.dtype}[${input.shape.slice(1)}]`)
+      .join(';');
+}
+
+/** Splits the batched model output back into one result per request. */
+function splitOutput(
+    output: PredictResult, batch: PendingRequest[]): PredictResult[] {
+  const sizes = batch.map(r => r.batchSize);
+  const splitOne = (tensor: Tensor): Tensor[] =>
+      batch.length === 1 ? [tensor] : split(tensor, sizes, 0);
+
+  if (Array.isArray(output)) {
+    const perOutput = output.map(splitOne);
+    return batch.map((request, i) => perOutput.map(pieces => pieces[i]));
+  } else {
+    return splitOne(output);
+  }
+}
+
+/**
+ * Create a scheduler that batches concurrent inference requests.
+ *
+ * When many callers (e.g., HTTP request handlers) run a model concurrently,
+ * executing each request with a batch size of 1 underuses the TensorFlow
+ * thread pool. A `BatchScheduler` queues concurrent `predict()` calls with
+ * the same input signature (dtype and shape apart from the first dimension),
+ * concatenates them into one batch of up to `maxBatchSize` examples, executes
+ * the model once and splits the outputs back to each caller. A batch that is
+ * not full is executed after `batchTimeoutMillis`.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const model = await tf.loadLayersModel('file:///tmp/my-model/model.json');
+ * const scheduler = tf.node.batchScheduler(model, {maxBatchSize: 16});
+ *
+ * // In a request handler:
+ * const output = await scheduler.predict(tf.tensor2d(features, [1, 10]));
+ * ```
+ *
+ * @param model The model to execute, e.g., a `tf.LayersModel` or a
+ *   `tf.GraphModel`.
+ * @param args Optional configuration arguments.
+ * @returns An instance of `BatchScheduler`.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function batchScheduler(
+    model: InferenceModel, args?: BatchSchedulerArgs): BatchScheduler {
+  return new BatchScheduler(model, args);
+}
@@ -0,0 +1,128 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+describe('batchScheduler', () => {
+  let model: tf.Sequential;
+
+  beforeEach(() => {
+    model = tf.sequential();
+    model.add(tf.layers.dense({units: 2, inputShape: [3]}));
+  });
+
+  it('Concurrent requests are executed as one batch', async () => {
+    const predictSpy = spyOn(model, 'predict').and.callThrough();
+    const scheduler = tf.node.batchScheduler(
+        model, {maxBatchSize: 4, batchTimeoutMillis: 50});
+
+    const x1 = tf.tensor2d([[1, 2, 3]]);
+    const x2 = tf.tensor2d([[4, 5, 6], [7, 8, 9]]);
+    const x3 = tf.tensor2d([[-1, -2, -3]]);
+    const [y1, y2, y3] = await Promise.all([
+      scheduler.predict(x1), scheduler.predict(x2), scheduler.predict(x3)
+    ]) as tf.Tensor[];
+
+    expect(predictSpy).toHaveBeenCalledTimes(1);
+    expect(y1.shape).toEqual([1, 2]);
+    expect(y2.shape).toEqual([2, 2]);
+    expect(y3.shape).toEqual([1, 2]);
+    tf.test_util.expectArraysClose(
+        await y1.data(), await (model.predict(x1) as tf.Tensor).data());
+    tf.test_util.expectArraysClose(
+        await y2.data(), await (model.predict(x2) as tf.Tensor).data());
+    tf.test_util.expectArraysClose(
+        await y3.data(), await (model.predict(x3) as tf.Tensor).data());
+  });
+
+  it('A full batch is executed without waiting for the timeout', async () => {
+    const predictSpy = spyOn(model, 'predict').and.callThrough();
+    const scheduler = tf.node.batchScheduler(
+        model, {maxBatchSize: 2, batchTimeoutMillis: 60000});
+
+    const x = tf.ones([1, 3]);
+    const ys = await Promise.all([scheduler.predict(x), scheduler.predict(x)]);
+    expect(predictSpy).toHaveBeenCalledTimes(1);
+    expect(ys.length).toEqual(2);
+  });
+
+  it('Batches are capped at maxBatchSize', async () => {
+    const predictSpy = spyOn(model, 'predict').and.callThrough();
+    const scheduler = tf.node.batchScheduler(
+        model, {maxBatchSize: 2, batchTimeoutMillis: 1});
+
+    const x = tf.ones([1, 3]);
+    const promises: Array<Promise<tf.Tensor|tf.Tensor[]>> = [];
+    for (let i = 0; i < 5; ++i) {
+      promises.push(scheduler.predict(x));
+    }
+    await Promise.all(promises);
+    expect(predictSpy).toHaveBeenCalledTimes(3);
+    for (const call of predictSpy.calls.all()) {
+      expect((call.args[0] as tf.Tensor).shape[0]).toBeLessThanOrEqual(2);
+    }
+  });
+
+  it('Requests with different signatures are not mixed', async () => {
+    const input = tf.input({shape: [null, 3]});
+    const output =
+        tf.layers.globalAveragePooling1d().apply(input) as tf.SymbolicTensor;
+    const seqModel = tf.model({inputs: input, outputs: output});
+    const predictSpy = spyOn(seqModel, 'predict').and.callThrough();
+    const scheduler = tf.node.batchScheduler(
+        seqModel, {maxBatchSize: 8, batchTimeoutMillis: 10});
+
+    const [y1, y2] = await Promise.all([
+      scheduler.predict(tf.ones([1, 2, 3])),
+      scheduler.predict(tf.ones([1, 4, 3]))
+    ]) as tf.Tensor[];
+    expect(predictSpy).toHaveBeenCalledTimes(2);
+    expect(y1.shape).toEqual([1, 3]);
+    expect(y2.shape).toEqual([1, 3]);
+  });
+
+  it('Errors are propagated to every request of the batch', async () => {
+    spyOn(model, 'predict').and.throwError('predict failed');
+    const scheduler = tf.node.batchScheduler(
+        model, {maxBatchSize: 2, batchTimeoutMillis: 1});
+
+    const x = tf.ones([1, 3]);
+    const results = await Promise.all([
+      scheduler.predict(x).catch(e => e.message),
+      scheduler.predict(x).catch(e => e.message)
+    ]);
+    expect(results).toEqual(['predict failed', 'predict failed']);
+  });
+
+  it('flush() executes pending requests immediately', async () => {
+    const predictSpy = spyOn(model, 'predict').and.callThrough();
+    const scheduler = tf.node.batchScheduler(
+        model, {maxBatchSize: 8, batchTimeoutMillis: 60000});
+
+    const promise = scheduler.predict(tf.ones([1, 3]));
+    scheduler.flush();
+    const y = await promise as tf.Tensor;
+    expect(predictSpy).toHaveBeenCalledTimes(1);
+    expect(y.shape).toEqual([1, 2]);
+  });
+
+  it('Mismatched batch sizes across inputs throw', () => {
+    const scheduler = tf.node.batchScheduler(model);
+    expect(() => scheduler.predict([tf.ones([1, 3]), tf.ones([2, 3])]))
+        .toThrowError(/same batch size/);
+  });
+});
@@ -15,7 +15,8 @@
  * =============================================================================
  */
 
-import {CustomCallback, Logs, nextFrame, util} from '@tensorflow/tfjs';
+// tslint:disable-next-line:max-line-length
+import {concat, CustomCallback, LayersModel, Logs, nextFrame, Scalar, Tensor, tidy, util} from '@tensorflow/tfjs';
 import * as path from 'path';
 import * as ProgressBar from 'progress';
 
@@ -29,6 +30,119 @@ export const progressBarHelper: {ProgressBar: any, log: Function} = {
   log: console.log
 };
 
+/**
+ * Per-batch logs as passed to `onBatchEnd()` by the training loop, before
+ * their `tf.Scalar` values are read back.
+ */
+export type UnresolvedLogs = {
+  [key: string]: Scalar|number
+};
+
+/**
+ * Holds the logs of training batches without reading them back, so that the
+ * scalars of many batches can be read back together with one `data()` call.
+ */
+export class DeferredLogs {
+  private batches: Array<{step: number, logs: UnresolvedLogs}> = [];
+
+  /** The number of batches whose logs haven't been read yet. */
+  get size(): number {
+    return this.batches.length;
+  }
+
+  /**
+   * Keeps the logs of a batch. Scalars are cloned, since the training loop
+   * disposes them after `onBatchEnd()`.
+   */
+  push(step: number, logs: UnresolvedLogs) {
+    const kept: UnresolvedLogs = {};
+    for (const key in logs) {
+      const value = logs[key];
+      kept[key] = typeof value === 'number' ? value : value.clone();
+    }
+    this.batches.push({step, logs: kept});
+  }
+
+  /** Discards the logs of all but the most recent batch. */
+  keepLatestOnly() {
+    const latest = this.batches.pop();
+    this.dispose();
+    if (latest != null) {
+      this.batches.push(latest);
+    }
+  }
+
+  /**
+   * Reads back the logs of all held batches, oldest first, and releases them.
+   *
+   * The batches are taken synchronously, so batches pushed while the read is
+   * in progress are left for the next call.
+   */
+  async read(): Promise<Array<{step: number, logs: Logs}>> {
+    const batches = this.batches;
+    this.batches = [];
+
+    const scalars: Tensor[] = [];
+    for (const batch of batches) {
+      for (const key in batch.logs) {
+        const value = batch.logs[key];
+        if (typeof value !== 'number') {
+          scalars.push(value);
+        }
+      }
+    }
+    let values: ArrayLike<number> = [];
+    if (scalars.length > 0) {
+      const flat =
+          tidy(() => concat(scalars.map(x => x.asType('float32').as1D())));
+      try {
+        values = await flat.data();
+      } finally {
+        flat.dispose();
+        scalars.forEach(x => x.dispose());
+      }
+    }
+
+    let i = 0;
+    return batches.map(batch => {
+      const logs: Logs = {};
+      for (const key in batch.logs) {
+        const value = batch.logs[key];
+        logs[key] = typeof value === 'number' ? value : values[i++];
+      }
+      return {step: batch.step, logs};
+    });
+  }
+
+  /** Releases the held logs without reading them. */
+  dispose() {
+    for (const batch of this.batches) {
+      for (const key in batch.logs) {
+        const value = batch.logs[key];
+        if (typeof value !== 'number') {
+          value.dispose();
+        }
+      }
+    }
+    this.batches = [];
+  }
+}
+
+export interface ProgbarLoggerArgs {
+  /**
+   * Whether per-batch logs are read back lazily.
+   *
+   * If `true`, the loss and metric values of a batch are not read back at the
+   * end of every batch. Instead, the most recent values are read back in the
+   * background at the rate at which the progress bar is rendered, and the
+   * progress bar shows values that may be one or more batches behind. This
+   * keeps the training loop from waiting on every batch.
+   *
+   * Default: `false`.
+   */
+  deferLogs?: boolean;
+}
+
 /**
  * Terminal-based progress bar callback for tf.Model.fit().
  */
@@ -44,10 +158,16 @@ export class ProgbarLogger extends CustomCallback {
 
   private readonly RENDER_THROTTLE_MS = 50;
 
+  private readonly deferLogs: boolean;
+  private deferredLogs: DeferredLogs;
+  private latestTickTokens: {placeholderForLossesAndMetrics: string};
+  private lastReadMillis: number;
+  private pendingRead: Promise<void>;
+
   /**
    * Construtor of LoggingCallback.
    */
-  constructor() {
+  constructor(args?: ProgbarLoggerArgs) {
     super({
       onTrainBegin: async (logs?: Logs) => {
         const samples = this.params.samples as number;
@@ -73,35 +193,23 @@ export class ProgbarLogger extends CustomCallback {
       onBatchEnd: async (batch: number, logs?: Logs) => {
         this.batchesInLatestEpoch++;
         if (batch === 0) {
-          this.progressBar = new progressBarHelper.ProgressBar(
-              'eta=:eta :bar :placeholderForLossesAndMetrics', {
-                width: Math.floor(0.5 * this.terminalWidth),
-                total: this.numTrainBatchesPerEpoch + 1,
-                head: `>`,
-                renderThrottle: this.RENDER_THROTTLE_MS
-              });
+          this.createProgressBar();
         }
-        const maxMetricsStringLength =
-            Math.floor(this.terminalWidth * 0.5 - 12);
-        const tickTokens = {
+        this.tick({
           placeholderForLossesAndMetrics:
-              this.formatLogsAsMetricsContent(logs, maxMetricsStringLength)
-        };
-        if (this.numTrainBatchesPerEpoch === 0) {
-          // Undetermined number of batches per epoch.
-          this.progressBar.tick(0, tickTokens);
-        } else {
-          this.progressBar.tick(tickTokens);
-        }
+              this.formatLogsAsMetricsContent(logs, this.maxMetricsLength())
+        });
         await nextFrame();
-        if (batch === this.numTrainBatchesPerEpoch - 1) {
-          this.epochDurationMillis = util.now() - this.currentEpochBegin;
-          this.usPerStep = this.params.samples != null ?
-              this.epochDurationMillis / (this.params.samples as number) * 1e3 :
-              this.epochDurationMillis / this.batchesInLatestEpoch * 1e3;
-        }
+        this.maybeUpdateStepDuration(batch);
       },
       onEpochEnd: async (epoch: number, logs?: Logs) => {
+        if (this.pendingRead != null) {
+          await this.pendingRead;
+          this.pendingRead = null;
+        }
+        if (this.deferredLogs != null) {
+          this.deferredLogs.dispose();
+        }
         if (this.epochDurationMillis == null) {
           // In cases where the number of batches per epoch is not determined,
           // the calculation of the per-step duration is done at the end of the
@@ -119,6 +227,86 @@ export class ProgbarLogger extends CustomCallback {
         await nextFrame();
       },
     });
+
+    this.deferLogs = args != null && !!args.deferLogs;
+    if (this.deferLogs) {
+      this.deferredLogs = new DeferredLogs();
+    }
+  }
+
+  async onBatchEnd(batch: number, logs?: UnresolvedLogs): Promise<void> {
+    if (!this.deferLogs) {
+      return super.onBatchEnd(batch, logs);
+    }
+
+    this.batchesInLatestEpoch++;
+    if (batch === 0) {
+      this.createProgressBar();
+      this.latestTickTokens = {placeholderForLossesAndMetrics: ''};
+      this.lastReadMillis = -Infinity;
+    }
+    this.deferredLogs.push(batch, logs);
+    this.deferredLogs.keepLatestOnly();
+
+    // Start a read of the latest logs at most once per render interval, and
+    // don't wait for it: the values are shown when the next batch ends.
+    const now = util.now();
+    if (this.pendingRead == null &&
+        now - this.lastReadMillis >= this.RENDER_THROTTLE_MS) {
+      this.lastReadMillis = now;
+      this.pendingRead = this.readLatestLogs(this.maxMetricsLength());
+    }
+    this.tick(this.latestTickTokens);
+    this.maybeUpdateStepDuration(batch);
+  }
+
+  // Reads the deferred logs into the tokens of the next tick. A failed read
+  // only skips this update of the progress bar: the bar keeps showing the
+  // previous values, and later batches start new reads.
+  private async readLatestLogs(maxMetricsLength: number): Promise<void> {
+    try {
+      const batches = await this.deferredLogs.read();
+      this.latestTickTokens = {
+        placeholderForLossesAndMetrics: this.formatLogsAsMetricsContent(
+            batches[batches.length - 1].logs, maxMetricsLength)
+      };
+    } catch (e) {
+      // Errors of the computation itself are reported by training.
+    } finally {
+      this.pendingRead = null;
+    }
+  }
+
+  private createProgressBar() {
+    this.progressBar = new progressBarHelper.ProgressBar(
+        'eta=:eta :bar :placeholderForLossesAndMetrics', {
+          width: Math.floor(0.5 * this.terminalWidth),
+          total: this.numTrainBatchesPerEpoch + 1,
+          head: `>`,
+          renderThrottle: this.RENDER_THROTTLE_MS
+        });
+  }
+
+  private maxMetricsLength(): number {
+    return Math.floor(this.terminalWidth * 0.5 - 12);
+  }
+
+  private tick(tickTokens: {placeholderForLossesAndMetrics: string}) {
+    if (this.numTrainBatchesPerEpoch === 0) {
+      // Undetermined number of batches per epoch.
+      this.progressBar.tick(0, tickTokens);
+    } else {
+      this.progressBar.tick(tickTokens);
+    }
+  }
+
+  private maybeUpdateStepDuration(batch: number) {
+    if (batch === this.numTrainBatchesPerEpoch - 1) {
+      this.epochDurationMillis = util.now() - this.currentEpochBegin;
+      this.usPerStep = this.params.samples != null ?
+          this.epochDurationMillis / (this.params.samples as number) * 1e3 :
+          this.epochDurationMillis / this.batchesInLatestEpoch * 1e3;
+    }
   }
 
   private formatLogsAsMetricsContent(
@@ -192,8 +380,36 @@ export interface TensorBoardCallbackArgs {
    * Default: 'epoch'.
    */
   updateFreq?: 'batch'|'epoch';
+
+  /**
+   * The frequency (in epochs) at which histograms of the model's weights are
+   * written to logs. If `0`, weight histograms are not written.
+   *
+   * The histograms are computed by TensorFlow; the weights are not read into
+   * JavaScript.
+   *
+   * Default: `0`.
+   */
+  histogramFreq?: number;
+
+  /**
+   * Whether per-batch logs are read back lazily.
+   *
+   * If `true`, the loss and metric values of batches are not read back at
+   * the end of every batch. With `updateFreq: 'batch'`, they are collected
+   * and read back together in the background about once per second (and at
+   * the end of every epoch), then written with their original steps. With
+   * `updateFreq: 'epoch'`, per-batch values are not read back at all. This
+   * keeps the training loop from waiting on every batch.
+   *
+   * Default: `false`.
+   */
+  deferLogs?: boolean;
 }
 
+// Interval at which TensorBoardCallback reads back deferred per-batch logs.
+const DEFERRED_LOGS_READ_INTERVAL_MS = 1000;
+
 /**
  * Callback for logging to TensorBoard durnig training.
  *
@@ -206,6 +422,10 @@ export class TensorBoardCallback extends CustomCallback {
   private batchesSeen: number;
   private epochsSeen: number;
   private readonly args: TensorBoardCallbackArgs;
+  private model: LayersModel = null;
+  private deferredLogs: DeferredLogs;
+  private lastReadMillis: number;
+  private pendingWrites: Promise<void> = Promise.resolve();
 
   constructor(readonly logdir = './logs', args?: TensorBoardCallbackArgs) {
     super({
@@ -216,10 +436,19 @@ export class TensorBoardCallback extends CustomCallback {
         }
       },
       onEpochEnd: async (epoch: number, logs?: Logs) => {
+        if (this.deferredLogs != null) {
+          this.readDeferredLogs();
+          await this.pendingWrites;
+        }
         this.epochsSeen++;
         this.logMetrics(logs, 'epoch_', this.epochsSeen);
+        if (this.args.histogramFreq > 0 &&
+            this.epochsSeen % this.args.histogramFreq === 0) {
+          this.logWeightHistograms(this.epochsSeen);
+        }
       },
       onTrainEnd: async (logs?: Logs) => {
+        await this.pendingWrites;
         if (this.trainWriter != null) {
           this.trainWriter.flush();
         }
@@ -237,11 +466,73 @@ export class TensorBoardCallback extends CustomCallback {
         ['batch', 'epoch'].indexOf(this.args.updateFreq) !== -1,
         () => `Expected updateFreq to be 'batch' or 'epoch', but got ` +
             `${this.args.updateFreq}`);
+    if (this.args.histogramFreq == null) {
+      this.args.histogramFreq = 0;
+    }
+    util.assert(
+        Number.isInteger(this.args.histogramFreq) &&
+            this.args.histogramFreq >= 0,
+        () => `Expected histogramFreq to be a non-negative integer, but got ` +
+            `${this.args.histogramFreq}`);
     this.batchesSeen = 0;
     this.epochsSeen = 0;
+    if (this.args.deferLogs) {
+      this.deferredLogs = new DeferredLogs();
+      this.lastReadMillis = util.now();
+    }
+  }
+
+  async onBatchEnd(batch: number, logs?: UnresolvedLogs): Promise<void> {
+    if (this.deferredLogs == null) {
+      return super.onBatchEnd(batch, logs);
+    }
+    this.batchesSeen++;
+    if (this.args.updateFreq === 'epoch') {
+      return;
+    }
+    this.deferredLogs.push(this.batchesSeen, logs);
+    if (util.now() - this.lastReadMillis >= DEFERRED_LOGS_READ_INTERVAL_MS) {
+      this.readDeferredLogs();
+    }
+  }
+
+  // Starts reading back the deferred logs, without waiting for it. Writes are
+  // chained so that the summaries are written in the order of their steps.
+  private readDeferredLogs() {
+    this.lastReadMillis = util.now();
+    if (this.deferredLogs.size === 0) {
+      return;
+    }
+    this.pendingWrites =
+        this.writeDeferredLogs(this.deferredLogs.read(), this.pendingWrites);
+  }
+
+  // Writes the read-back logs after `previousWrites`. A failed read or write
+  // only loses the summaries of these batches: it is logged, and neither
+  // training nor the writes of later batches are stopped. The returned
+  // promise never rejects.
+  private async writeDeferredLogs(
+      batches: Promise<Array<{step: number, logs: Logs}>>,
+      previousWrites: Promise<void>): Promise<void> {
+    try {
+      const resolvedBatches = await batches;
+      await previousWrites;
+      for (const batch of resolvedBatches) {
+        this.logMetrics(batch.logs, 'batch_', batch.step);
+      }
+    } catch (e) {
+      // Later writes still wait for the earlier ones.
+      await previousWrites;
+      console.warn(`Failed to write TensorBoard batch logs: ${e.message}`);
+    }
   }
 
   private logMetrics(logs: Logs, prefix: string, step: number) {
+    // Metrics are collected per writer and written with one bulk call each.
+    const trainScalars: {[name: string]: number} = {};
+    const valScalars: {[name: string]: number} = {};
+    let numTrainScalars = 0;
+    let numValScalars = 0;
     for (const key in logs) {
       if (key === 'batch' || key === 'size' || key === 'num_steps') {
         continue;
@@ -249,14 +540,35 @@ export class TensorBoardCallback extends CustomCallback {
 
       const VAL_PREFIX = 'val_';
       if (key.startsWith(VAL_PREFIX)) {
-        this.ensureValWriterCreated();
-        const scalarName = prefix + key.slice(VAL_PREFIX.length);
-        this.valWriter.scalar(scalarName, logs[key], step);
+        valScalars[prefix + key.slice(VAL_PREFIX.length)] = logs[key];
+        numValScalars++;
       } else {
-        this.ensureTrainWriterCreated();
-        this.trainWriter.scalar(`${prefix}${key}`, logs[key], step);
+        trainScalars[`${prefix}${key}`] = logs[key];
+        numTrainScalars++;
       }
     }
+    if (numTrainScalars > 0) {
+      this.ensureTrainWriterCreated();
+      this.trainWriter.scalars(trainScalars, step);
+    }
+    if (numValScalars > 0) {
+      this.ensureValWriterCreated();
+      this.valWriter.scalars(valScalars, step);
+    }
+  }
+
+  setModel(model: LayersModel) {
+    this.model = model;
+  }
+
+  private logWeightHistograms(step: number) {
+    if (this.model == null) {
+      return;
+    }
+    this.ensureTrainWriterCreated();
+    for (const weight of this.model.weights) {
+      this.trainWriter.histogram(weight.name, weight.read(), step);
+    }
   }
 
   private ensureTrainWriterCreated() {
@@ -326,3 +638,29 @@ export function tensorBoard(
     logdir = './logs', args?: TensorBoardCallbackArgs): TensorBoardCallback {
   return new TensorBoardCallback(logdir, args);
 }
+
+/**
+ * Terminal-based progress bar callback for `tf.Model.fit()`.
+ *
+ * `tf.Model.fit()` adds a progress bar by default when `verbose` is `1`. Use
+ * this factory with `verbose: 0` to configure the progress bar, e.g., to
+ * defer the readback of per-batch logs:
+ *
+ * ```js
+ * await model.fit(xs, ys, {
+ *   epochs: 10,
+ *   verbose: 0,
+ *   callbacks: tf.node.progbarLogger({deferLogs: true})
+ * });
+ * ```
+ *
+ * @param args Optional configuration arguments.
+ * @returns An instance of `ProgbarLogger`, which is a subclass of
+ *   `tf.CustomCallback`.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function progbarLogger(args?: ProgbarLoggerArgs): ProgbarLogger {
+  return new ProgbarLogger(args);
+}
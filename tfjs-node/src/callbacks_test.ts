@@ -18,7 +18,7 @@
 import * as tf from '@tensorflow/tfjs';
 
 // tslint:disable-next-line:max-line-length
-import {getDisplayDecimalPlaces, getSuccinctNumberDisplay, progressBarHelper} from './callbacks';
+import {DeferredLogs, getDisplayDecimalPlaces, getSuccinctNumberDisplay, ProgbarLogger, progressBarHelper} from './callbacks';
 
 describe('progbarLogger', () => {
   // Fake progbar class written for testing.
@@ -272,6 +272,105 @@ describe('progbarLogger', () => {
     expect(consoleMessages.length)
         .toEqual(0);  // No logging should have happened.
   });
+
+  it('Model.fit with deferLogs', async () => {
+    const fakeProgbars: FakeProgbar[] = [];
+    spyOn(progressBarHelper, 'ProgressBar')
+        .and.callFake((specs: string, config: {}) => {
+          const fakeProgbar = new FakeProgbar(specs, config);
+          fakeProgbars.push(fakeProgbar);
+          return fakeProgbar;
+        });
+    const consoleMessages: string[] = [];
+    spyOn(progressBarHelper, 'log').and.callFake((message: string) => {
+      consoleMessages.push(message);
+    });
+
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 1, inputShape: [8]}));
+    model.compile({loss: 'meanSquaredError', optimizer: 'sgd'});
+
+    const xs = tf.randomNormal([14, 8]);
+    const ys = tf.randomNormal([14, 1]);
+    await model.fit(xs, ys, {
+      epochs: 2,
+      batchSize: 8,
+      verbose: 0,
+      callbacks: new ProgbarLogger({deferLogs: true})
+    });
+
+    expect(fakeProgbars.length).toEqual(2);
+    for (const fakeProgbar of fakeProgbars) {
+      // One tick per batch, plus a tick at the end of the epoch.
+      expect(fakeProgbar.tickConfigs.length).toEqual(3);
+    }
+    expect(consoleMessages.length).toEqual(4);
+    expect(consoleMessages[1]).toMatch(/.*ms .*us\/step - loss=.*/);
+    expect(consoleMessages[3]).toMatch(/.*ms .*us\/step - loss=.*/);
+  });
+
+  it('Failed reads of deferred logs do not stop later reads', async () => {
+    spyOn(progressBarHelper, 'ProgressBar')
+        .and.callFake(
+            (specs: string, config: {}) => new FakeProgbar(specs, config));
+    spyOn(progressBarHelper, 'log');
+    const readSpy =
+        spyOn(DeferredLogs.prototype, 'read')
+            .and.callFake(() => Promise.reject(new Error('read failed')));
+
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 1, inputShape: [8]}));
+    model.compile({loss: 'meanSquaredError', optimizer: 'sgd'});
+    const progbarLogger = new ProgbarLogger({deferLogs: true});
+    // Start a read for every batch.
+    // tslint:disable-next-line:no-any
+    (progbarLogger as any).RENDER_THROTTLE_MS = 0;
+
+    await model.fit(tf.randomNormal([24, 8]), tf.randomNormal([24, 1]), {
+      epochs: 1,
+      batchSize: 8,
+      verbose: 0,
+      callbacks: progbarLogger
+    });
+    expect(readSpy).toHaveBeenCalledTimes(3);
+  });
+});
+
+describe('DeferredLogs', () => {
+  it('Reads the logs of several batches in order', async () => {
+    const deferredLogs = new DeferredLogs();
+    const numTensors0 = tf.memory().numTensors;
+    const loss0 = tf.scalar(0.5);
+    const loss1 = tf.scalar(0.25);
+    deferredLogs.push(1, {loss: loss0, size: 8});
+    deferredLogs.push(2, {loss: loss1, size: 6});
+    // The training loop disposes the logs after onBatchEnd().
+    loss0.dispose();
+    loss1.dispose();
+    expect(deferredLogs.size).toEqual(2);
+
+    const batches = await deferredLogs.read();
+    expect(batches).toEqual([
+      {step: 1, logs: {loss: 0.5, size: 8}},
+      {step: 2, logs: {loss: 0.25, size: 6}}
+    ]);
+    expect(deferredLogs.size).toEqual(0);
+    expect(tf.memory().numTensors).toEqual(numTensors0);
+  });
+
+  it('keepLatestOnly() releases older batches', async () => {
+    const deferredLogs = new DeferredLogs();
+    const numTensors0 = tf.memory().numTensors;
+    deferredLogs.push(1, {loss: tf.scalar(1)});
+    deferredLogs.push(2, {loss: tf.scalar(2)});
+    deferredLogs.keepLatestOnly();
+    expect(deferredLogs.size).toEqual(1);
+
+    const batches = await deferredLogs.read();
+    expect(batches).toEqual([{step: 2, logs: {loss: 2}}]);
+    // Only the pushed originals remain.
+    expect(tf.memory().numTensors).toEqual(numTensors0 + 2);
+  });
 });
 
 describe('getSuccinctNumberDisplay', () => {
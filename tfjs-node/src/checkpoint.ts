@@ -0,0 +1,121 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {io, LayersModel, Tensor} from '@tensorflow/tfjs';
+import {resolve} from 'path';
+
+// tslint:disable-next-line:max-line-length
+import {FileSystemSaveOptions, NodeFileSystem, WeightSource} from './io/file_system';
+import {getModelArtifactsInfoForJSON} from './io/io_utils';
+
+/** Checkpoints in progress, keyed by their directory. */
+const pendingCheckpoints: {[path: string]: Promise<void>} = {};
+
+function bytesPerElement(tensor: Tensor): number {
+  return tensor.dtype === 'bool' ? 1 : 4;
+}
+
+/**
+ * Save the topology and weights of a model while training continues.
+ *
+ * The weights are snapshotted when this function is called: the snapshot
+ * shares the memory of the current weight values, so no copy is made, and
+ * later updates of the weights (e.g., by `model.fit()`) do not affect it.
+ * The snapshot is then written in the background, one weight at a time,
+ * without concatenating the weights into a single buffer. Weights can be
+ * split over several files with `shardSizeBytes`.
+ *
+ * The directory is updated atomically: `model.json` is replaced only after
+ * all weight files are complete. Checkpoints to the same directory are
+ * written one after the other. The result can be loaded with
+ * `tf.loadLayersModel('file://<path>/model.json')`.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * await model.fit(xs, ys, {
+ *   epochs: 100,
+ *   callbacks: {
+ *     // Not awaited, so training is not blocked by the write.
+ *     onEpochEnd: () => {
+ *       tf.node.saveCheckpoint(model, '/tmp/checkpoint');
+ *     }
+ *   }
+ * });
+ * ```
+ *
+ * @param model The model to save.
+ * @param path The directory to save to. It is created if it does not exist.
+ * @param options Optional configuration, e.g., the maximum size of a weight
+ *   file.
+ * @returns A promise that resolves when the checkpoint is written.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function saveCheckpoint(
+    model: LayersModel, path: string,
+    options?: FileSystemSaveOptions): Promise<io.SaveResult> {
+  // Everything that the checkpoint contains is captured synchronously.
+  const modelJSON = {modelTopology: model.toJSON(null, false)};
+  const weightSpecs: io.WeightsManifestEntry[] = [];
+  const snapshot: Tensor[] = [];
+  for (const weight of model.weights) {
+    const value = weight.read().clone();
+    weightSpecs.push(
+        {name: weight.originalName, shape: value.shape, dtype: value.dtype});
+    snapshot.push(value);
+  }
+
+  const sources: WeightSource[] = snapshot.map(value => ({
+    byteLength: value.size * bytesPerElement(value),
+    read: async () => {
+      const values = await value.data();
+      value.dispose();
+      return new Uint8Array(
+          values.buffer, values.byteOffset, values.byteLength);
+    }
+  }));
+
+  const directory = resolve(path);
+  const previous = pendingCheckpoints[directory] || Promise.resolve();
+  const checkpoint = previous.then(async () => {
+    try {
+      await new NodeFileSystem(directory, options)
+          .saveWeightSources(modelJSON, weightSpecs, sources);
+    } finally {
+      snapshot.forEach(value => value.dispose());
+    }
+  });
+  const done = checkpoint.then(() => {}, () => {});
+  pendingCheckpoints[directory] = done;
+  done.then(() => {
+    if (pendingCheckpoints[directory] === done) {
+      delete pendingCheckpoints[directory];
+    }
+  });
+
+  return checkpoint.then(() => {
+    const modelArtifactsInfo = getModelArtifactsInfoForJSON(
+        {modelTopology: modelJSON.modelTopology, weightSpecs});
+    modelArtifactsInfo.weightDataBytes =
+        sources.reduce((sum, source) => sum + source.byteLength, 0);
+    // tslint:disable-next-line:no-any
+    return {modelArtifactsInfo: modelArtifactsInfo as any};
+  });
+}
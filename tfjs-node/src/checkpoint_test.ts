@@ -0,0 +1,101 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as rimraf from 'rimraf';
+import {promisify} from 'util';
+
+import * as tf from './index';
+
+describe('saveCheckpoint', () => {
+  const mkdtemp = promisify(fs.mkdtemp);
+  const rimrafPromise = promisify(rimraf);
+
+  let testDir: string;
+  let model: tf.Sequential;
+
+  beforeEach(async () => {
+    testDir = await mkdtemp('tfjs_node_checkpoint_test');
+    model = tf.sequential();
+    model.add(tf.layers.dense({units: 4, inputShape: [3]}));
+    model.add(tf.layers.dense({units: 1}));
+  });
+
+  afterEach(async () => {
+    await rimrafPromise(testDir);
+  });
+
+  it('Save-load round trip', async () => {
+    const saveResult = await tf.node.saveCheckpoint(model, testDir);
+    expect(saveResult.modelArtifactsInfo.weightDataBytes)
+        .toEqual((3 * 4 + 4 + 4 * 1 + 1) * 4);
+
+    const loaded = await tf.loadLayersModel(
+        `file://${path.join(testDir, 'model.json')}`);
+    const x = tf.ones([2, 3]);
+    tf.test_util.expectArraysClose(
+        await (loaded.predict(x) as tf.Tensor).data(),
+        await (model.predict(x) as tf.Tensor).data());
+  });
+
+  it('Snapshots the weights when called', async () => {
+    const before = model.getWeights().map(w => w.dataSync().slice());
+    const checkpoint = tf.node.saveCheckpoint(model, testDir);
+    // Weight updates after the call are not part of the checkpoint.
+    model.setWeights(model.getWeights().map(w => tf.onesLike(w)));
+    await checkpoint;
+
+    const loaded = await tf.loadLayersModel(
+        `file://${path.join(testDir, 'model.json')}`);
+    const after = loaded.getWeights().map(w => w.dataSync());
+    for (let i = 0; i < before.length; ++i) {
+      tf.test_util.expectArraysClose(after[i], before[i]);
+    }
+  });
+
+  it('Writes sharded weight files', async () => {
+    await tf.node.saveCheckpoint(model, testDir, {shardSizeBytes: 32});
+    const modelJSON = JSON.parse(
+        fs.readFileSync(path.join(testDir, 'model.json'), 'utf8'));
+    // 21 weights of 4 bytes.
+    expect(modelJSON.weightsManifest[0].paths.length).toEqual(3);
+    const loaded = await tf.loadLayersModel(
+        `file://${path.join(testDir, 'model.json')}`);
+    expect(loaded.getWeights().length).toEqual(4);
+  });
+
+  it('Consecutive checkpoints to one directory keep the last one', async () => {
+    const first = tf.node.saveCheckpoint(model, testDir);
+    model.setWeights(model.getWeights().map(w => tf.onesLike(w)));
+    const second = tf.node.saveCheckpoint(model, testDir);
+    await Promise.all([first, second]);
+
+    const loaded = await tf.loadLayersModel(
+        `file://${path.join(testDir, 'model.json')}`);
+    for (const weight of loaded.getWeights()) {
+      tf.test_util.expectArraysClose(
+          await weight.data(), await tf.onesLike(weight).data());
+    }
+  });
+
+  it('Does not leak tensors', async () => {
+    const numTensors = tf.memory().numTensors;
+    await tf.node.saveCheckpoint(model, testDir);
+    expect(tf.memory().numTensors).toEqual(numTensors);
+  });
+});
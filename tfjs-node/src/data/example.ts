@@ -0,0 +1,149 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+/**
+ * A minimal encoder for `tf.Example` protocol buffers, so that TFRecord files
+ * of examples can be written without a protobuf dependency.
+ */
+
+/** The value of a single `tf.Example` feature. */
+export type ExampleFeature = {
+  bytesList: Array<Uint8Array|string>
+}|{floatList: number[] | Float32Array}|{int64List: number[] | Int32Array};
+
+// Protobuf wire types.
+const WIRE_TYPE_VARINT = 0;
+const WIRE_TYPE_LENGTH_DELIMITED = 2;
+
+const TWO_POW_32 = 4294967296;
+
+class ProtoWriter {
+  private readonly bytes: number[] = [];
+
+  writeVarint(value: number) {
+    while (value > 0x7f) {
+      this.bytes.push((value % 128) | 0x80);
+      value = Math.floor(value / 128);
+    }
+    this.bytes.push(value);
+  }
+
+  // Writes a (possibly negative) integer as a 64-bit two's complement varint.
+  writeInt64(value: number) {
+    if (value >= 0) {
+      this.writeVarint(value);
+      return;
+    }
+    let hi = (Math.floor(value / TWO_POW_32) >>> 0);
+    let lo = (value - Math.floor(value / TWO_POW_32) * TWO_POW_32) >>> 0;
+    while (hi > 0 || lo > 0x7f) {
+      this.bytes.push((lo & 0x7f) | 0x80);
+      lo = ((lo >>> 7) | (hi << 25)) >>> 0;
+      hi = hi >>> 7;
+    }
+    this.bytes.push(lo);
+  }
+
+  writeTag(fieldNumber: number, wireType: number) {
+    this.writeVarint(fieldNumber * 8 + wireType);
+  }
+
+  writeBytes(fieldNumber: number, bytes: Uint8Array|number[]) {
+    this.writeTag(fieldNumber, WIRE_TYPE_LENGTH_DELIMITED);
+    this.writeVarint(bytes.length);
+    for (let i = 0; i < bytes.length; ++i) {
+      this.bytes.push(bytes[i]);
+    }
+  }
+
+  writeMessage(fieldNumber: number, message: ProtoWriter) {
+    this.writeBytes(fieldNumber, message.bytes);
+  }
+
+  finish(): Uint8Array {
+    return new Uint8Array(this.bytes);
+  }
+}
+
+function encodeFeature(feature: ExampleFeature): ProtoWriter {
+  const list = new ProtoWriter();
+  const featureWriter = new ProtoWriter();
+  if ('bytesList' in feature) {
+    // message BytesList { repeated bytes value = 1; }
+    for (const value of feature.bytesList) {
+      list.writeBytes(
+          1, typeof value === 'string' ? Buffer.from(value, 'utf8') : value);
+    }
+    // message Feature { oneof kind { BytesList bytes_list = 1; ... } }
+    featureWriter.writeMessage(1, list);
+  } else if ('floatList' in feature) {
+    // message FloatList { repeated float value = 1 [packed = true]; }
+    const floats = new Float32Array(feature.floatList);
+    list.writeBytes(1, new Uint8Array(floats.buffer));
+    featureWriter.writeMessage(2, list);
+  } else if ('int64List' in feature) {
+    // message Int64List { repeated int64 value = 1 [packed = true]; }
+    const packed = new ProtoWriter();
+    for (let i = 0; i < feature.int64List.length; ++i) {
+      packed.writeInt64(feature.int64List[i]);
+    }
+    list.writeMessage(1, packed);
+    featureWriter.writeMessage(3, list);
+  } else {
+    throw new Error(
+        'Expected a feature with one of bytesList, floatList or int64List');
+  }
+  return featureWriter;
+}
+
+/**
+ * Serialize a `tf.Example` protocol buffer.
+ *
+ * The result can be written to a TFRecord file with
+ * `tf.node.data.writeTFRecords()` and parsed back with the `features` option
+ * of `tf.node.data.tfRecordDataset()`.
+ *
+ * Example:
+ * ```js
+ * const example = tf.node.data.encodeExample({
+ *   label: {int64List: [1]},
+ *   pixels: {floatList: [0.1, 0.2, 0.3]},
+ *   name: {bytesList: ['cat']}
+ * });
+ * ```
+ *
+ * @param features A map from feature names to feature values.
+ * @returns The serialized `tf.Example`.
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function encodeExample(features: {[name: string]: ExampleFeature}):
+    Uint8Array {
+  // message Features { map<string, Feature> feature = 1; }
+  const featuresWriter = new ProtoWriter();
+  for (const name of Object.keys(features).sort()) {
+    const entry = new ProtoWriter();
+    entry.writeBytes(1, Buffer.from(name, 'utf8'));
+    entry.writeMessage(2, encodeFeature(features[name]));
+    featuresWriter.writeMessage(1, entry);
+  }
+  // message Example { Features features = 1; }
+  const example = new ProtoWriter();
+  example.writeMessage(1, featuresWriter);
+  return example.finish();
+}
@@ -0,0 +1,447 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {data, fill, Tensor, Tensor1D, TensorContainer, tensor1d, tidy, util} from '@tensorflow/tfjs';
+import * as fs from 'fs';
+import {ensureTensorflowBackend, getTFDType, nodeBackend} from '../ops/op_utils';
+
+/** Compression of a TFRecord file. `''` means no compression. */
+export type CompressionType = ''|'ZLIB'|'GZIP';
+
+/** Specification of a dense `tf.Example` feature. */
+export interface FeatureSpec {
+  /**
+   * The dtype of the parsed feature: `'float32'` for a `float_list`,
+   * `'int32'` for an `int64_list` (values are cast to int32) and `'string'`
+   * for a `bytes_list`.
+   */
+  dtype: 'float32'|'int32'|'string';
+
+  /**
+   * The fixed shape of the feature in a single example.
+   *
+   * Default: `[]` (a scalar).
+   */
+  shape?: number[];
+
+  /**
+   * Value used for examples that don't contain the feature. If not specified,
+   * the feature is required.
+   */
+  defaultValue?: number|string;
+}
+
+export interface RecordDatasetArgs {
+  /**
+   * Number of bytes in the read buffer of each file. `0` uses TensorFlow's
+   * default.
+   *
+   * Default: `0`.
+   */
+  bufferSize?: number;
+
+  /**
+   * If set, records are shuffled with a buffer of this many records.
+   */
+  shuffleBufferSize?: number;
+
+  /**
+   * Random seed of the shuffle. If not set, the shuffle order is
+   * nondeterministic.
+   */
+  seed?: number;
+
+  /**
+   * If set, consecutive records are combined into batches of this size.
+   */
+  batchSize?: number;
+
+  /**
+   * Whether the last batch is dropped when it has fewer than `batchSize`
+   * records.
+   *
+   * Default: `false`.
+   */
+  dropRemainder?: boolean;
+
+  /**
+   * Number of elements (records or batches) that are prepared ahead of time
+   * on background threads.
+   *
+   * Default: `2`.
+   */
+  prefetch?: number;
+
+  /**
+   * If set, records are parsed as `tf.Example` protos and each dataset
+   * element is an object that maps feature names to Tensors. Otherwise each
+   * element is a `string` Tensor of raw records.
+   */
+  features?: {[name: string]: FeatureSpec};
+}
+
+export interface TFRecordDatasetArgs extends RecordDatasetArgs {
+  /**
+   * Compression of the TFRecord files.
+   *
+   * Default: `''` (no compression).
+   */
+  compressionType?: CompressionType;
+}
+
+export interface FixedLengthRecordDatasetArgs extends RecordDatasetArgs {
+  /** Number of bytes to skip at the start of each file. Default: `0`. */
+  headerBytes?: number;
+
+  /** Number of bytes to ignore at the end of each file. Default: `0`. */
+  footerBytes?: number;
+}
+
+/**
+ * Iterates over a native TensorFlow dataset.
+ *
+ * Reading, shuffling, batching, `tf.Example` parsing and prefetching run on
+ * TensorFlow's threads; each `next()` call takes one ready-made element.
+ */
+class NativeDatasetIterator implements Iterator<TensorContainer> {
+  private iterator: Tensor;
+  private readonly featureNames: string[];
+  private readonly outputTypes: number[];
+  private readonly outputShapes: number[][];
+
+  constructor(createDataset: () => Tensor, args: RecordDatasetArgs) {
+    const backend = nodeBackend();
+    const batchSize = args.batchSize;
+    const features = args.features;
+    const recordTypes = [backend.binding.TF_STRING];
+    const recordShapes: number[][] = [[]];
+    // `tf.Example` parsing works on batches, so single records are parsed as
+    // batches of one and unbatched afterwards.
+    const batchDim =
+        batchSize == null ? 1 : (args.dropRemainder ? batchSize : -1);
+    const batchShapes = [[batchDim]];
+
+    let featureShapes: number[][];
+    let parsedShapes: number[][];
+    if (features == null) {
+      this.featureNames = null;
+      this.outputTypes = recordTypes;
+      this.outputShapes = batchSize == null ? recordShapes : batchShapes;
+    } else {
+      this.featureNames = Object.keys(features).sort();
+      featureShapes = this.featureNames.map(
+          name => features[name].shape == null ? [] : features[name].shape);
+      parsedShapes = featureShapes.map(shape => [batchDim, ...shape]);
+      // int32 features are int64 in the dataset, see `parseExampleDataset()`.
+      this.outputTypes = this.featureNames.map(
+          name => features[name].dtype === 'int32' ?
+              backend.binding.TF_INT64 :
+              getTFDType(features[name].dtype));
+      this.outputShapes = batchSize == null ? featureShapes : parsedShapes;
+    }
+
+    this.iterator = tidy(() => {
+      let dataset = createDataset();
+      if (args.shuffleBufferSize != null) {
+        const seed = args.seed == null ? 0 : args.seed;
+        dataset = backend.shuffleDataset(
+            dataset, args.shuffleBufferSize, seed, 0, recordTypes,
+            recordShapes);
+      }
+      if (batchSize != null || features != null) {
+        dataset = backend.batchDataset(
+            dataset, batchSize == null ? 1 : batchSize,
+            batchSize == null || !!args.dropRemainder, recordTypes,
+            batchShapes);
+      }
+      if (features != null) {
+        dataset = backend.parseExampleDataset(
+            dataset, this.featureNames,
+            createDenseDefaults(this.featureNames, features, featureShapes),
+            featureShapes, parsedShapes);
+        if (batchSize == null) {
+          dataset = backend.unbatchDataset(
+              dataset, this.outputTypes, this.outputShapes);
+        }
+      }
+      dataset = backend.prefetchDataset(
+          dataset, args.prefetch == null ? 2 : args.prefetch,
+          this.outputTypes, this.outputShapes);
+
+      const iterator =
+          backend.anonymousIterator(this.outputTypes, this.outputShapes);
+      backend.makeIterator(dataset, iterator);
+      return iterator;
+    });
+  }
+
+  next(): IteratorResult<TensorContainer> {
+    if (this.iterator == null) {
+      return {value: null, done: true};
+    }
+    const outputs = nodeBackend().iteratorGetNext(
+        this.iterator, this.outputTypes, this.outputShapes);
+    if (outputs == null) {
+      return this.return();
+    }
+    if (this.featureNames == null) {
+      return {value: outputs[0], done: false};
+    }
+    const value: {[name: string]: Tensor} = {};
+    this.featureNames.forEach((name, i) => value[name] = outputs[i]);
+    return {value, done: false};
+  }
+
+  /**
+   * Releases the native iterator with its open files and prefetch buffers.
+   * Later `next()` calls report the end of the iteration.
+   */
+  return(): IteratorResult<TensorContainer> {
+    if (this.iterator != null) {
+      nodeBackend().destroyResource(this.iterator);
+      this.iterator.dispose();
+      this.iterator = null;
+    }
+    return {value: null, done: true};
+  }
+}
+
+/**
+ * Creates a `tf.data.Dataset` over native iterators of the dataset that
+ * `createDataset` returns.
+ *
+ * tfjs-data has no hook to release an iterator that is not iterated to the
+ * end, e.g., after `take()`, a `break` out of `forEachAsync()` or a
+ * `fitDataset()` with `batchesPerEpoch`. The dataset therefore keeps one
+ * native iterator at a time: starting a new iteration releases the previous
+ * iterator.
+ */
+function createNativeDataset(
+    createDataset: () => Tensor,
+    args: RecordDatasetArgs): data.Dataset<TensorContainer> {
+  let current: NativeDatasetIterator = null;
+  return data.generator(() => {
+    if (current != null) {
+      current.return();
+    }
+    current = new NativeDatasetIterator(createDataset, args);
+    return current;
+  });
+}
+
+// Creates the default value of each dense feature, as the `ParseExample`
+// kernels expect them.
+function createDenseDefaults(
+    names: string[], features: {[name: string]: FeatureSpec},
+    shapes: number[][]): Tensor[] {
+  return names.map((name, i) => {
+    const spec = features[name];
+    // An empty default marks a required feature.
+    return spec.defaultValue == null ?
+        tensor1d([], spec.dtype) :
+        fill(shapes[i], spec.defaultValue, spec.dtype);
+  });
+}
+
+function validateDatasetArgs(
+    filenames: string|string[], args: RecordDatasetArgs): string[] {
+  ensureTensorflowBackend();
+  filenames = Array.isArray(filenames) ? filenames : [filenames];
+  util.assert(
+      filenames.length > 0, () => 'Expected at least one file to read from');
+  for (const key of ['batchSize', 'shuffleBufferSize', 'prefetch'] as
+       Array<keyof RecordDatasetArgs>) {
+    const value = args[key] as number;
+    util.assert(
+        value == null || (Number.isInteger(value) && value > 0),
+        () => `Expected ${key} to be a positive integer, but got ${value}`);
+  }
+  return filenames;
+}
+
+/**
+ * Parse a batch of serialized `tf.Example` protos into dense Tensors.
+ *
+ * Parsing runs in TensorFlow's `ParseExample` kernel.
+ *
+ * @param serialized A 1D `string` Tensor of serialized `tf.Example` protos.
+ * @param features The features to parse.
+ * @returns An object that maps each feature name to a Tensor of shape
+ *   `[batchSize, ...feature.shape]`.
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function parseExample(
+    serialized: Tensor1D,
+    features: {[name: string]: FeatureSpec}): {[name: string]: Tensor} {
+  ensureTensorflowBackend();
+  util.assert(
+      serialized.dtype === 'string' && serialized.rank === 1,
+      () => `Expected serialized to be a 1D string Tensor, but got a ` +
+          `${serialized.rank}D ${serialized.dtype} Tensor`);
+  const names = Object.keys(features).sort();
+  util.assert(names.length > 0, () => 'Expected at least one feature');
+
+  return tidy(() => {
+    const shapes = names.map(
+        name => features[name].shape == null ? [] : features[name].shape);
+    const defaults = createDenseDefaults(names, features, shapes);
+    const outputs =
+        nodeBackend().parseExample(serialized, names, defaults, shapes);
+    const result: {[name: string]: Tensor} = {};
+    names.forEach((name, i) => result[name] = outputs[i]);
+    return result;
+  });
+}
+
+/**
+ * Create a `tf.data.Dataset` that reads TFRecord files natively.
+ *
+ * Reading, CRC checking, shuffling, batching, `tf.Example` parsing (if
+ * `features` is specified) and prefetching run on TensorFlow's background
+ * threads. The dataset can be passed directly to `model.fitDataset()`.
+ *
+ * The dataset holds native resources (open files and prefetch buffers) for
+ * one iteration at a time. Starting a new iteration, e.g., the next epoch,
+ * releases those of the previous iteration, even if it did not reach the
+ * end, so the dataset can't be iterated twice concurrently.
+ *
+ * Example:
+ * ```js
+ * const ds = tf.node.data.tfRecordDataset('/tmp/train.tfrecord', {
+ *   features: {
+ *     x: {dtype: 'float32', shape: [784]},
+ *     y: {dtype: 'int32', shape: [], defaultValue: 0}
+ *   },
+ *   shuffleBufferSize: 1000,
+ *   batchSize: 32
+ * }).map(({x, y}) => ({xs: x, ys: tf.oneHot(y, 10)}));
+ *
+ * await model.fitDataset(ds, {epochs: 5});
+ * ```
+ *
+ * @param filenames The path (or paths) of the TFRecord files.
+ * @param args Optional configuration arguments.
+ * @returns A `tf.data.Dataset`. Its elements are `string` Tensors of raw
+ *   records, or objects of Tensors if `features` is specified. Elements are
+ *   scalars (or `[batchSize]` Tensors if `batchSize` is specified).
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function tfRecordDataset(
+    filenames: string|string[],
+    args: TFRecordDatasetArgs = {}): data.Dataset<TensorContainer> {
+  const files = validateDatasetArgs(filenames, args);
+  const compressionType =
+      args.compressionType == null ? '' : args.compressionType;
+  const bufferSize = args.bufferSize == null ? 0 : args.bufferSize;
+  return createNativeDataset(
+      () => nodeBackend().tfRecordDataset(files, compressionType, bufferSize),
+      args);
+}
+
+/**
+ * Create a `tf.data.Dataset` that reads records of a fixed number of bytes
+ * natively.
+ *
+ * See `tf.node.data.tfRecordDataset()` for the pipeline options.
+ *
+ * @param filenames The path (or paths) of the files.
+ * @param recordBytes The number of bytes of each record.
+ * @param args Optional configuration arguments.
+ * @returns A `tf.data.Dataset` of `string` Tensors of raw records.
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function fixedLengthRecordDataset(
+    filenames: string|string[], recordBytes: number,
+    args: FixedLengthRecordDatasetArgs = {}): data.Dataset<TensorContainer> {
+  const files = validateDatasetArgs(filenames, args);
+  util.assert(
+      Number.isInteger(recordBytes) && recordBytes > 0,
+      () => `Expected recordBytes to be a positive integer, but got ` +
+          `${recordBytes}`);
+  const headerBytes = args.headerBytes == null ? 0 : args.headerBytes;
+  const footerBytes = args.footerBytes == null ? 0 : args.footerBytes;
+  const bufferSize = args.bufferSize == null ? 0 : args.bufferSize;
+  return createNativeDataset(
+      () => nodeBackend().fixedLengthRecordDataset(
+          files, headerBytes, recordBytes, footerBytes, bufferSize),
+      args);
+}
+
+/**
+ * Write records to a TFRecord file.
+ *
+ * The records are framed and checksummed by TensorFlow's TFRecord writer.
+ *
+ * @param filename The path of the file to write.
+ * @param records The records, e.g., from `tf.node.data.encodeExample()`.
+ *   Strings are written as UTF-8.
+ * @param compressionType Compression of the file. Default: `''` (none).
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function writeTFRecords(
+    filename: string, records: Array<Uint8Array|string>,
+    compressionType: CompressionType = '') {
+  ensureTensorflowBackend();
+  const bytes =
+      records.map(r => typeof r === 'string' ? Buffer.from(r, 'utf8') : r);
+  tidy(() => {
+    const backend = nodeBackend();
+    const dataset = backend.tensorSliceDataset([tensor1d(bytes, 'string')]);
+    backend.datasetToTFRecord(dataset, filename, compressionType);
+  });
+}
+
+/**
+ * Write records of a fixed number of bytes to a file, to be read back with
+ * `tf.node.data.fixedLengthRecordDataset()`.
+ *
+ * @param filename The path of the file to write.
+ * @param records The records. They must all have the same length.
+ * @param header Optional bytes to write before the records.
+ * @param footer Optional bytes to write after the records.
+ */
+/**
+ * @doc {heading: 'Data', namespace: 'node'}
+ */
+export function writeFixedLengthRecords(
+    filename: string, records: Uint8Array[], header?: Uint8Array,
+    footer?: Uint8Array) {
+  for (const record of records) {
+    util.assert(
+        record.length === records[0].length,
+        () => `Expected all records to have ${records[0].length} bytes, ` +
+            `but got a record of ${record.length} bytes`);
+  }
+  const chunks: Uint8Array[] = [];
+  if (header != null) {
+    chunks.push(header);
+  }
+  chunks.push(...records);
+  if (footer != null) {
+    chunks.push(footer);
+  }
+  fs.writeFileSync(filename, Buffer.concat(chunks));
+}
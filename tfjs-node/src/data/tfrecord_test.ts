@@ -0,0 +1,241 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import {promisify} from 'util';
+
+import * as tf from '../index';
+import {nodeBackend} from '../ops/op_utils';
+
+// tslint:disable-next-line:no-require-imports
+const rimraf = require('rimraf');
+// tslint:disable-next-line:no-require-imports
+const tmp = require('tmp');
+
+const rimrafPromise = promisify(rimraf);
+
+describe('tf.node.data', () => {
+  let tmpDir: string;
+
+  beforeEach(() => {
+    tmpDir = tmp.dirSync().name;
+  });
+
+  afterEach(async () => {
+    if (tmpDir != null) {
+      await rimrafPromise(tmpDir);
+    }
+  });
+
+  function writeExamples(filename: string, numExamples: number) {
+    const records: Uint8Array[] = [];
+    for (let i = 0; i < numExamples; ++i) {
+      records.push(tf.node.data.encodeExample({
+        x: {floatList: [i, i + 0.5]},
+        y: {int64List: [i - 2]},
+        name: {bytesList: [`example${i}`]}
+      }));
+    }
+    tf.node.data.writeTFRecords(filename, records);
+  }
+
+  it('Write and read raw TFRecords', async () => {
+    const filename = path.join(tmpDir, 'raw.tfrecord');
+    tf.node.data.writeTFRecords(filename, ['foo', 'bar', 'baz']);
+    expect(fs.existsSync(filename)).toEqual(true);
+
+    const records = await tf.node.data.tfRecordDataset(filename).toArray();
+    expect(records.length).toEqual(3);
+    const values = records.map(r => (r as tf.Tensor).dataSync()[0]);
+    expect(values.map(v => Buffer.from(v as Uint8Array).toString()))
+        .toEqual(['foo', 'bar', 'baz']);
+  });
+
+  it('Write and read GZIP-compressed TFRecords', async () => {
+    const filename = path.join(tmpDir, 'compressed.tfrecord.gz');
+    tf.node.data.writeTFRecords(filename, ['foo', 'bar'], 'GZIP');
+    const records = await tf.node.data
+                        .tfRecordDataset(filename, {compressionType: 'GZIP'})
+                        .toArray();
+    expect(records.length).toEqual(2);
+  });
+
+  it('Batched records', async () => {
+    const filename = path.join(tmpDir, 'batched.tfrecord');
+    tf.node.data.writeTFRecords(filename, ['a', 'b', 'c', 'd', 'e']);
+
+    const batches =
+        await tf.node.data.tfRecordDataset(filename, {batchSize: 2}).toArray();
+    expect(batches.map(b => (b as tf.Tensor).shape)).toEqual([[2], [2], [1]]);
+
+    const fullBatches = await tf.node.data
+                            .tfRecordDataset(
+                                filename, {batchSize: 2, dropRemainder: true})
+                            .toArray();
+    expect(fullBatches.length).toEqual(2);
+  });
+
+  it('Parse tf.Example features', async () => {
+    const filename = path.join(tmpDir, 'examples.tfrecord');
+    writeExamples(filename, 3);
+
+    const ds = tf.node.data.tfRecordDataset(filename, {
+      features: {
+        x: {dtype: 'float32', shape: [2]},
+        y: {dtype: 'int32'},
+        name: {dtype: 'string'}
+      }
+    });
+    const elements = await ds.toArray() as Array<{[name: string]: tf.Tensor}>;
+    expect(elements.length).toEqual(3);
+    expect(elements[1].x.shape).toEqual([2]);
+    tf.test_util.expectArraysClose(await elements[1].x.data(), [1, 1.5]);
+    expect(elements[1].y.dtype).toEqual('int32');
+    expect(elements[1].y.shape).toEqual([]);
+    expect(Array.from(await elements[0].y.data())).toEqual([-2]);
+    expect(Buffer.from(elements[2].name.dataSync()[0] as Uint8Array)
+               .toString())
+        .toEqual('example2');
+  });
+
+  it('Parse batched tf.Example features with default values', async () => {
+    const filename = path.join(tmpDir, 'examples.tfrecord');
+    writeExamples(filename, 4);
+
+    const ds = tf.node.data.tfRecordDataset(filename, {
+      batchSize: 4,
+      features: {
+        y: {dtype: 'int32'},
+        missing: {dtype: 'float32', shape: [3], defaultValue: 7}
+      }
+    });
+    const [batch] =
+        await ds.toArray() as Array<{[name: string]: tf.Tensor}>;
+    expect(batch.y.shape).toEqual([4]);
+    expect(Array.from(await batch.y.data())).toEqual([-2, -1, 0, 1]);
+    expect(batch.missing.shape).toEqual([4, 3]);
+    tf.test_util.expectArraysClose(
+        await batch.missing.data(), new Array(12).fill(7));
+  });
+
+  it('Parses tf.Example features in the native pipeline', async () => {
+    const filename = path.join(tmpDir, 'examples.tfrecord');
+    writeExamples(filename, 5);
+    const backend = nodeBackend();
+    const parseSpy = spyOn(backend, 'parseExample').and.callThrough();
+    const parseDatasetSpy =
+        spyOn(backend, 'parseExampleDataset').and.callThrough();
+
+    const ds = tf.node.data.tfRecordDataset(
+        filename, {batchSize: 2, features: {y: {dtype: 'int32'}}});
+    const batches = await ds.toArray() as Array<{[name: string]: tf.Tensor}>;
+    expect(batches.map(batch => batch.y.shape)).toEqual([[2], [2], [1]]);
+    expect(Array.from(await batches[2].y.data())).toEqual([2]);
+    expect(parseDatasetSpy).toHaveBeenCalledTimes(1);
+    expect(parseSpy).not.toHaveBeenCalled();
+  });
+
+  it('Missing required feature throws', async () => {
+    const filename = path.join(tmpDir, 'examples.tfrecord');
+    writeExamples(filename, 1);
+
+    const ds = tf.node.data.tfRecordDataset(
+        filename, {features: {missing: {dtype: 'float32'}}});
+    let error: Error;
+    try {
+      await ds.toArray();
+    } catch (e) {
+      error = e;
+    }
+    expect(error).toBeDefined();
+  });
+
+  it('Shuffle with a seed is deterministic', async () => {
+    const filename = path.join(tmpDir, 'shuffle.tfrecord');
+    const records: string[] = [];
+    for (let i = 0; i < 20; ++i) {
+      records.push(`${i}`);
+    }
+    tf.node.data.writeTFRecords(filename, records);
+
+    const read = async () => {
+      const elements = await tf.node.data
+                           .tfRecordDataset(
+                               filename, {shuffleBufferSize: 20, seed: 42})
+                           .toArray();
+      return elements.map(
+          e => Buffer.from((e as tf.Tensor).dataSync()[0] as Uint8Array)
+                   .toString());
+    };
+    const order1 = await read();
+    const order2 = await read();
+    expect(order1).toEqual(order2);
+    expect(order1.slice().sort()).toEqual(records.slice().sort());
+  });
+
+  it('Read fixed-length records', async () => {
+    const filename = path.join(tmpDir, 'fixed.bin');
+    const records = [
+      new Uint8Array([1, 2, 3]), new Uint8Array([4, 5, 6]),
+      new Uint8Array([7, 8, 9])
+    ];
+    tf.node.data.writeFixedLengthRecords(
+        filename, records, new Uint8Array([0, 0]), new Uint8Array([255]));
+
+    const ds = tf.node.data.fixedLengthRecordDataset(
+        filename, 3, {headerBytes: 2, footerBytes: 1});
+    const elements = await ds.toArray();
+    expect(elements.length).toEqual(3);
+    expect(Array.from((elements[1] as tf.Tensor).dataSync()[0] as Uint8Array))
+        .toEqual([4, 5, 6]);
+  });
+
+  it('Dataset can be iterated more than once', async () => {
+    const filename = path.join(tmpDir, 'twice.tfrecord');
+    tf.node.data.writeTFRecords(filename, ['foo', 'bar']);
+    const ds = tf.node.data.tfRecordDataset(filename);
+    expect((await ds.toArray()).length).toEqual(2);
+    expect((await ds.toArray()).length).toEqual(2);
+  });
+
+  it('A new iteration releases an unfinished iterator', async () => {
+    const filename = path.join(tmpDir, 'unfinished.tfrecord');
+    tf.node.data.writeTFRecords(filename, ['foo', 'bar', 'baz']);
+    const ds = tf.node.data.tfRecordDataset(filename);
+    const destroySpy =
+        spyOn(nodeBackend(), 'destroyResource').and.callThrough();
+
+    expect((await ds.take(1).toArray()).length).toEqual(1);
+    expect(destroySpy).not.toHaveBeenCalled();
+    expect((await ds.toArray()).length).toEqual(3);
+    // The unfinished iterator is released first, then the exhausted one.
+    expect(destroySpy).toHaveBeenCalledTimes(2);
+  });
+
+  it('Reading a nonexistent file throws', async () => {
+    const ds =
+        tf.node.data.tfRecordDataset(path.join(tmpDir, 'nonexistent.tfrecord'));
+    let error: Error;
+    try {
+      await ds.toArray();
+    } catch (e) {
+      error = e;
+    }
+    expect(error).toBeDefined();
+  });
+});
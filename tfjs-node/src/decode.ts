@@ -0,0 +1,291 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {all, argMax, concat, dispose, equal, fill, floorDiv, gather, logicalOr, logSoftmax, multinomial, oneHot, range, Tensor, Tensor1D, Tensor2D, tidy, topk, util, where, zeros} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend} from './ops/op_utils';
+
+/** The output of one decode step. */
+export interface DecodeStepOutput {
+  /** The next-token logits of every sequence, of shape `[n, vocabSize]`. */
+  logits: Tensor2D;
+  /**
+   * The state (e.g., RNN states or KV caches) for the next step, with the
+   * sequences along the first dimension.
+   */
+  state: Tensor[];
+}
+
+/**
+ * Computes the next-token logits of `n` sequences from their last tokens
+ * (an int32 tensor of shape `[n]`) and their state.
+ */
+export type DecodeStep = (tokens: Tensor1D, state: Tensor[]) =>
+    DecodeStepOutput;
+
+export interface DecodeArgs {
+  /** The maximum number of tokens to generate. */
+  maxLength: number;
+
+  /**
+   * How the next token is selected: `'greedy'` takes the most likely token,
+   * `'topK'` samples from the `k` most likely tokens and `'beam'` runs a
+   * beam search with `k` beams.
+   *
+   * Default: `'greedy'`.
+   */
+  strategy?: 'greedy'|'topK'|'beam';
+
+  /** The number of candidates for `'topK'` or beams for `'beam'`. */
+  k?: number;
+
+  /** The softmax temperature for `'topK'`. Default: `1`. */
+  temperature?: number;
+
+  /** The random seed for `'topK'`. */
+  seed?: number;
+
+  /**
+   * The end-of-sequence token. Finished sequences are padded with it, and
+   * decoding stops early when all sequences are finished.
+   */
+  eosToken?: number;
+
+  /**
+   * How often, in steps, decoding checks whether all sequences are
+   * finished. Every check reads a single value back from TensorFlow.
+   *
+   * Default: `8`.
+   */
+  eosCheckInterval?: number;
+}
+
+// The tensors that are carried from one decode step to the next. This is a
+// type literal rather than an interface so that it can be returned from
+// `tidy()`.
+type DecodeState = {
+  tokens: Tensor1D; state: Tensor[]; history: Tensor2D; finished: Tensor1D;
+  scores: Tensor1D;
+};
+
+// Log-probability of impossible beams and tokens.
+const LOG_ZERO = -1e9;
+
+/**
+ * Generate token sequences autoregressively.
+ *
+ * `step` is called once per generated token. The next token is selected in
+ * TensorFlow (greedily, by top-k sampling or by beam search) and fed back to
+ * `step` as a tensor, so nothing is read back from TensorFlow between steps,
+ * except for one value every `eosCheckInterval` steps when `eosToken` is set.
+ * The state tensors that `step` returns stay in TensorFlow and are passed to
+ * the next step; for beam search their rows are reordered along with the
+ * beams. Only the final token IDs are returned.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const step = (tokens, [h]) => {
+ *   const [logits, newH] = decoder.predict([tokens, h]);
+ *   return {logits, state: [newH]};
+ * };
+ * const ids = await tf.node.decode(
+ *     step, tf.tensor1d([START, START], 'int32'), [initialH],
+ *     {maxLength: 64, strategy: 'beam', k: 4, eosToken: END});
+ * ```
+ *
+ * @param step The decode step.
+ * @param startTokens The first input token of every sequence, an int32
+ *   tensor of shape `[batchSize]`.
+ * @param initialState The initial state, with a first dimension of size
+ *   `batchSize`. The caller keeps ownership of these tensors.
+ * @param args Decoding arguments.
+ * @returns The generated tokens, an int32 tensor of shape
+ *   `[batchSize, length]`. For beam search, the tokens of the best beam.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export async function decode(
+    step: DecodeStep, startTokens: Tensor1D, initialState: Tensor[],
+    args: DecodeArgs): Promise<Tensor2D> {
+  ensureTensorflowBackend();
+  const strategy = args.strategy == null ? 'greedy' : args.strategy;
+  const k = args.k == null ? (strategy === 'beam' ? 4 : 40) : args.k;
+  const temperature = args.temperature == null ? 1 : args.temperature;
+  const eosCheckInterval =
+      args.eosCheckInterval == null ? 8 : args.eosCheckInterval;
+  util.assert(
+      startTokens.rank === 1 && startTokens.dtype === 'int32',
+      () => `Expected int32 startTokens of rank 1, but got ` +
+          `${startTokens.dtype} of shape [${startTokens.shape}]`);
+  util.assert(
+      Number.isInteger(k) && k > 0,
+      () => `Expected k to be a positive integer, but got ${k}`);
+  const batchSize = startTokens.shape[0];
+  const numBeams = strategy === 'beam' ? k : 1;
+  const numRows = batchSize * numBeams;
+
+  let current: DecodeState = tidy(() => {
+    // Every beam gets a copy of the rows of its batch entry. All beams but
+    // the first one start as impossible, so the first step expands one beam.
+    const rows = floorDiv(range(0, numRows, 1, 'int32'), numBeams);
+    const firstBeam = equal(range(0, numRows, 1, 'int32').mod(numBeams), 0);
+    return {
+      tokens: gather(startTokens, rows),
+      state: numBeams === 1 ? initialState : initialState.map(
+                                                 s => gather(s, rows)),
+      history: zeros([numRows, 0], 'int32') as Tensor2D,
+      finished: zeros([numRows], 'bool') as Tensor1D,
+      scores: where(firstBeam, zeros([numRows]), fill([numRows], LOG_ZERO))
+                  .as1D()
+    };
+  });
+
+  for (let t = 0; t < args.maxLength; ++t) {
+    const previous = current;
+    current = tidy(() => {
+      const output = step(previous.tokens, previous.state);
+      const logits = output.logits;
+      util.assert(
+          logits.rank === 2 && logits.shape[0] === numRows,
+          () => `Expected logits of shape [${numRows}, vocabSize], but got ` +
+              `[${logits.shape}]`);
+      const next = strategy === 'beam' ?
+          selectBeams(previous, output, batchSize, numBeams, args.eosToken) :
+          selectTokens(
+              previous, output, strategy === 'topK' ? k : 0, temperature,
+              args.seed == null ? undefined : args.seed + t, args.eosToken);
+      next.history =
+          concat([next.history, next.tokens.as2D(numRows, 1)], 1);
+      return next;
+    });
+    disposeDecodeState(previous, current, initialState);
+
+    if (args.eosToken != null && (t + 1) % eosCheckInterval === 0) {
+      const allFinished = all(current.finished);
+      const done = (await allFinished.data())[0];
+      allFinished.dispose();
+      if (done) {
+        break;
+      }
+    }
+  }
+
+  const result = tidy(() => {
+    if (numBeams === 1) {
+      return current.history.clone();
+    }
+    const best = argMax(current.scores.as2D(batchSize, numBeams), 1);
+    const rows = range(0, batchSize, 1, 'int32').mul(numBeams).add(best);
+    return gather(current.history, rows) as Tensor2D;
+  });
+  disposeDecodeState(current, null, initialState);
+  return result;
+}
+
+/** Selects one token per sequence, greedily or by top-k sampling. */
+function selectTokens(
+    previous: DecodeState, output: DecodeStepOutput, k: number,
+    temperature: number, seed: number, eosToken: number): DecodeState {
+  const logits = output.logits;
+  let tokens: Tensor1D;
+  if (k === 0) {
+    tokens = argMax(logits, 1) as Tensor1D;
+  } else {
+    const {values, indices} =
+        topk(logits.div(temperature), Math.min(k, logits.shape[1]));
+    const choice = multinomial(values as Tensor2D, 1, seed).as1D();
+    const offsets = range(0, logits.shape[0], 1, 'int32').mul(values.shape[1]);
+    tokens = gather(indices.as1D(), offsets.add(choice)) as Tensor1D;
+  }
+  let finished = previous.finished;
+  if (eosToken != null) {
+    // Finished sequences are padded with the end-of-sequence token.
+    tokens = where(finished, fill(tokens.shape, eosToken, 'int32'), tokens);
+    finished = logicalOr(finished, equal(tokens, eosToken)) as Tensor1D;
+  }
+  return {
+    tokens,
+    state: output.state,
+    history: previous.history,
+    finished,
+    scores: previous.scores
+  };
+}
+
+/**
+ * Advances the beams of every batch entry: each beam is extended by every
+ * token, and the `numBeams` most likely extensions become the new beams.
+ */
+function selectBeams(
+    previous: DecodeState, output: DecodeStepOutput, batchSize: number,
+    numBeams: number, eosToken: number): DecodeState {
+  const numRows = batchSize * numBeams;
+  const vocabSize = output.logits.shape[1];
+  let logProbs = logSoftmax(output.logits);
+  if (eosToken != null) {
+    // A finished beam can only be extended by the end-of-sequence token,
+    // which keeps its score.
+    const eosOnly = oneHot([eosToken], vocabSize, 0, LOG_ZERO)
+                        .toFloat()
+                        .tile([numRows, 1]);
+    const finished = previous.finished.as2D(numRows, 1).tile([1, vocabSize]);
+    logProbs = where(finished, eosOnly, logProbs);
+  }
+  const candidates = previous.scores.as2D(numRows, 1)
+                         .add(logProbs)
+                         .reshape([batchSize, numBeams * vocabSize]);
+  const {values: scores, indices} = topk(candidates, numBeams);
+  const parentBeams = floorDiv(indices, vocabSize);
+  const tokens = indices.sub(parentBeams.mul(vocabSize)).as1D();
+  const parentRows = range(0, batchSize, 1, 'int32')
+                         .mul(numBeams)
+                         .as2D(batchSize, 1)
+                         .add(parentBeams)
+                         .as1D();
+
+  let finished = gather(previous.finished, parentRows) as Tensor1D;
+  if (eosToken != null) {
+    finished = logicalOr(finished, equal(tokens, eosToken)) as Tensor1D;
+  }
+  return {
+    tokens: tokens as Tensor1D,
+    state: output.state.map(s => gather(s, parentRows)),
+    history: gather(previous.history, parentRows) as Tensor2D,
+    finished,
+    scores: scores.as1D()
+  };
+}
+
+/**
+ * Disposes the tensors of `previous` that are not carried over to `next`.
+ * The tensors of the initial state belong to the caller and are kept.
+ */
+function disposeDecodeState(
+    previous: DecodeState, next: DecodeState, initialState: Tensor[]) {
+  const kept = new Set<Tensor>(initialState);
+  if (next != null) {
+    [next.tokens, next.history, next.finished, next.scores, ...next.state]
+        .forEach(tensor => kept.add(tensor));
+  }
+  dispose([
+    previous.tokens, previous.history, previous.finished, previous.scores,
+    ...previous.state
+  ].filter(tensor => !kept.has(tensor)));
+}
@@ -16,6 +16,7 @@
  */
 
 import {Tensor3D, Tensor4D, tidy, util} from '@tensorflow/tfjs-core';
+import {decodeGifFirstFrame} from './gif_frame_decoder';
 import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
 
 enum ImageType {
@@ -120,6 +121,9 @@ export function decodeBmp(contents: Uint8Array, channels = 0): Tensor3D {
 /**
  * Decode the frame(s) of a GIF-encoded image to a 4D Tensor of dtype `int32`.
  *
+ * All frames are decoded at once. Use `tf.node.decodeGifFrames()` to decode
+ * long animations in bounded memory.
+ *
  * @param contents The GIF-encoded image in an Uint8Array.
  * @returns A 4D Tensor of dtype `int32` with shape [num_frames, height, width,
  *     3]. RGB channel order.
@@ -177,12 +181,10 @@ export function decodeImage(
     case ImageType.PNG:
       return decodePng(content, channels);
     case ImageType.GIF:
-      // If not to expand animations, take first frame of the gif and return
-      // as a 3D tensor.
-      return tidy(() => {
-        const img = decodeGif(content);
-        return expandAnimations ? img : img.slice(0, 1).squeeze([0]);
-      });
+      // If not to expand animations, only decode the first frame of the gif
+      // and return it as a 3D tensor.
+      return expandAnimations ? decodeGif(content) :
+                                decodeGifFirstFrame(content);
     case ImageType.BMP:
       return decodeBmp(content, channels);
     default:
@@ -0,0 +1,122 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+describe('decode', () => {
+  // A Markov chain: the logits of the next token depend only on the last
+  // token. The state counts the steps.
+  const makeStep = (probabilities: number[][]) => {
+    const logits = tf.keep(tf.log(tf.tensor2d(probabilities)));
+    return (tokens: tf.Tensor1D, [count]: tf.Tensor[]) => ({
+      logits: tf.gather(logits, tokens) as tf.Tensor2D,
+      state: [count.add(1)]
+    });
+  };
+  // Token i is most likely followed by token i + 1; token 3 is the end.
+  const chain = [
+    [0.1, 0.7, 0.1, 0.1], [0.1, 0.1, 0.7, 0.1], [0.1, 0.1, 0.1, 0.7],
+    [0.1, 0.1, 0.1, 0.7]
+  ];
+
+  it('Greedy decoding', async () => {
+    const tokens = await tf.node.decode(
+        makeStep(chain), tf.tensor1d([0, 1], 'int32'), [tf.zeros([2])],
+        {maxLength: 3});
+    expect(tokens.dtype).toEqual('int32');
+    expect(await tokens.array()).toEqual([[1, 2, 3], [2, 3, 3]]);
+  });
+
+  it('Stops when all sequences are finished', async () => {
+    const step = makeStep(chain);
+    let numSteps = 0;
+    const countingStep = (tokens: tf.Tensor1D, state: tf.Tensor[]) => {
+      numSteps++;
+      return step(tokens, state);
+    };
+    const tokens = await tf.node.decode(
+        countingStep, tf.tensor1d([1, 2], 'int32'), [tf.zeros([2])],
+        {maxLength: 100, eosToken: 3, eosCheckInterval: 4});
+    expect(numSteps).toEqual(4);
+    // Finished sequences are padded with the end token.
+    expect(await tokens.array()).toEqual([[2, 3, 3, 3], [3, 3, 3, 3]]);
+  });
+
+  it('Top-k sampling with k = 1 is greedy', async () => {
+    const tokens = await tf.node.decode(
+        makeStep(chain), tf.tensor1d([0], 'int32'), [tf.zeros([1])],
+        {maxLength: 3, strategy: 'topK', k: 1, seed: 1});
+    expect(await tokens.array()).toEqual([[1, 2, 3]]);
+  });
+
+  it('Top-k sampling samples only the k most likely tokens', async () => {
+    const tokens = await tf.node.decode(
+        makeStep([[0.05, 0.5, 0.4, 0.05], [0.05, 0.5, 0.4, 0.05],
+                  [0.05, 0.5, 0.4, 0.05], [0.05, 0.5, 0.4, 0.05]]),
+        tf.tensor1d([0, 0, 0, 0], 'int32'), [tf.zeros([4])],
+        {maxLength: 16, strategy: 'topK', k: 2, seed: 7});
+    const values = await tokens.data();
+    for (let i = 0; i < values.length; ++i) {
+      expect([1, 2]).toContain(values[i]);
+    }
+  });
+
+  it('Beam search finds a more likely sequence than greedy', async () => {
+    // Greedy decoding picks 1 (p = 0.6) and then at most p = 0.34, while
+    // 2, 2 has p = 0.4 * 0.9.
+    const probabilities = [
+      [1e-6, 0.6, 0.4], [0.33, 0.34, 0.33], [0.05, 0.05, 0.9]
+    ];
+    const start = tf.tensor1d([0], 'int32');
+    const greedy = await tf.node.decode(
+        makeStep(probabilities), start, [tf.zeros([1])], {maxLength: 2});
+    expect(await greedy.array()).toEqual([[1, 1]]);
+    const beam = await tf.node.decode(
+        makeStep(probabilities), start, [tf.zeros([1])],
+        {maxLength: 2, strategy: 'beam', k: 2});
+    expect(await beam.array()).toEqual([[2, 2]]);
+  });
+
+  it('State is carried across steps', async () => {
+    let lastCount: number;
+    const step = makeStep(chain);
+    const checkingStep = (tokens: tf.Tensor1D, state: tf.Tensor[]) => {
+      lastCount = state[0].dataSync()[0];
+      return step(tokens, state);
+    };
+    await tf.node.decode(
+        checkingStep, tf.tensor1d([0, 0, 0], 'int32'), [tf.zeros([3])],
+        {maxLength: 5, strategy: 'beam', k: 3});
+    expect(lastCount).toEqual(4);
+  });
+
+  it('Does not leak tensors', async () => {
+    const step = makeStep(chain);
+    const start = tf.tensor1d([0, 1], 'int32');
+    const initialState = [tf.zeros([2])];
+    for (const strategy of ['greedy', 'topK', 'beam'] as
+         Array<'greedy'|'topK'|'beam'>) {
+      const numTensors = tf.memory().numTensors;
+      const tokens = await tf.node.decode(
+          step, start, initialState,
+          {maxLength: 5, strategy, k: 2, eosToken: 3, eosCheckInterval: 1});
+      tokens.dispose();
+      expect(tf.memory().numTensors).toEqual(numTensors);
+      expect(initialState[0].isDisposed).toEqual(false);
+    }
+  });
+});
@@ -0,0 +1,219 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {Tensor3D, Tensor4D, tidy, unstack, util} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+export interface EncodeJpegArgs {
+  /**
+   * Per pixel image format: `''` to infer it from the number of channels,
+   * `'grayscale'` or `'rgb'`. Default: `''`.
+   */
+  format?: ''|'grayscale'|'rgb';
+
+  /** Quality of the compression from 0 to 100. Default: `95`. */
+  quality?: number;
+
+  /** If true, create a JPEG that loads progressively. Default: `false`. */
+  progressive?: boolean;
+
+  /**
+   * If true, spend CPU/RAM to reduce the size with no quality change.
+   * Default: `false`.
+   */
+  optimizeSize?: boolean;
+
+  /**
+   * If false, do not downsample the chroma planes, for better quality at
+   * larger sizes. Default: `true`.
+   */
+  chromaDownsampling?: boolean;
+}
+
+export interface EncodePngArgs {
+  /**
+   * Compression level from 0 (fastest) to 9 (smallest), or -1 for the zlib
+   * default. Default: `-1`.
+   */
+  compression?: number;
+}
+
+/**
+ * Returns an int32 copy of `image` with values rounded and clipped to
+ * [0, 255].
+ */
+function toPixelValues(
+    image: Tensor3D, validChannels: number[], format: string): Tensor3D {
+  util.assert(
+      image.rank === 3,
+      () => `${format} encoding expects a 3D tensor, but got a tensor of ` +
+          `rank ${image.rank}`);
+  util.assert(
+      validChannels.indexOf(image.shape[2]) !== -1,
+      () => `${format} encoding expects ${validChannels.join(', ')} ` +
+          `channels, but got ${image.shape[2]}`);
+  util.assert(
+      image.dtype === 'int32' || image.dtype === 'float32',
+      () => `${format} encoding expects an int32 or float32 tensor, but got ` +
+          `${image.dtype}`);
+  return tidy(() => {
+    const pixels = image.dtype === 'int32' ? image : image.round().toInt();
+    return pixels.clipByValue(0, 255);
+  });
+}
+
+/** Returns a Buffer that shares the memory of `bytes`. */
+function toBuffer(bytes: Uint8Array): Buffer {
+  return Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+}
+
+/** Returns the images of a batch, or the array of images itself. */
+function toImageArray(images: Tensor4D|Tensor3D[]): Tensor3D[] {
+  return Array.isArray(images) ? images : unstack(images) as Tensor3D[];
+}
+
+/**
+ * Encode an image as a JPEG.
+ *
+ * The image is encoded by TensorFlow's EncodeJpeg kernel on the libuv thread
+ * pool, so the event loop is not blocked, and the pixels are never read back
+ * to JavaScript.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const jpeg = await tf.node.encodeJpeg(image, {quality: 80});
+ * response.setHeader('Content-Type', 'image/jpeg');
+ * response.end(jpeg);
+ * ```
+ *
+ * @param image A 3D Tensor of dtype `int32` or `float32` with shape [height,
+ *     width, 1/3]. Values are rounded and clipped to [0, 255].
+ * @param args Optional encoding arguments.
+ * @returns A promise of a Buffer with the JPEG-encoded image.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export async function encodeJpeg(
+    image: Tensor3D, args?: EncodeJpegArgs): Promise<Buffer> {
+  ensureTensorflowBackend();
+  args = args == null ? {} : args;
+  const quality = args.quality == null ? 95 : args.quality;
+  util.assert(
+      Number.isInteger(quality) && quality >= 0 && quality <= 100,
+      () => `Expected quality to be an integer in [0, 100], but got ` +
+          `${quality}`);
+  const pixels = toPixelValues(image, [1, 3], 'JPEG');
+  let encoded: Promise<Uint8Array>;
+  try {
+    encoded = nodeBackend().encodeJpegAsync(
+        pixels, args.format == null ? '' : args.format, quality,
+        !!args.progressive, !!args.optimizeSize,
+        args.chromaDownsampling == null ? true : args.chromaDownsampling);
+  } finally {
+    // The pixels are copied to a native tensor before the encoding starts.
+    pixels.dispose();
+  }
+  return toBuffer(await encoded);
+}
+
+/**
+ * Encode an image as a PNG.
+ *
+ * The image is encoded by TensorFlow's EncodePng kernel on the libuv thread
+ * pool, so the event loop is not blocked, and the pixels are never read back
+ * to JavaScript.
+ *
+ * @param image A 3D Tensor of dtype `int32` or `float32` with shape [height,
+ *     width, 1/2/3/4]. Values are rounded and clipped to [0, 255].
+ * @param args Optional encoding arguments.
+ * @returns A promise of a Buffer with the PNG-encoded image.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export async function encodePng(
+    image: Tensor3D, args?: EncodePngArgs): Promise<Buffer> {
+  ensureTensorflowBackend();
+  args = args == null ? {} : args;
+  const compression = args.compression == null ? -1 : args.compression;
+  util.assert(
+      Number.isInteger(compression) && compression >= -1 && compression <= 9,
+      () => `Expected compression to be an integer in [-1, 9], but got ` +
+          `${compression}`);
+  const pixels = toPixelValues(image, [1, 2, 3, 4], 'PNG');
+  let encoded: Promise<Uint8Array>;
+  try {
+    encoded = nodeBackend().encodePngAsync(pixels, compression);
+  } finally {
+    // The pixels are copied to a native tensor before the encoding starts.
+    pixels.dispose();
+  }
+  return toBuffer(await encoded);
+}
+
+/**
+ * Encode a batch of images as JPEGs. The images are encoded in parallel on
+ * the libuv thread pool.
+ *
+ * @param images A 4D Tensor with shape [batch, height, width, 1/3], or an
+ *     array of 3D Tensors, of dtype `int32` or `float32`.
+ * @param args Optional encoding arguments, shared by all images.
+ * @returns A promise of one Buffer per image.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export async function encodeJpegBatch(
+    images: Tensor4D|Tensor3D[], args?: EncodeJpegArgs): Promise<Buffer[]> {
+  ensureTensorflowBackend();
+  const imageArray = toImageArray(images);
+  try {
+    return await Promise.all(imageArray.map(image => encodeJpeg(image, args)));
+  } finally {
+    if (imageArray !== images) {
+      imageArray.forEach(image => image.dispose());
+    }
+  }
+}
+
+/**
+ * Encode a batch of images as PNGs. The images are encoded in parallel on
+ * the libuv thread pool.
+ *
+ * @param images A 4D Tensor with shape [batch, height, width, 1/2/3/4], or an
+ *     array of 3D Tensors, of dtype `int32` or `float32`.
+ * @param args Optional encoding arguments, shared by all images.
+ * @returns A promise of one Buffer per image.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export async function encodePngBatch(
+    images: Tensor4D|Tensor3D[], args?: EncodePngArgs): Promise<Buffer[]> {
+  ensureTensorflowBackend();
+  const imageArray = toImageArray(images);
+  try {
+    return await Promise.all(imageArray.map(image => encodePng(image, args)));
+  } finally {
+    if (imageArray !== images) {
+      imageArray.forEach(image => image.dispose());
+    }
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+const PIXELS = [238, 101, 0, 50, 50, 50, 100, 50, 0, 200, 100, 50];
+
+describe('encode images', () => {
+  it('encodePng round trip', async () => {
+    const image = tf.tensor3d(PIXELS, [2, 2, 3], 'int32');
+    const numTensors = tf.memory().numTensors;
+    const png = await tf.node.encodePng(image);
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    expect(Buffer.isBuffer(png)).toBe(true);
+    expect(Array.from(png.subarray(0, 4))).toEqual([0x89, 0x50, 0x4E, 0x47]);
+    tf.test_util.expectArraysEqual(tf.node.decodePng(png).dataSync(), PIXELS);
+  });
+
+  it('encodePng rounds and clips float32 values', async () => {
+    const image = tf.tensor3d([-10, 0.4, 127.6, 300], [2, 2, 1]);
+    const png = await tf.node.encodePng(image, {compression: 9});
+    tf.test_util.expectArraysEqual(
+        tf.node.decodePng(png).dataSync(), [0, 0, 128, 255]);
+  });
+
+  it('encodeJpeg', async () => {
+    const image = tf.fill([16, 16, 3], 128, 'int32') as tf.Tensor3D;
+    const jpeg = await tf.node.encodeJpeg(image, {quality: 90});
+    expect(Array.from(jpeg.subarray(0, 3))).toEqual([0xFF, 0xD8, 0xFF]);
+    const decoded = tf.node.decodeJpeg(jpeg);
+    expect(decoded.shape).toEqual([16, 16, 3]);
+    tf.test_util.expectArraysClose(decoded.dataSync(), image.dataSync(), 2);
+  });
+
+  it('encodeJpeg quality changes the size', async () => {
+    const image = tf.randomUniform([64, 64, 3], 0, 255) as tf.Tensor3D;
+    const small = await tf.node.encodeJpeg(image, {quality: 10});
+    const large = await tf.node.encodeJpeg(image, {quality: 100});
+    expect(small.length).toBeLessThan(large.length);
+  });
+
+  it('encodeJpeg rejects invalid images', async done => {
+    try {
+      await tf.node.encodeJpeg(tf.zeros([2, 2, 4]) as tf.Tensor3D);
+      done.fail('encodeJpeg() should have failed');
+    } catch (e) {
+      expect(e.message).toMatch(/1, 3 channels/);
+      done();
+    }
+  });
+
+  it('encodePngBatch with a 4D tensor', async () => {
+    const images =
+        tf.tensor4d(PIXELS.concat(PIXELS.slice().reverse()), [2, 2, 2, 3]);
+    const numTensors = tf.memory().numTensors;
+    const pngs = await tf.node.encodePngBatch(images);
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    expect(pngs.length).toEqual(2);
+    for (let i = 0; i < 2; ++i) {
+      tf.test_util.expectArraysEqual(
+          tf.node.decodePng(pngs[i]).dataSync(),
+          images.slice(i, 1).dataSync());
+    }
+  });
+
+  it('encodeJpegBatch with an array of tensors', async () => {
+    const images = [
+      tf.zeros([8, 8, 1]) as tf.Tensor3D, tf.ones([4, 4, 3]) as tf.Tensor3D
+    ];
+    const jpegs = await tf.node.encodeJpegBatch(images);
+    expect(jpegs.length).toEqual(2);
+    expect(tf.node.decodeJpeg(jpegs[0]).shape).toEqual([8, 8, 1]);
+    expect(tf.node.decodeJpeg(jpegs[1]).shape).toEqual([4, 4, 3]);
+    expect(images[0].isDisposed).toBe(false);
+  });
+});
@@ -0,0 +1,133 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {image, Tensor3D, tidy, util} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/**
+ * RGBA pixels in row-major order, like the `ImageData` returned by
+ * `getImageData()` of the `canvas` npm package.
+ */
+export interface PixelSource {
+  data: Uint8Array|Uint8ClampedArray;
+  width: number;
+  height: number;
+}
+
+/**
+ * A canvas with a 2D context, like the one returned by the `canvas` npm
+ * package.
+ */
+export interface CanvasLike {
+  width: number;
+  height: number;
+  getContext(contextId: '2d'): {
+    getImageData(x: number, y: number, width: number, height: number):
+        PixelSource;
+  };
+}
+
+export interface FromPixelsArgs {
+  /**
+   * The number of leading RGBA channels to keep, from 1 to 4. Default: `3`.
+   */
+  numChannels?: number;
+
+  /** The dtype of the result. Default: `'int32'`. */
+  dtype?: 'int32'|'float32';
+
+  /**
+   * If true, divide the values by 255 so that they are in [0, 1]. Requires
+   * `dtype` to be `'float32'`. Default: `false`.
+   */
+  normalize?: boolean;
+
+  /**
+   * If set, resize the image to [height, width] with bilinear
+   * interpolation. Resized int32 images are rounded.
+   */
+  resize?: [number, number];
+
+  /** Passed to `tf.image.resizeBilinear()`. Default: `false`. */
+  alignCorners?: boolean;
+}
+
+/**
+ * Create a tensor from the pixels of a canvas or of its `ImageData`.
+ *
+ * Unlike `tf.browser.fromPixels()`, which returns an int32 tensor with
+ * three channels, the channel selection, the conversion to `float32`, the
+ * normalization and the resizing are all done natively, without work per
+ * pixel in JavaScript. This is meant for pipelines that process many frames,
+ * e.g., of a video decoded into a `canvas`.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const imageData = context.getImageData(0, 0, width, height);
+ * const input = tf.node.fromPixels(
+ *     imageData, {dtype: 'float32', normalize: true, resize: [224, 224]});
+ * ```
+ *
+ * @param pixels The RGBA pixels, or a canvas to read them from.
+ * @param args Optional conversion arguments.
+ * @returns A 3D Tensor with shape [height, width, numChannels].
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export function fromPixels(
+    pixels: PixelSource|CanvasLike, args?: FromPixelsArgs): Tensor3D {
+  ensureTensorflowBackend();
+  args = args == null ? {} : args;
+  const numChannels = args.numChannels == null ? 3 : args.numChannels;
+  const dtype = args.dtype == null ? 'int32' : args.dtype;
+  const normalize = !!args.normalize;
+  util.assert(
+      Number.isInteger(numChannels) && numChannels >= 1 && numChannels <= 4,
+      () => `Expected numChannels to be 1, 2, 3 or 4, but got ${numChannels}`);
+  util.assert(
+      dtype === 'int32' || dtype === 'float32',
+      () => `Expected dtype to be 'int32' or 'float32', but got ${dtype}`);
+  util.assert(
+      !normalize || dtype === 'float32',
+      () => 'normalize requires dtype to be float32');
+
+  const source = (pixels as CanvasLike).getContext != null ?
+      (pixels as CanvasLike)
+          .getContext('2d')
+          .getImageData(0, 0, pixels.width, pixels.height) :
+      pixels as PixelSource;
+  util.assert(
+      source.data instanceof Uint8Array ||
+          source.data instanceof Uint8ClampedArray,
+      () => 'fromPixels() expects RGBA pixels in an Uint8ClampedArray or ' +
+          'an Uint8Array');
+
+  return tidy(() => {
+    const result = nodeBackend().createTensorFromPixels(
+        source.data, source.height, source.width, numChannels,
+        args.resize == null ? dtype : 'float32', normalize);
+    if (args.resize == null) {
+      return result;
+    }
+    const resized =
+        image.resizeBilinear(result, args.resize, !!args.alignCorners);
+    return dtype === 'int32' ? resized.round().toInt() : resized;
+  });
+}
@@ -0,0 +1,90 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+/** Returns 2x2 RGBA pixels with the values 1, 2, ..., 16. */
+function createImageData() {
+  const data = new Uint8ClampedArray(16);
+  for (let i = 0; i < data.length; ++i) {
+    data[i] = i + 1;
+  }
+  return {data, width: 2, height: 2};
+}
+
+class MockCanvas {
+  width = 2;
+  height = 2;
+  getContext(type: '2d') {
+    return {getImageData: () => createImageData()};
+  }
+}
+
+describe('tf.node.fromPixels', () => {
+  it('keeps three channels by default', () => {
+    const t = tf.node.fromPixels(createImageData());
+    expect(t.dtype).toBe('int32');
+    expect(t.shape).toEqual([2, 2, 3]);
+    tf.test_util.expectArraysEqual(
+        t.dataSync(), [1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15]);
+  });
+
+  it('reads the pixels of a canvas', () => {
+    const t = tf.node.fromPixels(new MockCanvas(), {numChannels: 1});
+    expect(t.shape).toEqual([2, 2, 1]);
+    tf.test_util.expectArraysEqual(t.dataSync(), [1, 5, 9, 13]);
+  });
+
+  it('keeps four channels', () => {
+    const t = tf.node.fromPixels(createImageData(), {numChannels: 4});
+    expect(t.shape).toEqual([2, 2, 4]);
+    tf.test_util.expectArraysEqual(
+        t.dataSync(), [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]);
+  });
+
+  it('creates normalized float32 tensors', () => {
+    const t = tf.node.fromPixels(
+        createImageData(), {numChannels: 2, dtype: 'float32', normalize: true});
+    expect(t.dtype).toBe('float32');
+    tf.test_util.expectArraysClose(
+        t.dataSync(), [1, 2, 5, 6, 9, 10, 13, 14].map(v => v / 255));
+  });
+
+  it('resizes', () => {
+    const numTensors = tf.memory().numTensors;
+    const t = tf.node.fromPixels(createImageData(), {resize: [1, 1]});
+    expect(tf.memory().numTensors).toEqual(numTensors + 1);
+    expect(t.dtype).toBe('int32');
+    expect(t.shape).toEqual([1, 1, 3]);
+    tf.test_util.expectArraysEqual(t.dataSync(), [1, 2, 3]);
+
+    const resized = tf.node.fromPixels(
+        createImageData(), {dtype: 'float32', resize: [4, 4]});
+    expect(resized.shape).toEqual([4, 4, 3]);
+  });
+
+  it('throws on invalid arguments', () => {
+    expect(() => tf.node.fromPixels(createImageData(), {numChannels: 5}))
+        .toThrowError(/numChannels/);
+    expect(() => tf.node.fromPixels(createImageData(), {normalize: true}))
+        .toThrowError(/normalize requires dtype to be float32/);
+    expect(
+        () => tf.node.fromPixels(
+            {data: new Uint8ClampedArray(4), width: 2, height: 2}))
+        .toThrowError(/Expected 16 RGBA values/);
+  });
+});
@@ -0,0 +1,326 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {concat, keep, stack, Tensor3D, Tensor4D, tidy, util, zeros} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+const EXTENSION_INTRODUCER = 0x21;
+const IMAGE_SEPARATOR = 0x2C;
+const TRAILER = 0x3B;
+
+/** The location of one frame in a GIF file. */
+interface GifFrame {
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+  // The byte range of the image descriptor, local color table and image
+  // data of the frame.
+  begin: number;
+  end: number;
+}
+
+/** The block structure of a GIF file. */
+interface GifLayout {
+  width: number;
+  height: number;
+  // The end of the header, logical screen descriptor and global color table.
+  screenEnd: number;
+  frames: GifFrame[];
+}
+
+function readUint16(contents: Uint8Array, offset: number): number {
+  return contents[offset] | (contents[offset + 1] << 8);
+}
+
+function writeUint16(contents: Uint8Array, offset: number, value: number) {
+  contents[offset] = value & 0xFF;
+  contents[offset + 1] = value >> 8;
+}
+
+/** Returns the size of a color table given the packed fields of a block. */
+function colorTableSize(packedFields: number): number {
+  return (packedFields & 0x80) === 0 ? 0 : 3 * (1 << ((packedFields & 7) + 1));
+}
+
+/**
+ * Returns the offset after the data sub-blocks that start at `offset`.
+ */
+function skipSubBlocks(contents: Uint8Array, offset: number): number {
+  while (offset < contents.length && contents[offset] !== 0) {
+    offset += contents[offset] + 1;
+  }
+  if (offset >= contents.length) {
+    throw new Error('Invalid GIF: truncated data sub-blocks');
+  }
+  return offset + 1;
+}
+
+/**
+ * Locates the frames of a GIF file without decompressing them. Parsing stops
+ * after `maxFrames` frames.
+ */
+function readGifLayout(contents: Uint8Array, maxFrames = Infinity): GifLayout {
+  if (contents.length < 13 || contents[0] !== 0x47 || contents[1] !== 0x49 ||
+      contents[2] !== 0x46) {
+    throw new Error('Invalid GIF: missing GIF header');
+  }
+  const width = readUint16(contents, 6);
+  const height = readUint16(contents, 8);
+  const screenEnd = 13 + colorTableSize(contents[10]);
+  const frames: GifFrame[] = [];
+
+  let offset = screenEnd;
+  while (frames.length < maxFrames) {
+    if (offset >= contents.length) {
+      throw new Error('Invalid GIF: missing trailer');
+    }
+    const blockType = contents[offset];
+    if (blockType === TRAILER) {
+      break;
+    } else if (blockType === EXTENSION_INTRODUCER) {
+      // Extensions (graphic control, comments, application data) do not
+      // affect the decoded pixels.
+      offset = skipSubBlocks(contents, offset + 2);
+    } else if (blockType === IMAGE_SEPARATOR) {
+      if (offset + 10 > contents.length) {
+        throw new Error('Invalid GIF: truncated image descriptor');
+      }
+      const begin = offset;
+      // Image descriptor, local color table and LZW minimum code size.
+      offset += 10 + colorTableSize(contents[offset + 9]) + 1;
+      offset = skipSubBlocks(contents, offset);
+      frames.push({
+        left: readUint16(contents, begin + 1),
+        top: readUint16(contents, begin + 3),
+        width: readUint16(contents, begin + 5),
+        height: readUint16(contents, begin + 7),
+        begin,
+        end: offset
+      });
+    } else {
+      throw new Error(
+          `Invalid GIF: unknown block type ${blockType} at offset ${offset}`);
+    }
+  }
+  if (frames.length === 0) {
+    throw new Error('Invalid GIF: no image data');
+  }
+  return {width, height, screenEnd, frames};
+}
+
+/**
+ * Decodes the pixels of one frame, without the rest of the canvas, to a 3D
+ * Tensor of dtype `int32` with shape [frame.height, frame.width, 3].
+ *
+ * The frame is copied into a GIF of its own, whose logical screen is the
+ * frame rectangle, so that TensorFlow only decompresses this frame.
+ */
+function decodeFramePixels(
+    contents: Uint8Array, layout: GifLayout, frame: GifFrame): Tensor3D {
+  const imageLength = frame.end - frame.begin;
+  const gif = new Uint8Array(layout.screenEnd + imageLength + 1);
+  gif.set(contents.subarray(0, layout.screenEnd));
+  gif.set(contents.subarray(frame.begin, frame.end), layout.screenEnd);
+  gif[gif.length - 1] = TRAILER;
+  writeUint16(gif, 6, frame.width);
+  writeUint16(gif, 8, frame.height);
+  writeUint16(gif, layout.screenEnd + 1, 0);
+  writeUint16(gif, layout.screenEnd + 3, 0);
+  return tidy(
+      () => nodeBackend().decodeGif(gif).toInt().squeeze([0]) as Tensor3D);
+}
+
+/** Concatenates the non-empty tensors of `parts` along `axis`. */
+function concatNonEmpty(parts: Tensor3D[], axis: number): Tensor3D {
+  const nonEmpty = parts.filter(part => part.size > 0);
+  return nonEmpty.length === 1 ? nonEmpty[0] : concat(nonEmpty, axis);
+}
+
+/**
+ * Draws the pixels of a frame over the previous frame. Like TensorFlow's
+ * DecodeGif, the canvas outside the first frame is black, and the frames
+ * replace all the pixels of their rectangle.
+ */
+function compositeFrame(
+    canvas: Tensor3D, pixels: Tensor3D, frame: GifFrame,
+    layout: GifLayout): Tensor3D {
+  const {width, height} = layout;
+  const left = Math.min(frame.left, width);
+  const top = Math.min(frame.top, height);
+  const right = Math.min(frame.left + frame.width, width);
+  const bottom = Math.min(frame.top + frame.height, height);
+  if (left === 0 && top === 0 && right === width && bottom === height &&
+      frame.width === width && frame.height === height) {
+    return pixels;
+  }
+  const base = canvas == null ?
+      zeros([height, width, 3], 'int32') as Tensor3D :
+      canvas;
+  if (left === right || top === bottom) {
+    return base;
+  }
+  const rows = bottom - top;
+  const middle = concatNonEmpty(
+      [
+        base.slice([top, 0, 0], [rows, left, 3]),
+        pixels.slice([0, 0, 0], [rows, right - left, 3]),
+        base.slice([top, right, 0], [rows, width - right, 3])
+      ],
+      1);
+  return concatNonEmpty(
+      [
+        base.slice([0, 0, 0], [top, width, 3]), middle,
+        base.slice([bottom, 0, 0], [height - bottom, width, 3])
+      ],
+      0);
+}
+
+/**
+ * Decodes the frames of an animated GIF incrementally, so that only the
+ * requested frames and the last decoded frame are held in memory.
+ *
+ * Users are expected to access this class through the `decodeGifFrames()`
+ * factory method instead.
+ */
+export class GifFrameDecoder {
+  /** The width of the GIF canvas. */
+  readonly width: number;
+  /** The height of the GIF canvas. */
+  readonly height: number;
+  /** The number of frames of the GIF. */
+  readonly numFrames: number;
+
+  private readonly layout: GifLayout;
+  private nextFrame = 0;
+  // The last decoded frame, over which the next frame is drawn.
+  private canvas: Tensor3D = null;
+
+  constructor(private readonly contents: Uint8Array) {
+    ensureTensorflowBackend();
+    this.layout = readGifLayout(contents);
+    this.width = this.layout.width;
+    this.height = this.layout.height;
+    this.numFrames = this.layout.frames.length;
+  }
+
+  /** Returns whether frames remain to be decoded. */
+  hasNext(): boolean {
+    return this.nextFrame < this.numFrames;
+  }
+
+  /**
+   * Decodes the next frames.
+   *
+   * @param maxFrames The maximum number of frames to decode. Defaults to 1.
+   * @returns A 4D Tensor of dtype `int32` with shape [num_frames, height,
+   *     width, 3], or null if every frame has been decoded.
+   */
+  next(maxFrames = 1): Tensor4D {
+    util.assert(
+        Number.isInteger(maxFrames) && maxFrames > 0,
+        () => `Expected maxFrames to be a positive integer, but got ` +
+            `${maxFrames}`);
+    if (!this.hasNext()) {
+      return null;
+    }
+    const previousCanvas = this.canvas;
+    let canvas = previousCanvas;
+    const frames = tidy(() => {
+      const decoded: Tensor3D[] = [];
+      while (decoded.length < maxFrames && this.hasNext()) {
+        const frame = this.layout.frames[this.nextFrame++];
+        canvas = compositeFrame(
+            canvas, decodeFramePixels(this.contents, this.layout, frame),
+            frame, this.layout);
+        decoded.push(canvas);
+      }
+      if (canvas !== previousCanvas) {
+        keep(canvas);
+      }
+      return stack(decoded) as Tensor4D;
+    });
+    if (canvas !== previousCanvas && previousCanvas != null) {
+      previousCanvas.dispose();
+    }
+    this.canvas = canvas;
+    return frames;
+  }
+
+  /** Releases the last decoded frame. */
+  dispose(): void {
+    if (this.canvas != null) {
+      this.canvas.dispose();
+      this.canvas = null;
+    }
+    this.nextFrame = this.numFrames;
+  }
+}
+
+/**
+ * Create a decoder that decodes the frames of a GIF one at a time or in
+ * chunks.
+ *
+ * `tf.node.decodeGif()` decodes every frame of an animation into a single
+ * tensor, which can take hundreds of megabytes for long animations. The
+ * decoder locates the frames without decompressing them, and then
+ * decompresses only the requested frames, holding at most one frame besides
+ * the returned tensors.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const decoder = tf.node.decodeGifFrames(fs.readFileSync('animation.gif'));
+ * while (decoder.hasNext()) {
+ *   const frames = decoder.next(8);  // [<= 8, height, width, 3]
+ *   ...
+ *   frames.dispose();
+ * }
+ * decoder.dispose();
+ * ```
+ *
+ * @param contents The GIF-encoded image in an Uint8Array.
+ * @returns An instance of `GifFrameDecoder`.
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export function decodeGifFrames(contents: Uint8Array): GifFrameDecoder {
+  return new GifFrameDecoder(contents);
+}
+
+/**
+ * Decode the first frame of a GIF to a 3D Tensor of dtype `int32`.
+ *
+ * Parsing stops after the first frame, and only that frame is decompressed.
+ *
+ * @param contents The GIF-encoded image in an Uint8Array.
+ * @returns A 3D Tensor of dtype `int32` with shape [height, width, 3].
+ */
+/**
+ * @doc {heading: 'Operations', subheading: 'Images', namespace: 'node'}
+ */
+export function decodeGifFirstFrame(contents: Uint8Array): Tensor3D {
+  ensureTensorflowBackend();
+  const layout = readGifLayout(contents, 1);
+  const frame = layout.frames[0];
+  return tidy(
+      () => compositeFrame(
+          null, decodeFramePixels(contents, layout, frame), frame, layout));
+}
@@ -0,0 +1,125 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as fs from 'fs';
+import * as tf from './index';
+
+const FRAME_0 = [238, 101, 0, 50, 50, 50, 100, 50, 0, 200, 100, 50];
+const FRAME_1 = [200, 100, 50, 34, 68, 102, 170, 0, 102, 255, 255, 255];
+
+/**
+ * Returns a GIF with the screen and first frame of `test_images/gif_test.gif`
+ * followed by a 1x1 frame at (1, 1) with the color at index 4 of the global
+ * color table, (34, 68, 102).
+ */
+function createPartialFrameGif(): Uint8Array {
+  const gif = new Uint8Array(fs.readFileSync('test_images/gif_test.gif'));
+  // Header, logical screen descriptor and global color table.
+  const screen = Array.from(gif.subarray(0, 37));
+  // Image descriptor and data of the first frame.
+  const firstFrame = Array.from(gif.subarray(0x57, 0x67));
+  const partialFrame = [
+    0x2C, 1, 0, 1, 0, 1, 0, 1, 0, 0,  // 1x1 image at (1, 1)
+    3, 2, 0x48, 0x09, 0               // LZW codes: clear, 4, end
+  ];
+  return new Uint8Array(screen.concat(firstFrame, partialFrame, [0x3B]));
+}
+
+describe('decodeGifFrames', () => {
+  it('decodes one frame at a time', () => {
+    const decoder =
+        tf.node.decodeGifFrames(fs.readFileSync('test_images/gif_test.gif'));
+    expect(decoder.width).toEqual(2);
+    expect(decoder.height).toEqual(2);
+    expect(decoder.numFrames).toEqual(2);
+
+    const frame0 = decoder.next();
+    expect(frame0.dtype).toBe('int32');
+    expect(frame0.shape).toEqual([1, 2, 2, 3]);
+    tf.test_util.expectArraysEqual(frame0.dataSync(), FRAME_0);
+    const frame1 = decoder.next();
+    tf.test_util.expectArraysEqual(frame1.dataSync(), FRAME_1);
+    expect(decoder.hasNext()).toBe(false);
+    expect(decoder.next()).toBeNull();
+    decoder.dispose();
+  });
+
+  it('decodes chunks of frames', () => {
+    const contents = fs.readFileSync('test_images/gif_test.gif');
+    const decoder = tf.node.decodeGifFrames(contents);
+    const frames = decoder.next(8);
+    expect(frames.shape).toEqual([2, 2, 2, 3]);
+    tf.test_util.expectArraysEqual(
+        frames.dataSync(), tf.node.decodeGif(contents).dataSync());
+    decoder.dispose();
+  });
+
+  it('draws partial frames over the previous frame', () => {
+    const contents = createPartialFrameGif();
+    const decoder = tf.node.decodeGifFrames(contents);
+    decoder.next().dispose();
+    const frame1 = decoder.next();
+    expect(frame1.shape).toEqual([1, 2, 2, 3]);
+    tf.test_util.expectArraysEqual(
+        frame1.dataSync(), [238, 101, 0, 50, 50, 50, 100, 50, 0, 34, 68, 102]);
+    tf.test_util.expectArraysEqual(
+        frame1.dataSync(),
+        tf.node.decodeGif(contents).slice(1, 1).dataSync());
+    decoder.dispose();
+  });
+
+  it('does not leak tensors', () => {
+    const contents = createPartialFrameGif();
+    const numTensors = tf.memory().numTensors;
+    const decoder = tf.node.decodeGifFrames(contents);
+    while (decoder.hasNext()) {
+      decoder.next().dispose();
+    }
+    decoder.dispose();
+    expect(tf.memory().numTensors).toEqual(numTensors);
+  });
+
+  it('throws on invalid GIFs', () => {
+    expect(() => tf.node.decodeGifFrames(new Uint8Array([1, 2, 3])))
+        .toThrowError(/missing GIF header/);
+    const truncated =
+        new Uint8Array(fs.readFileSync('test_images/gif_test.gif'))
+            .subarray(0, 100);
+    expect(() => tf.node.decodeGifFrames(truncated))
+        .toThrowError(/Invalid GIF/);
+  });
+});
+
+describe('decodeGifFirstFrame', () => {
+  it('decodes the first frame', () => {
+    const numTensors = tf.memory().numTensors;
+    const frame = tf.node.decodeGifFirstFrame(
+        fs.readFileSync('test_images/gif_test.gif'));
+    expect(frame.dtype).toBe('int32');
+    expect(frame.shape).toEqual([2, 2, 3]);
+    tf.test_util.expectArraysEqual(frame.dataSync(), FRAME_0);
+    expect(tf.memory().numTensors).toEqual(numTensors + 1);
+  });
+
+  it('ignores data after the first frame', () => {
+    const gif = new Uint8Array(fs.readFileSync('test_images/gif_test.gif'));
+    // Corrupt the second frame.
+    const contents = new Uint8Array(gif.subarray(0, 0x70));
+    const frame = tf.node.decodeGifFirstFrame(contents);
+    tf.test_util.expectArraysEqual(frame.dataSync(), FRAME_0);
+  });
+});
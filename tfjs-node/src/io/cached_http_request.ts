@@ -0,0 +1,359 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tfc from '@tensorflow/tfjs-core';
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as http from 'http';
+import * as https from 'https';
+import * as os from 'os';
+import {join} from 'path';
+import {parse as parseURL, resolve as resolveURL} from 'url';
+import {promisify} from 'util';
+
+import {mapWithConcurrency} from './io_utils';
+
+const close = promisify(fs.close);
+const mkdir = promisify(fs.mkdir);
+const open = promisify(fs.open);
+const read = promisify(fs.read);
+const readFile = promisify(fs.readFile);
+const rename = promisify(fs.rename);
+const stat = promisify(fs.stat);
+const unlink = promisify(fs.unlink);
+const writeFile = promisify(fs.writeFile);
+
+const MAX_REDIRECTS = 5;
+
+export interface CachedHTTPRequestOptions {
+  /**
+   * Directory of the on-disk cache. It is created if it does not exist, and
+   * can be shared by several models and processes.
+   *
+   * Default: `tfjs-node-http-cache` in the OS temporary directory.
+   */
+  cacheDir?: string;
+
+  /**
+   * Maximum number of weight files that are downloaded at the same time.
+   *
+   * Default: `4`.
+   */
+  maxConcurrency?: number;
+
+  /** Extra HTTP request headers, e.g., for authorization. */
+  headers?: {[name: string]: string};
+
+  /**
+   * A path prefix for the weight files. By default, weight files are
+   * resolved relative to the URL of the model JSON file.
+   */
+  weightPathPrefix?: string;
+}
+
+/** Metadata of a cached URL. The content is stored under its hash. */
+interface CacheEntry {
+  url: string;
+  etag?: string;
+  lastModified?: string;
+  sha256: string;
+}
+
+/**
+ * An IOHandler that loads models over HTTP(S) through an on-disk cache.
+ *
+ * Users are expected to access this class through the `cachedHTTPRequest()`
+ * factory method instead.
+ */
+export class CachedHTTPRequest implements tfc.io.IOHandler {
+  private readonly cacheDir: string;
+  private readonly maxConcurrency: number;
+  private readonly headers: {[name: string]: string};
+  private readonly weightPathPrefix: string;
+
+  /** Number of bytes received over the network by the last `load()`. */
+  bytesDownloaded = 0;
+  /** Number of files of the last `load()` that were served by the cache. */
+  numCacheHits = 0;
+
+  constructor(readonly path: string, options?: CachedHTTPRequestOptions) {
+    options = options == null ? {} : options;
+    this.cacheDir = options.cacheDir == null ?
+        join(os.tmpdir(), 'tfjs-node-http-cache') :
+        options.cacheDir;
+    this.maxConcurrency =
+        options.maxConcurrency == null ? 4 : options.maxConcurrency;
+    this.headers = options.headers == null ? {} : options.headers;
+    this.weightPathPrefix = options.weightPathPrefix;
+    tfc.util.assert(
+        Number.isInteger(this.maxConcurrency) && this.maxConcurrency > 0,
+        () => `Expected maxConcurrency to be a positive integer, but got ` +
+            `${this.maxConcurrency}`);
+  }
+
+  async load(): Promise<tfc.io.ModelArtifacts> {
+    this.bytesDownloaded = 0;
+    this.numCacheHits = 0;
+    await mkdirIfNotExists(this.cacheDir);
+    await mkdirIfNotExists(join(this.cacheDir, 'entries'));
+    await mkdirIfNotExists(join(this.cacheDir, 'blobs'));
+
+    const modelJSON =
+        JSON.parse(await readFile(await this.fetch(this.path), 'utf8'));
+    const modelArtifacts: tfc.io.ModelArtifacts = {
+      modelTopology: modelJSON.modelTopology,
+      format: modelJSON.format,
+      generatedBy: modelJSON.generatedBy,
+      convertedBy: modelJSON.convertedBy
+    };
+    const weightsManifest =
+        modelJSON.weightsManifest as tfc.io.WeightsManifestConfig;
+    if (weightsManifest != null) {
+      const prefix =
+          this.weightPathPrefix == null ? this.path : this.weightPathPrefix;
+      const weightURLs: string[] = [];
+      const weightSpecs: tfc.io.WeightsManifestEntry[] = [];
+      for (const group of weightsManifest) {
+        for (const path of group.paths) {
+          weightURLs.push(
+              this.weightPathPrefix == null ? resolveURL(prefix, path) :
+                                              prefix + path);
+        }
+        weightSpecs.push(...group.weights);
+      }
+      const blobPaths = await mapWithConcurrency(
+          weightURLs, this.maxConcurrency, url => this.fetch(url));
+      modelArtifacts.weightSpecs = weightSpecs;
+      modelArtifacts.weightData = await readFilesInto(blobPaths);
+    }
+    return modelArtifacts;
+  }
+
+  /**
+   * Returns the path of a cached file with the current content of `url`.
+   * A cached copy is revalidated with the server by its ETag or
+   * Last-Modified date and downloaded again only if it changed.
+   */
+  private async fetch(url: string): Promise<string> {
+    const entryPath =
+        join(this.cacheDir, 'entries', `${sha256(url)}.json`);
+    let entry: CacheEntry = null;
+    try {
+      entry = JSON.parse(await readFile(entryPath, 'utf8'));
+      await stat(this.blobPath(entry.sha256));
+    } catch (e) {
+      entry = null;
+    }
+
+    const headers = {...this.headers};
+    if (entry != null && entry.etag != null) {
+      headers['If-None-Match'] = entry.etag;
+    }
+    if (entry != null && entry.lastModified != null) {
+      headers['If-Modified-Since'] = entry.lastModified;
+    }
+    const response = await get(url, headers);
+    if (response.statusCode === 304 && entry != null) {
+      response.resume();
+      this.numCacheHits++;
+      return this.blobPath(entry.sha256);
+    }
+    if (response.statusCode !== 200) {
+      response.resume();
+      throw new Error(
+          `Request to ${url} failed with status code ` +
+          `${response.statusCode}.`);
+    }
+
+    const hash = await this.download(url, response);
+    const newEntry: CacheEntry = {url, sha256: hash};
+    const etag = response.headers['etag'] as string;
+    if (etag != null) {
+      newEntry.etag = etag;
+    }
+    const lastModified = response.headers['last-modified'] as string;
+    if (lastModified != null) {
+      newEntry.lastModified = lastModified;
+    }
+    await writeFileAtomically(entryPath, JSON.stringify(newEntry));
+    return this.blobPath(hash);
+  }
+
+  /**
+   * Streams a response body to the cache and returns its SHA-256, which is
+   * the name of the file. Identical content is stored once. A body that is
+   * cut short, by an aborted transfer or fewer bytes than `Content-Length`,
+   * is never stored.
+   */
+  private download(url: string, response: http.IncomingMessage):
+      Promise<string> {
+    const tempPath = join(
+        this.cacheDir, 'blobs',
+        `.download-${process.pid}-${crypto.randomBytes(8).toString('hex')}`);
+    const hash = crypto.createHash('sha256');
+    const file = fs.createWriteStream(tempPath);
+    const contentLength = response.headers['content-length'];
+    let numBytes = 0;
+    return new Promise<string>((resolve, reject) => {
+      let failed = false;
+      const fail = (e: Error) => {
+        if (failed) {
+          return;
+        }
+        failed = true;
+        file.destroy();
+        unlink(tempPath).catch(() => {}).then(() => reject(e));
+      };
+      response.on('data', (chunk: Buffer) => {
+        hash.update(chunk);
+        numBytes += chunk.length;
+        this.bytesDownloaded += chunk.length;
+      });
+      response.on('aborted', () => fail(new Error(
+          `Download of ${url} was aborted after ${numBytes} bytes.`)));
+      response.on('error', fail);
+      file.on('error', fail);
+      file.on('finish', () => {
+        if (failed) {
+          return;
+        }
+        if (!response.complete ||
+            (contentLength != null && numBytes !== Number(contentLength))) {
+          fail(new Error(
+              `Download of ${url} is incomplete (received ${numBytes} ` +
+              `bytes).`));
+          return;
+        }
+        const digest = hash.digest('hex');
+        rename(tempPath, this.blobPath(digest))
+            .then(() => resolve(digest), fail);
+      });
+      response.pipe(file);
+    });
+  }
+
+  private blobPath(hash: string): string {
+    return join(this.cacheDir, 'blobs', hash);
+  }
+}
+
+function sha256(value: string): string {
+  return crypto.createHash('sha256').update(value).digest('hex');
+}
+
+async function mkdirIfNotExists(path: string) {
+  try {
+    await mkdir(path);
+  } catch (e) {
+    if (e.code !== 'EEXIST') {
+      throw e;
+    }
+  }
+}
+
+/**
+ * Writes a file through a temporary file, so that concurrent readers never
+ * see a partially written file.
+ */
+async function writeFileAtomically(path: string, data: string) {
+  const tempPath = `${path}.${process.pid}.tmp`;
+  await writeFile(tempPath, data, 'utf8');
+  await rename(tempPath, path);
+}
+
+/** Issues a GET request and follows redirects. */
+function get(
+    url: string, headers: {[name: string]: string},
+    numRedirects = 0): Promise<http.IncomingMessage> {
+  return new Promise<http.IncomingMessage>((resolve, reject) => {
+    const client = url.startsWith('https:') ? https : http;
+    const request = client.get({...parseURL(url), headers}, response => {
+      const location = response.headers.location;
+      if (response.statusCode >= 300 && response.statusCode < 400 &&
+          response.statusCode !== 304 && location != null) {
+        response.resume();
+        if (numRedirects >= MAX_REDIRECTS) {
+          reject(new Error(`Too many redirects while requesting ${url}.`));
+          return;
+        }
+        get(resolveURL(url, location), headers, numRedirects + 1)
+            .then(resolve, reject);
+        return;
+      }
+      resolve(response);
+    });
+    request.on('error', reject);
+  });
+}
+
+/**
+ * Reads files back to back into one ArrayBuffer, without concatenating
+ * intermediate buffers.
+ */
+async function readFilesInto(paths: string[]): Promise<ArrayBuffer> {
+  const sizes: number[] = [];
+  for (const path of paths) {
+    sizes.push((await stat(path)).size);
+  }
+  const weightData =
+      new ArrayBuffer(sizes.reduce((sum, size) => sum + size, 0));
+  let offset = 0;
+  for (let i = 0; i < paths.length; ++i) {
+    const fd = await open(paths[i], 'r');
+    try {
+      const view = new Uint8Array(weightData, offset, sizes[i]);
+      let position = 0;
+      while (position < sizes[i]) {
+        const {bytesRead} =
+            await read(fd, view, position, sizes[i] - position, position);
+        if (bytesRead === 0) {
+          throw new Error(`Unexpected end of file ${paths[i]}.`);
+        }
+        position += bytesRead;
+      }
+    } finally {
+      await close(fd);
+    }
+    offset += sizes[i];
+  }
+  return weightData;
+}
+
+/**
+ * Factory function for an HTTP(S) IOHandler with an on-disk cache.
+ *
+ * Weight files are downloaded concurrently and streamed straight to a
+ * content-addressed cache directory. Later loads revalidate every file with
+ * the server (by ETag or Last-Modified date) and read unchanged files from
+ * the cache instead of downloading them again.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const model = await tf.loadLayersModel(tf.io.cachedHTTPRequest(
+ *     'https://example.com/my-model/model.json',
+ *     {cacheDir: '/var/cache/models'}));
+ * ```
+ *
+ * @param path URL of the model JSON file.
+ * @param options Optional configuration arguments.
+ */
+export function cachedHTTPRequest(
+    path: string, options?: CachedHTTPRequestOptions): CachedHTTPRequest {
+  return new CachedHTTPRequest(path, options);
+}
@@ -0,0 +1,228 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tfc from '@tensorflow/tfjs-core';
+import * as tfl from '@tensorflow/tfjs-layers';
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as http from 'http';
+import {AddressInfo} from 'net';
+import * as rimraf from 'rimraf';
+import {promisify} from 'util';
+
+import * as tfn from '../index';
+
+describe('cachedHTTPRequest', () => {
+  const mkdtemp = promisify(fs.mkdtemp);
+  const rimrafPromise = promisify(rimraf);
+
+  const modelTopology: {} = {
+    'class_name': 'Sequential',
+    'keras_version': '2.1.4',
+    'config': [{
+      'class_name': 'Dense',
+      'config': {
+        'name': 'dense',
+        'dtype': 'float32',
+        'activation': 'linear',
+        'trainable': true,
+        'units': 1,
+        'batch_input_shape': [null, 3],
+        'use_bias': true
+      }
+    }],
+    'backend': 'tensorflow'
+  };
+  const weightsManifest: tfc.io.WeightsManifestConfig = [{
+    paths: ['weights/shard1', 'weights/shard2'],
+    weights: [
+      {name: 'dense/kernel', shape: [3, 1], dtype: 'float32'},
+      {name: 'dense/bias', shape: [1], dtype: 'float32'}
+    ]
+  }];
+
+  // Files served by the local stand-in model store.
+  let files: {[path: string]: Buffer};
+  let numRequests: number;
+  let numNotModified: number;
+  let numInFlight: number;
+  let maxInFlight: number;
+  let responseDelayMillis: number;
+  // Paths whose responses are cut off after half of the content.
+  let truncatedPaths: string[];
+  let server: http.Server;
+  let baseURL: string;
+  let cacheDir: string;
+
+  beforeEach(async () => {
+    files = {
+      '/model.json':
+          Buffer.from(JSON.stringify({modelTopology, weightsManifest})),
+      '/weights/shard1': Buffer.from(new Float32Array([1, 3, 3]).buffer),
+      '/weights/shard2': Buffer.from(new Float32Array([7]).buffer)
+    };
+    numRequests = 0;
+    numNotModified = 0;
+    numInFlight = 0;
+    maxInFlight = 0;
+    responseDelayMillis = 0;
+    truncatedPaths = [];
+    server = http.createServer((request, response) => {
+      numRequests++;
+      numInFlight++;
+      maxInFlight = Math.max(maxInFlight, numInFlight);
+      setTimeout(() => {
+        numInFlight--;
+        const content = files[request.url];
+        if (content == null) {
+          response.writeHead(404);
+          response.end();
+          return;
+        }
+        const etag = `"${
+            crypto.createHash('md5').update(content).digest('hex')}"`;
+        if (request.headers['if-none-match'] === etag) {
+          numNotModified++;
+          response.writeHead(304);
+          response.end();
+          return;
+        }
+        if (truncatedPaths.indexOf(request.url) !== -1) {
+          response.writeHead(
+              200, {'ETag': etag, 'Content-Length': content.length});
+          response.write(content.slice(0, content.length / 2), () => {
+            response.destroy();
+          });
+          return;
+        }
+        response.writeHead(200, {'ETag': etag});
+        response.end(content);
+      }, responseDelayMillis);
+    });
+    await new Promise(resolve => server.listen(0, '127.0.0.1', resolve));
+    baseURL = `http://127.0.0.1:${(server.address() as AddressInfo).port}`;
+    cacheDir = await mkdtemp('/tmp/tfjs-node-http-cache-');
+  });
+
+  afterEach(async () => {
+    await new Promise(resolve => server.close(resolve));
+    await rimrafPromise(cacheDir);
+  });
+
+  it('Loads model artifacts', async () => {
+    const handler =
+        tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir});
+    const modelArtifacts = await handler.load();
+    expect(modelArtifacts.modelTopology).toEqual(modelTopology);
+    expect(modelArtifacts.weightSpecs).toEqual(weightsManifest[0].weights);
+    expect(new Float32Array(modelArtifacts.weightData))
+        .toEqual(new Float32Array([1, 3, 3, 7]));
+    expect(numRequests).toEqual(3);
+    expect(handler.numCacheHits).toEqual(0);
+    expect(handler.bytesDownloaded)
+        .toEqual(files['/model.json'].length + 16);
+  });
+
+  it('Serves unchanged files from the cache', async () => {
+    await tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir})
+        .load();
+    const handler =
+        tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir});
+    const modelArtifacts = await handler.load();
+    expect(new Float32Array(modelArtifacts.weightData))
+        .toEqual(new Float32Array([1, 3, 3, 7]));
+    expect(numNotModified).toEqual(3);
+    expect(handler.numCacheHits).toEqual(3);
+    expect(handler.bytesDownloaded).toEqual(0);
+  });
+
+  it('Downloads changed files again', async () => {
+    await tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir})
+        .load();
+    files['/weights/shard2'] = Buffer.from(new Float32Array([8]).buffer);
+    const handler =
+        tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir});
+    const modelArtifacts = await handler.load();
+    expect(new Float32Array(modelArtifacts.weightData))
+        .toEqual(new Float32Array([1, 3, 3, 8]));
+    expect(handler.numCacheHits).toEqual(2);
+    expect(handler.bytesDownloaded).toEqual(4);
+  });
+
+  it('Bounds the number of concurrent downloads', async () => {
+    const paths: string[] = [];
+    for (let i = 0; i < 6; ++i) {
+      paths.push(`shard${i}`);
+      files[`/shard${i}`] = Buffer.from(new Float32Array([i]).buffer);
+    }
+    files['/model.json'] = Buffer.from(JSON.stringify({
+      modelTopology,
+      weightsManifest: [{
+        paths,
+        weights: [{name: 'w', shape: [6], dtype: 'float32'}]
+      }]
+    }));
+    responseDelayMillis = 20;
+    const modelArtifacts =
+        await tfn.io
+            .cachedHTTPRequest(
+                `${baseURL}/model.json`, {cacheDir, maxConcurrency: 2})
+            .load();
+    expect(new Float32Array(modelArtifacts.weightData))
+        .toEqual(new Float32Array([0, 1, 2, 3, 4, 5]));
+    expect(maxInFlight).toEqual(2);
+  });
+
+  it('Rejects on HTTP errors', async done => {
+    try {
+      await tfn.io.cachedHTTPRequest(`${baseURL}/missing.json`, {cacheDir})
+          .load();
+      done.fail('Loading a missing model succeeded unexpectedly.');
+    } catch (e) {
+      expect(e.message).toMatch(/status code 404/);
+      done();
+    }
+  });
+
+  it('Does not cache truncated downloads', async () => {
+    const handler =
+        tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir});
+    truncatedPaths = ['/weights/shard1'];
+    let error: Error;
+    try {
+      await handler.load();
+    } catch (e) {
+      error = e;
+    }
+    expect(error.message).toMatch(/weights\/shard1/);
+
+    // The truncated file was not cached, so it is downloaded again in full
+    // rather than revalidated.
+    truncatedPaths = [];
+    const modelArtifacts = await handler.load();
+    expect(new Float32Array(modelArtifacts.weightData)).toEqual(
+        new Float32Array([1, 3, 3, 7]));
+    expect(handler.bytesDownloaded).toBeGreaterThanOrEqual(3 * 4);
+  });
+
+  it('Loads a LayersModel', async () => {
+    const model = await tfl.loadLayersModel(
+        tfn.io.cachedHTTPRequest(`${baseURL}/model.json`, {cacheDir}));
+    expect(model.inputs[0].shape).toEqual([null, 3]);
+    expect(model.outputs[0].shape).toEqual([null, 1]);
+  });
+});
@@ -17,16 +17,56 @@
 
 import * as tfc from '@tensorflow/tfjs-core';
 import * as fs from 'fs';
-import {dirname, join, resolve} from 'path';
+import {basename, dirname, join, resolve} from 'path';
 import {promisify} from 'util';
 
 const stat = promisify(fs.stat);
 const writeFile = promisify(fs.writeFile);
 const readFile = promisify(fs.readFile);
 const mkdir = promisify(fs.mkdir);
+const open = promisify(fs.open);
+const write = promisify(fs.write);
+const close = promisify(fs.close);
+const rename = promisify(fs.rename);
+const unlink = promisify(fs.unlink);
 
 // tslint:disable-next-line:max-line-length
-import {getModelArtifactsInfoForJSON, toArrayBuffer} from './io_utils';
+import {getModelArtifactsInfoForJSON, mapWithConcurrency, toArrayBuffer} from './io_utils';
+
+export interface FileSystemSaveOptions {
+  /**
+   * Maximum size in bytes of a weight file. Weights that do not fit are
+   * split over several files.
+   *
+   * Default: all weights are written to a single `weights.bin` file.
+   */
+  shardSizeBytes?: number;
+
+  /**
+   * Maximum number of weight files that are written at the same time.
+   *
+   * Default: `4`.
+   */
+  maxConcurrency?: number;
+}
+
+/**
+ * The bytes of one or more weights to be saved. `read()` is called once,
+ * when the bytes are first needed.
+ */
+export interface WeightSource {
+  byteLength: number;
+  read: () => Promise<Uint8Array>;
+}
+
+/** A byte range of a `WeightSource` that is stored in a weight file. */
+interface ShardPiece {
+  source: number;
+  begin: number;
+  end: number;
+}
+
+let nextTempFileId = 0;
 
 function doesNotExistHandler(name: string): (e: NodeJS.ErrnoException) =>
     never {
@@ -44,6 +84,7 @@ export class NodeFileSystem implements tfc.io.IOHandler {
   static readonly URL_SCHEME = 'file://';
 
   protected readonly path: string|string[];
+  protected readonly saveOptions: FileSystemSaveOptions;
 
   readonly MODEL_JSON_FILENAME = 'model.json';
   readonly WEIGHTS_BINARY_FILENAME = 'weights.bin';
@@ -66,8 +107,15 @@ export class NodeFileSystem implements tfc.io.IOHandler {
    *       an Array of two paths is expected: the first path should point to the
    *       .pb file and the second path should point to the weight manifest
    *       JSON file.
+   * @param saveOptions Optional configuration for saving.
    */
-  constructor(path: string|string[]) {
+  constructor(path: string|string[], saveOptions?: FileSystemSaveOptions) {
+    this.saveOptions = saveOptions == null ? {} : saveOptions;
+    tfc.util.assert(
+        this.saveOptions.shardSizeBytes == null ||
+            this.saveOptions.shardSizeBytes > 0,
+        () => `Expected shardSizeBytes to be positive, but got ` +
+            `${this.saveOptions.shardSizeBytes}`);
     if (Array.isArray(path)) {
       tfc.util.assert(
           path.length === 2,
@@ -85,8 +133,6 @@ export class NodeFileSystem implements tfc.io.IOHandler {
       throw new Error('Cannot perform saving to multiple paths.');
     }
 
-    await this.createOrVerifyDirectory();
-
     if (modelArtifacts.modelTopology instanceof ArrayBuffer) {
       throw new Error(
           'NodeFileSystem.save() does not support saving model topology ' +
@@ -94,19 +140,14 @@ export class NodeFileSystem implements tfc.io.IOHandler {
       // TODO(cais, nkreeger): Implement this. See
       //   https://github.com/tensorflow/tfjs/issues/343
     } else {
-      const weightsBinPath = join(this.path, this.WEIGHTS_BINARY_FILENAME);
-      const weightsManifest = [{
-        paths: [this.WEIGHTS_BINARY_FILENAME],
-        weights: modelArtifacts.weightSpecs
-      }];
-      const modelJSON = {
-        modelTopology: modelArtifacts.modelTopology,
-        weightsManifest,
-      };
-      const modelJSONPath = join(this.path, this.MODEL_JSON_FILENAME);
-      await writeFile(modelJSONPath, JSON.stringify(modelJSON), 'utf8');
-      await writeFile(
-          weightsBinPath, Buffer.from(modelArtifacts.weightData), 'binary');
+      // The weight files are written from views of `weightData`.
+      const weightData = modelArtifacts.weightData == null ?
+          new Uint8Array(0) :
+          new Uint8Array(modelArtifacts.weightData);
+      await this.saveWeightSources(
+          {modelTopology: modelArtifacts.modelTopology},
+          modelArtifacts.weightSpecs,
+          [{byteLength: weightData.byteLength, read: async () => weightData}]);
 
       return {
         // TODO(cais): Use explicit tfc.io.ModelArtifactsInfo type below once it
@@ -116,6 +157,114 @@ export class NodeFileSystem implements tfc.io.IOHandler {
       };
     }
   }
+  /**
+   * Saves a model whose weight data is provided by `sources` instead of a
+   * single ArrayBuffer, so that the weights never need to be concatenated in
+   * memory. The bytes of the sources are concatenated in order.
+   *
+   * Writing `model.json` commits the save. Weight files are first written
+   * under temporary names and renamed when all of them are complete. Their
+   * names never collide with the weight files of the `model.json` being
+   * replaced, so a reader sees either the previous model or the new one,
+   * never a mix. Weight files of the previous model are removed after the
+   * new `model.json` is in place.
+   *
+   * @param modelJSON The content of `model.json`, except `weightsManifest`.
+   * @param weightSpecs The specs of the weights in `sources`.
+   * @param sources The weight data.
+   */
+  async saveWeightSources(
+      modelJSON: {}, weightSpecs: tfc.io.WeightsManifestEntry[],
+      sources: WeightSource[]): Promise<void> {
+    if (Array.isArray(this.path)) {
+      throw new Error('Cannot perform saving to multiple paths.');
+    }
+    await this.createOrVerifyDirectory();
+
+    const shards = assignShardPieces(sources, this.saveOptions.shardSizeBytes);
+    const modelJSONPath = join(this.path, this.MODEL_JSON_FILENAME);
+    const previousPaths = await readWeightPaths(modelJSONPath);
+    let paths = this.getWeightFileNames(shards.length, '');
+    if (paths.some(path => previousPaths.indexOf(path) !== -1)) {
+      paths = this.getWeightFileNames(
+          shards.length, `-${Date.now().toString(36)}`);
+    }
+    const maxConcurrency = this.saveOptions.maxConcurrency == null ?
+        4 :
+        this.saveOptions.maxConcurrency;
+    const dirName = this.path;
+
+    // Every source is read once, and released when its last piece is written.
+    const numPieces = sources.map(() => 0);
+    shards.forEach(
+        pieces => pieces.forEach(piece => numPieces[piece.source]++));
+    const reads: Array<Promise<Uint8Array>> = [];
+    const writePieces = async (fd: number, pieces: ShardPiece[]) => {
+      let position = 0;
+      for (const piece of pieces) {
+        if (reads[piece.source] == null) {
+          reads[piece.source] = sources[piece.source].read();
+        }
+        const bytes =
+            (await reads[piece.source]).subarray(piece.begin, piece.end);
+        if (--numPieces[piece.source] === 0) {
+          reads[piece.source] = null;
+        }
+        let offset = 0;
+        while (offset < bytes.length) {
+          const {bytesWritten} =
+              await write(fd, bytes, offset, bytes.length - offset, position);
+          offset += bytesWritten;
+          position += bytesWritten;
+        }
+      }
+    };
+
+    const tempPaths = paths.map(path => getTempPath(join(dirName, path)));
+    const writeShard = async (i: number) => {
+      const fd = await open(tempPaths[i], 'w');
+      try {
+        await writePieces(fd, shards[i]);
+      } finally {
+        await close(fd);
+      }
+    };
+    try {
+      // Every write has settled when this throws.
+      await mapWithConcurrency(
+          shards.map((_, i) => i), maxConcurrency, writeShard);
+      await Promise.all(tempPaths.map(
+          (tempPath, i) => rename(tempPath, join(dirName, paths[i]))));
+      const weightsManifest = [{paths, weights: weightSpecs}];
+      await writeFileAtomically(
+          modelJSONPath, JSON.stringify({...modelJSON, weightsManifest}));
+    } catch (e) {
+      // None of these files is referenced by the previous model.json.
+      const newPaths = paths.map(path => join(dirName, path));
+      await Promise.all([...tempPaths, ...newPaths].map(
+          path => unlink(path).catch(() => {})));
+      throw e;
+    }
+
+    // Weight files outside of the model directory are left alone.
+    await Promise.all(
+        previousPaths
+            .filter(
+                path => paths.indexOf(path) === -1 && basename(path) === path)
+            .map(path => unlink(join(dirName, path)).catch(() => {})));
+  }
+
+  private getWeightFileNames(numShards: number, version: string): string[] {
+    if (numShards === 1) {
+      return [this.WEIGHTS_BINARY_FILENAME.replace(/\.bin$/, `${version}.bin`)];
+    }
+    const names: string[] = [];
+    for (let i = 0; i < numShards; ++i) {
+      names.push(`group1-shard${i + 1}of${numShards}${version}.bin`);
+    }
+    return names;
+  }
+
   async load(): Promise<tfc.io.ModelArtifacts> {
     return Array.isArray(this.path) ? this.loadBinaryModel() :
                                       this.loadJSONModel();
@@ -223,6 +372,70 @@ export class NodeFileSystem implements tfc.io.IOHandler {
   }
 }
 
+/**
+ * Splits the concatenated bytes of `sources` into weight files of at most
+ * `shardSizeBytes` bytes. Always returns at least one (possibly empty) file.
+ */
+function assignShardPieces(
+    sources: WeightSource[], shardSizeBytes?: number): ShardPiece[][] {
+  const shardSize = shardSizeBytes == null ? Infinity : shardSizeBytes;
+  const shards: ShardPiece[][] = [];
+  let pieces: ShardPiece[] = [];
+  let numBytes = 0;
+  sources.forEach((source, i) => {
+    let begin = 0;
+    while (begin < source.byteLength) {
+      const end = Math.min(source.byteLength, begin + shardSize - numBytes);
+      pieces.push({source: i, begin, end});
+      numBytes += end - begin;
+      begin = end;
+      if (numBytes === shardSize) {
+        shards.push(pieces);
+        pieces = [];
+        numBytes = 0;
+      }
+    }
+  });
+  if (pieces.length > 0 || shards.length === 0) {
+    shards.push(pieces);
+  }
+  return shards;
+}
+
+/**
+ * Returns the weight file paths of an existing `model.json`, or an empty
+ * array if there is no readable `model.json`.
+ */
+async function readWeightPaths(modelJSONPath: string): Promise<string[]> {
+  let modelJSON: {weightsManifest?: tfc.io.WeightsManifestConfig};
+  try {
+    modelJSON = JSON.parse(await readFile(modelJSONPath, 'utf8'));
+  } catch (e) {
+    return [];
+  }
+  const paths: string[] = [];
+  if (Array.isArray(modelJSON.weightsManifest)) {
+    for (const group of modelJSON.weightsManifest) {
+      paths.push(...group.paths);
+    }
+  }
+  return paths;
+}
+
+function getTempPath(path: string): string {
+  return `${path}.${process.pid}-${nextTempFileId++}.tmp`;
+}
+
+/**
+ * Writes a file through a temporary file, so that readers never see a
+ * partially written file.
+ */
+async function writeFileAtomically(path: string, data: string) {
+  const tempPath = getTempPath(path);
+  await writeFile(tempPath, data, 'utf8');
+  await rename(tempPath, path);
+}
+
 export const nodeFileSystemRouter = (url: string|string[]) => {
   if (Array.isArray(url)) {
     if (url.every(
@@ -260,7 +473,11 @@ export const nodeFileSystemRouter = (url: string|string[]) => {
  *       an Array of two paths is expected: the first path should point to the
  *        .pb file and the second path should point to the weight manifest
  *       JSON file.
+ * @param saveOptions Optional configuration for saving, e.g., the maximum
+ *   size of a weight file.
  */
-export function fileSystem(path: string|string[]): NodeFileSystem {
-  return new NodeFileSystem(path);
+export function fileSystem(
+    path: string|string[], saveOptions?: FileSystemSaveOptions):
+    NodeFileSystem {
+  return new NodeFileSystem(path, saveOptions);
 }
@@ -166,6 +166,81 @@ describe('File system IOHandler', () => {
         .catch(err => done.fail(err.stack));
   });
 
+  it('save-load round trip: sharded weight files', async done => {
+    const weightData = new Float32Array([1, 2, 3, 4]);
+    await tfn.io.fileSystem(testDir, {shardSizeBytes: 6}).save({
+      modelTopology: modelTopology1,
+      weightSpecs: weightSpecs1,
+      weightData: weightData.buffer,
+    });
+
+    const modelJSONPath = path.join(testDir, 'model.json');
+    const modelJSON = JSON.parse(await readFile(modelJSONPath, 'utf8'));
+    expect(modelJSON.weightsManifest[0].paths).toEqual([
+      'group1-shard1of3.bin', 'group1-shard2of3.bin', 'group1-shard3of3.bin'
+    ]);
+    expect((await readFile(path.join(testDir, 'group1-shard3of3.bin'))).length)
+        .toEqual(4);
+    // No temporary files are left behind.
+    expect(fs.readdirSync(testDir).filter(f => f.endsWith('.tmp'))).toEqual([]);
+
+    const modelArtifacts =
+        await tfc.io.getLoadHandlers(`file://${modelJSONPath}`)[0].load();
+    expect(modelArtifacts.weightSpecs).toEqual(weightSpecs1);
+    expect(new Float32Array(modelArtifacts.weightData)).toEqual(weightData);
+    done();
+  });
+
+  it('save overwrites a model with more weight files', async () => {
+    const modelJSONPath = path.join(testDir, 'model.json');
+    await tfn.io.fileSystem(testDir, {shardSizeBytes: 6}).save({
+      modelTopology: modelTopology1,
+      weightSpecs: weightSpecs1,
+      weightData: new Float32Array([1, 2, 3, 4]).buffer,
+    });
+    const weightData = new Float32Array([5, 6, 7, 8]);
+    await tfn.io.fileSystem(testDir).save({
+      modelTopology: modelTopology1,
+      weightSpecs: weightSpecs1,
+      weightData: weightData.buffer,
+    });
+
+    // The weight files of the first save are removed.
+    const modelJSON = JSON.parse(await readFile(modelJSONPath, 'utf8'));
+    expect(fs.readdirSync(testDir).sort())
+        .toEqual(['model.json', ...modelJSON.weightsManifest[0].paths].sort());
+    const modelArtifacts =
+        await tfc.io.getLoadHandlers(`file://${modelJSONPath}`)[0].load();
+    expect(new Float32Array(modelArtifacts.weightData)).toEqual(weightData);
+  });
+
+  it('save does not replace the weight files of the model', async () => {
+    const modelJSONPath = path.join(testDir, 'model.json');
+    await tfn.io.fileSystem(testDir).save({
+      modelTopology: modelTopology1,
+      weightSpecs: weightSpecs1,
+      weightData: new Float32Array([1, 2, 3, 4]).buffer,
+    });
+    const firstPaths =
+        JSON.parse(await readFile(modelJSONPath, 'utf8')).weightsManifest[0]
+            .paths;
+    await tfn.io.fileSystem(testDir).save({
+      modelTopology: modelTopology1,
+      weightSpecs: weightSpecs1,
+      weightData: new Float32Array([5, 6, 7, 8]).buffer,
+    });
+
+    // The new weights never overwrite the files that the previous model.json
+    // points to.
+    const secondPaths =
+        JSON.parse(await readFile(modelJSONPath, 'utf8')).weightsManifest[0]
+            .paths;
+    expect(secondPaths.length).toEqual(1);
+    expect(secondPaths[0]).not.toEqual(firstPaths[0]);
+    expect(fs.readdirSync(testDir).sort())
+        .toEqual(['model.json', secondPaths[0]].sort());
+  });
+
   describe('load json model', () => {
     it('load: two weight files', async done => {
       const weightsManifest: tfc.io.WeightsManifestConfig = [
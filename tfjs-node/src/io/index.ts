@@ -19,5 +19,6 @@
  * Public exports from the `io` module.
  */
 
+export {cachedHTTPRequest} from './cached_http_request';
 export {fileSystem} from './file_system';
 export {nodeHTTPRequest} from './node_http';
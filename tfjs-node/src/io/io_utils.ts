@@ -52,6 +52,45 @@ export function toArrayBuffer(buf: Buffer|Buffer[]): ArrayBuffer {
   }
 }
 
+/**
+ * Calls `fn` for every item with at most `concurrency` calls in flight and
+ * returns the results in the order of `items`.
+ *
+ * If a call fails, no further calls are started, and the first error is
+ * thrown once the calls in flight have settled, so that callers can clean up
+ * after all of them.
+ */
+export async function mapWithConcurrency<T, U>(
+    items: T[], concurrency: number, fn: (item: T) => Promise<U>):
+    Promise<U[]> {
+  const results: U[] = new Array(items.length);
+  let next = 0;
+  let failed = false;
+  let error: Error;
+  const worker = async () => {
+    while (next < items.length && !failed) {
+      const index = next++;
+      try {
+        results[index] = await fn(items[index]);
+      } catch (e) {
+        if (!failed) {
+          failed = true;
+          error = e;
+        }
+      }
+    }
+  };
+  const workers: Array<Promise<void>> = [];
+  for (let i = 0; i < Math.min(concurrency, items.length); ++i) {
+    workers.push(worker());
+  }
+  await Promise.all(workers);
+  if (failed) {
+    throw error;
+  }
+  return results;
+}
+
 // TODO(cais): Use explicit tfc.io.ModelArtifactsInfo return type below once it
 // is available.
 /**
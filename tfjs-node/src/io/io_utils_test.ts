@@ -15,7 +15,7 @@
  * =============================================================================
  */
 
-import {toArrayBuffer, toBuffer} from './io_utils';
+import {mapWithConcurrency, toArrayBuffer, toBuffer} from './io_utils';
 
 describe('toBuffer', () => {
   it('Simple case', () => {
@@ -56,3 +56,34 @@ describe('toArrayBuffer', () => {
     expect(new Uint8Array(ab)).toEqual(new Uint8Array([]));
   });
 });
+
+describe('mapWithConcurrency', () => {
+  it('Returns the results in order', async () => {
+    const results = await mapWithConcurrency(
+        [30, 10, 20], 2,
+        value => new Promise<number>(
+            resolve => setTimeout(() => resolve(value * 2), value)));
+    expect(results).toEqual([60, 20, 40]);
+  });
+
+  it('Rejects after the calls in flight have settled', async () => {
+    const settled: number[] = [];
+    let error: Error;
+    try {
+      await mapWithConcurrency([1, 20, 3, 4], 2, value => new Promise(
+          (resolve, reject) => setTimeout(() => {
+            settled.push(value);
+            if (value === 1) {
+              reject(new Error('failed'));
+            } else {
+              resolve(value);
+            }
+          }, value)));
+    } catch (e) {
+      error = e;
+    }
+    expect(error.message).toEqual('failed');
+    // The call of 20 was in flight; no call is started after the failure.
+    expect(settled).toEqual([1, 20]);
+  });
+});
@@ -0,0 +1,43 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/**
+ * Release the native memory of tensors that are garbage collected without
+ * being disposed.
+ *
+ * By default, a tensor that is never disposed keeps its TensorFlow memory
+ * for the lifetime of the process. Once this mode is enabled, the backend
+ * frees the TensorFlow memory of every tensor created afterwards that
+ * becomes unreachable from JavaScript. Native tensor memory is reported to
+ * the V8 garbage collector, so leaked tensors cause collections.
+ *
+ * Tensors should still be disposed explicitly: garbage collection is not
+ * deterministic, and `tf.memory().numTensors` keeps counting tensors that
+ * were released this way. `tf.memory()` reports how many tensors and bytes
+ * were reclaimed as `numTensorsAutoReleased` and `numBytesAutoReleased`.
+ *
+ * Requires Node.js 14.6 or later (`FinalizationRegistry`).
+ */
+/**
+ * @doc {heading: 'Performance', subheading: 'Memory', namespace: 'node'}
+ */
+export function enableTensorAutoRelease(): void {
+  ensureTensorflowBackend();
+  nodeBackend().enableAutoRelease();
+}
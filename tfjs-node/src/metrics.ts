@@ -0,0 +1,139 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+const PREFIX = 'tfjs_node';
+
+/** Escapes a Prometheus label value. */
+function escapeLabel(value: string): string {
+  return value.replace(/\\/g, '\\\\')
+      .replace(/"/g, '\\"')
+      .replace(/\n/g, '\\n');
+}
+
+function header(name: string, type: string, help: string): string[] {
+  return [`# HELP ${name} ${help}`, `# TYPE ${name} ${type}`];
+}
+
+/**
+ * Return the metrics of the TensorFlow backend in the Prometheus text
+ * exposition format.
+ *
+ * The backend always counts, with lock-free native counters:
+ * - the executions and the latency histogram of every op type
+ *   (`tfjs_node_op_latency_seconds`),
+ * - the tensors allocated by ops and uploads, and their bytes,
+ * - the tensors created from JS data (uploads), the uploads whose data had
+ *   to be copied, and the copies to another device,
+ * - the reads of tensor data back to JS (readbacks), and their bytes,
+ * - the tensors that are alive and their bytes.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ * const http = require('http');
+ *
+ * http.createServer((req, res) => {
+ *   res.setHeader('Content-Type', 'text/plain; version=0.0.4');
+ *   res.end(tf.node.metrics());
+ * }).listen(9100);
+ * ```
+ */
+/**
+ * @doc {heading: 'Performance', subheading: 'Metrics', namespace: 'node'}
+ */
+export function metrics(): string {
+  ensureTensorflowBackend();
+  const binding = nodeBackend().binding;
+  const backendMetrics = binding.getMetrics();
+  const uploadStats = binding.getTensorUploadStats();
+  const memoryInfo = binding.getMemoryInfo();
+  const lines: string[] = [];
+
+  const latency = `${PREFIX}_op_latency_seconds`;
+  lines.push(...header(
+      latency, 'histogram', 'Latency of TensorFlow op executions.'));
+  for (const op of backendMetrics.ops) {
+    const label = `op="${escapeLabel(op.name)}"`;
+    let cumulativeCount = 0;
+    op.latencyBuckets.forEach((count, i) => {
+      cumulativeCount += count;
+      const bound = i === op.latencyBuckets.length - 1 ?
+          '+Inf' :
+          String(Math.pow(2, i) / 1e6);
+      lines.push(`${latency}_bucket{${label},le="${bound}"} ${
+          cumulativeCount}`);
+    });
+    lines.push(`${latency}_sum{${label}} ${op.totalNanos / 1e9}`);
+    lines.push(`${latency}_count{${label}} ${op.count}`);
+  }
+
+  const counters: Array<[string, string, number]> = [
+    [
+      'tensor_allocations_total', 'Tensors allocated by ops and uploads.',
+      backendMetrics.numAllocations
+    ],
+    [
+      'tensor_allocated_bytes_total',
+      'Bytes of tensors allocated by ops and uploads.',
+      backendMetrics.numAllocatedBytes
+    ],
+    [
+      'tensor_uploads_total', 'Tensors created from JS data.',
+      backendMetrics.numUploads
+    ],
+    [
+      'tensor_upload_bytes_total', 'Bytes of tensors created from JS data.',
+      backendMetrics.numUploadBytes
+    ],
+    [
+      'tensor_upload_copies_total',
+      'Uploads of typed arrays that TensorFlow could not share and copied.',
+      uploadStats.numCopied
+    ],
+    [
+      'tensor_device_copies_total', 'Uploaded tensors copied to a device.',
+      uploadStats.numDeviceCopies
+    ],
+    [
+      'tensor_readbacks_total', 'Reads of tensor data back to JS.',
+      backendMetrics.numReadbacks
+    ],
+    [
+      'tensor_readback_bytes_total', 'Bytes of tensor data read back to JS.',
+      backendMetrics.numReadbackBytes
+    ]
+  ];
+  for (const [name, help, value] of counters) {
+    lines.push(...header(`${PREFIX}_${name}`, 'counter', help));
+    lines.push(`${PREFIX}_${name} ${value}`);
+  }
+
+  const gauges: Array<[string, string, number]> = [
+    ['live_tensors', 'Tensors held by TensorFlow.', memoryInfo.numTensors],
+    [
+      'live_tensor_bytes', 'Bytes of the tensors held by TensorFlow.',
+      memoryInfo.numBytes
+    ]
+  ];
+  for (const [name, help, value] of gauges) {
+    lines.push(...header(`${PREFIX}_${name}`, 'gauge', help));
+    lines.push(`${PREFIX}_${name} ${value}`);
+  }
+  return lines.join('\n') + '\n';
+}
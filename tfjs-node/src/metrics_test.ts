@@ -0,0 +1,87 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+/** Returns the value of the first sample whose line starts with `prefix`. */
+function sampleValue(text: string, prefix: string): number {
+  const line = text.split('\n').find(l => l.startsWith(prefix + ' '));
+  return line == null ? 0 : Number(line.substring(prefix.length + 1));
+}
+
+describe('metrics', () => {
+  it('counts executions of an op', () => {
+    const count = 'tfjs_node_op_latency_seconds_count{op="MatMul"}';
+    const before = sampleValue(tf.node.metrics(), count);
+
+    const a = tf.ones([2, 2]);
+    tf.matMul(a, a).dispose();
+    tf.matMul(a, a).dispose();
+
+    expect(sampleValue(tf.node.metrics(), count)).toBe(before + 2);
+  });
+
+  it('exports cumulative histogram buckets ending with +Inf', () => {
+    const a = tf.ones([2, 2]);
+    tf.matMul(a, a).dispose();
+
+    const text = tf.node.metrics();
+    const buckets =
+        text.split('\n')
+            .filter(
+                l => l.startsWith(
+                    'tfjs_node_op_latency_seconds_bucket{op="MatMul",'));
+    expect(buckets.length).toBeGreaterThan(1);
+    const counts = buckets.map(l => Number(l.split(' ')[1]));
+    for (let i = 1; i < counts.length; ++i) {
+      expect(counts[i]).toBeGreaterThanOrEqual(counts[i - 1]);
+    }
+    expect(buckets[buckets.length - 1]).toContain('le="+Inf"');
+    expect(counts[counts.length - 1])
+        .toBe(sampleValue(
+            text, 'tfjs_node_op_latency_seconds_count{op="MatMul"}'));
+    expect(text).toContain('# TYPE tfjs_node_op_latency_seconds histogram');
+  });
+
+  it('counts uploads and readbacks', () => {
+    const before = tf.node.metrics();
+    // Values are uploaded when the tensor is first used by an op.
+    const x = tf.tensor1d([1, 2, 3, 4]);
+    const y = tf.neg(x);
+    y.dataSync();
+    const after = tf.node.metrics();
+
+    expect(sampleValue(after, 'tfjs_node_tensor_uploads_total'))
+        .toBe(sampleValue(before, 'tfjs_node_tensor_uploads_total') + 1);
+    expect(sampleValue(after, 'tfjs_node_tensor_upload_bytes_total'))
+        .toBe(sampleValue(before, 'tfjs_node_tensor_upload_bytes_total') + 16);
+    expect(sampleValue(after, 'tfjs_node_tensor_readbacks_total'))
+        .toBe(sampleValue(before, 'tfjs_node_tensor_readbacks_total') + 1);
+    expect(sampleValue(after, 'tfjs_node_tensor_readback_bytes_total'))
+        .toBe(
+            sampleValue(before, 'tfjs_node_tensor_readback_bytes_total') + 16);
+    x.dispose();
+    y.dispose();
+  });
+
+  it('reports live tensors', () => {
+    const x = tf.ones([3]);
+    expect(sampleValue(tf.node.metrics(), 'tfjs_node_live_tensors'))
+        .toBeGreaterThan(0);
+    x.dispose();
+  });
+});
@@ -19,17 +19,62 @@
  * Public API symbols under the tf.node.* namespace.
  */
 
-import {tensorBoard} from './callbacks';
+import {audioSpectrogram, decodeWav, mfcc, mfccBatch} from './audio';
+import {batchScheduler} from './batch_scheduler';
+import {progbarLogger, tensorBoard} from './callbacks';
+import {saveCheckpoint} from './checkpoint';
+import * as data from './data/index';
+import {decode} from './decode';
 // tslint:disable-next-line:max-line-length
 import {decodeBmp, decodeGif, decodeImage, decodeJpeg, decodePng} from './decode_image';
+// tslint:disable-next-line:max-line-length
+import {encodeJpeg, encodeJpegBatch, encodePng, encodePngBatch} from './encode_image';
+import {fromPixels} from './from_pixels';
+import {decodeGifFirstFrame, decodeGifFrames} from './gif_frame_decoder';
+import {enableTensorAutoRelease} from './memory';
+import {metrics} from './metrics';
+import {train} from './optimizers';
+import {prepareSignature} from './prepared_signature';
+import {quantizeModel} from './quantization';
+import {resourceVariable, useResourceVariables} from './resource_variable';
+import {sparse} from './sparse_tensor';
 import {summaryFileWriter} from './tensorboard';
+import {allocTensorBuffer} from './tensor_buffer';
+import {prewarm, warmup} from './warmup';
 
 export const node = {
   decodeImage,
   decodeBmp,
   decodeGif,
+  decodeGifFrames,
+  decodeGifFirstFrame,
   decodePng,
   decodeJpeg,
+  fromPixels,
+  encodeJpeg,
+  encodePng,
+  encodeJpegBatch,
+  encodePngBatch,
+  decodeWav,
+  audioSpectrogram,
+  mfcc,
+  mfccBatch,
   summaryFileWriter,
-  tensorBoard
+  tensorBoard,
+  progbarLogger,
+  batchScheduler,
+  warmup,
+  prewarm,
+  prepareSignature,
+  allocTensorBuffer,
+  enableTensorAutoRelease,
+  metrics,
+  resourceVariable,
+  useResourceVariables,
+  quantizeModel,
+  saveCheckpoint,
+  decode,
+  data,
+  sparse,
+  train
 };
@@ -16,12 +16,13 @@
  */
 
 // tslint:disable-next-line:max-line-length
-import {BackendTimingInfo, DataMover, DataType, fill, KernelBackend, ones, Rank, rsqrt, Scalar, scalar, ShapeMap, Tensor, Tensor1D, tensor1d, Tensor2D, tensor2d, Tensor3D, tensor3d, Tensor4D, tidy, util} from '@tensorflow/tfjs-core';
+import {BackendTimingInfo, DataMover, DataType, fill, KernelBackend, ones, Rank, rsqrt, Scalar, scalar, ShapeMap, Tensor, Tensor1D, tensor1d, Tensor2D, tensor2d, Tensor3D, Tensor4D, tidy, util} from '@tensorflow/tfjs-core';
 import {EPSILON_FLOAT32} from '@tensorflow/tfjs-core/dist/backends/backend';
 import {Conv2DInfo, Conv3DInfo} from '@tensorflow/tfjs-core/dist/ops/conv_util';
 import {Activation} from '@tensorflow/tfjs-core/dist/ops/fused_util';
 import {Tensor5D} from '@tensorflow/tfjs-core/dist/tensor';
-import {BackendValues, upcastType} from '@tensorflow/tfjs-core/dist/types';
+// tslint:disable-next-line:max-line-length
+import {BackendValues, TypedArray, upcastType} from '@tensorflow/tfjs-core/dist/types';
 import {isNullOrUndefined} from 'util';
 import {Int64Scalar} from './int64_tensors';
 // tslint:disable-next-line:max-line-length
@@ -37,10 +38,35 @@ type TensorInfo = {
 
 interface DataId {}
 
+/**
+ * Called before every op executed through `executeSingleOutput()` or
+ * `executeMultipleOutputs()`, with the same arguments. Inputs that were
+ * created in JavaScript are not uploaded to TensorFlow yet, see
+ * `getPendingValues()`.
+ */
+export type OpObserver =
+    (name: string, opAttrs: TFEOpAttr[], inputs: Array<Tensor|Int64Scalar>,
+     numOutputs: number) => void;
+
+// The subset of the `FinalizationRegistry` API (Node.js >= 14.6) used by the
+// backend. TypeScript 3.3 has no type definitions for it.
+interface FinalizationRegistry<T> {
+  register(target: object, heldValue: T, unregisterToken?: object): void;
+  unregister(unregisterToken: object): void;
+}
+
 export class NodeJSKernelBackend extends KernelBackend {
   binding: TFJSBinding;
   isGPUPackage: boolean;
   private tensorMap = new WeakMap<DataId, TensorInfo>();
+  // Releases the native tensors of garbage-collected data IDs when automatic
+  // release is enabled, see `enableAutoRelease()`.
+  private autoReleaseRegistry: FinalizationRegistry<TensorInfo> = null;
+  private numTensorsAutoReleased = 0;
+  private numBytesAutoReleased = 0;
+  // Makes the shared names of resource variables unique.
+  private nextVariableId = 0;
+  private opObserver: OpObserver = null;
 
   constructor(binding: TFJSBinding, packageName: string) {
     super();
@@ -48,6 +74,39 @@ export class NodeJSKernelBackend extends KernelBackend {
     this.isGPUPackage = packageName === '@tensorflow/tfjs-node-gpu';
   }
 
+  /**
+   * Releases the native tensor of every tensor that is garbage collected
+   * without having been disposed. Requires `FinalizationRegistry` support
+   * (Node.js >= 14.6). Only tensors created after this call are tracked.
+   */
+  enableAutoRelease(): void {
+    if (this.autoReleaseRegistry != null) {
+      return;
+    }
+    // tslint:disable-next-line:no-any
+    const registryConstructor = (global as any).FinalizationRegistry;
+    if (registryConstructor == null) {
+      throw new Error(
+          'Automatic tensor release requires FinalizationRegistry, which is ' +
+          `not available in Node.js ${process.version}`);
+    }
+    this.autoReleaseRegistry =
+        new registryConstructor((info: TensorInfo) => this.autoRelease(info));
+  }
+
+  private autoRelease(info: TensorInfo) {
+    if (info.id == null || info.id < 0) {
+      // The values were never uploaded, V8 owns all of the memory.
+      return;
+    }
+    const numBytesBefore = this.binding.getMemoryInfo().numBytes;
+    this.binding.deleteTensor(info.id);
+    info.id = -1;
+    this.numTensorsAutoReleased++;
+    this.numBytesAutoReleased +=
+        numBytesBefore - this.binding.getMemoryInfo().numBytes;
+  }
+
   setDataMover(dataMover: DataMover): void {
     // TODO(kreeger, smilkov): Implement this.
   }
@@ -111,14 +170,85 @@ export class NodeJSKernelBackend extends KernelBackend {
         // supported in TFJS yet, cast it to int32.
         dtype = 'int32';
         break;
+      case this.binding.TF_QINT8:
+      case this.binding.TF_QUINT8:
+      case this.binding.TF_QINT32:
+        // Quantized Tensors are only passed between quantized op kernels and
+        // are not supported in TFJS, represent them as int32.
+        dtype = 'int32';
+        break;
+      case this.binding.TF_VARIANT:
+        // NOTE: Variant-type Tensors (e.g., tf.data datasets) are opaque
+        // handles that are only passed back to op kernels. Like resources, they
+        // are represented as string-type Tensors.
+        dtype = 'string';
+        break;
       default:
         throw new Error(`Unknown dtype enum ${metadata.dtype}`);
     }
     return Tensor.make(metadata.shape, {dataId: newId}, dtype);
   }
 
-  // Prepares Tensor instances for Op execution.
-  private getInputTensorIds(tensors: Array<Tensor|Int64Scalar>): number[] {
+  // Returns a tensor with `shape` that shares the memory of `x`, starting at
+  // element `offset`, or null if the memory can't be shared (e.g., because it
+  // is placed on a GPU).
+  private createView<T extends Tensor>(
+      x: Tensor, offset: number, shape: number[]): T {
+    if (x.dtype === 'string') {
+      return null;
+    }
+    const info = this.tensorMap.get(x.dataId);
+    const dataId = {};
+    if (info.values != null) {
+      // The values were not uploaded yet, so the view shares the JS memory.
+      const values = (info.values as TypedArray)
+                         .subarray(offset, offset + util.sizeFromShape(shape));
+      this.tensorMap.set(dataId, {shape, dtype: info.dtype, values, id: -1});
+    } else {
+      const id = this.binding.createTensorView(info.id, offset, shape);
+      if (id < 0) {
+        return null;
+      }
+      this.tensorMap.set(dataId, {shape, dtype: info.dtype, values: null, id});
+    }
+    return Tensor.make(shape, {dataId}, x.dtype) as T;
+  }
+
+  // Splits `x` along `axis` into views, which requires all axes before `axis`
+  // to have size 1. The axis is removed from the views if `squeezeAxis` is
+  // true. Returns null if `x` can't be split into views.
+  private splitIntoViews(
+      x: Tensor, sizeSplits: number[], axis: number,
+      squeezeAxis: boolean): Tensor[] {
+    if (util.sizeFromShape(x.shape.slice(0, axis)) !== 1) {
+      return null;
+    }
+    const innerSize = util.sizeFromShape(x.shape.slice(axis + 1));
+    const views: Tensor[] = [];
+    let offset = 0;
+    for (const size of sizeSplits) {
+      const shape = x.shape.slice();
+      if (squeezeAxis) {
+        shape.splice(axis, 1);
+      } else {
+        shape[axis] = size;
+      }
+      // Only the first view can fail, since that depends on `x` alone.
+      const view = this.createView(x, offset, shape);
+      if (view == null) {
+        return null;
+      }
+      views.push(view);
+      offset += size * innerSize;
+    }
+    return views;
+  }
+
+  // Prepares Tensor instances for Op execution. The IDs of tensors that are
+  // created only for this Op execution (e.g., for `Int64Scalar`s) are appended
+  // to `temporaryIds` when provided; the caller is expected to delete them.
+  private getInputTensorIds(
+      tensors: Array<Tensor|Int64Scalar>, temporaryIds?: number[]): number[] {
     const ids: number[] = [];
     for (let i = 0; i < tensors.length; i++) {
       if (tensors[i] instanceof Tensor) {
@@ -139,6 +269,9 @@ export class NodeJSKernelBackend extends KernelBackend {
         const value = (tensors[i] as Int64Scalar).valueArray;
         const id = this.binding.createTensor([], this.binding.TF_INT64, value);
         ids.push(id);
+        if (temporaryIds != null) {
+          temporaryIds.push(id);
+        }
       } else {
         throw new Error(`Invalid Tensor type: ${typeof tensors[i]}`);
       }
@@ -173,10 +306,10 @@ export class NodeJSKernelBackend extends KernelBackend {
    * @param inputs The list of input Tensors for the Op.
    * @return A resulting Tensor from Op execution.
    */
-  executeSingleOutput(name: string, opAttrs: TFEOpAttr[], inputs: Tensor[]):
-      Tensor {
-    const outputMetadata = this.binding.executeOp(
-        name, opAttrs, this.getInputTensorIds(inputs), 1);
+  executeSingleOutput(
+      name: string, opAttrs: TFEOpAttr[],
+      inputs: Array<Tensor|Int64Scalar>): Tensor {
+    const outputMetadata = this.executeOp(name, opAttrs, inputs, 1);
     return this.createOutputTensor(outputMetadata[0]);
   }
 
@@ -189,19 +322,81 @@ export class NodeJSKernelBackend extends KernelBackend {
    * @return A resulting Tensor array from Op execution.
    */
   executeMultipleOutputs(
-      name: string, opAttrs: TFEOpAttr[], inputs: Tensor[],
+      name: string, opAttrs: TFEOpAttr[], inputs: Array<Tensor|Int64Scalar>,
       numOutputs: number): Tensor[] {
-    const outputMetadata = this.binding.executeOp(
-        name, opAttrs, this.getInputTensorIds(inputs), numOutputs);
+    const outputMetadata = this.executeOp(name, opAttrs, inputs, numOutputs);
     return outputMetadata.map(m => this.createOutputTensor(m));
   }
 
+  /**
+   * Executes a TensorFlow Eager Op on the libuv thread pool, so that the
+   * event loop keeps running while the op executes. The inputs are
+   * referenced by the op, and may be disposed before it completes.
+   * @param name The name of the Op to execute.
+   * @param opAttrs The list of Op attributes required to execute.
+   * @param inputs The list of input Tensors for the Op.
+   * @param numOutputs The number of output Tensors for Op execution.
+   * @return A promise of the resulting Tensors.
+   */
+  async executeOpAsync(
+      name: string, opAttrs: TFEOpAttr[], inputs: Array<Tensor|Int64Scalar>,
+      numOutputs: number): Promise<Tensor[]> {
+    const temporaryIds: number[] = [];
+    let outputMetadata: Promise<TensorMetadata[]>;
+    try {
+      outputMetadata = this.binding.executeOpAsync(
+          name, opAttrs, this.getInputTensorIds(inputs, temporaryIds),
+          numOutputs);
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+    return (await outputMetadata).map(m => this.createOutputTensor(m));
+  }
+
+  /**
+   * Sets the function that observes executed ops, or removes it when
+   * `observer` is null. Returns the previous observer.
+   */
+  setOpObserver(observer: OpObserver): OpObserver {
+    const previous = this.opObserver;
+    this.opObserver = observer;
+    return previous;
+  }
+
+  // Executes an Op and deletes the temporary input tensors afterwards.
+  private executeOp(
+      name: string, opAttrs: TFEOpAttr[], inputs: Array<Tensor|Int64Scalar>,
+      numOutputs: number): TensorMetadata[] {
+    if (this.opObserver != null) {
+      this.opObserver(name, opAttrs, inputs, numOutputs);
+    }
+    const temporaryIds: number[] = [];
+    let outputMetadata: TensorMetadata[];
+    try {
+      outputMetadata = this.binding.executeOp(
+          name, opAttrs, this.getInputTensorIds(inputs, temporaryIds),
+          numOutputs);
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+    return outputMetadata;
+  }
+
   dispose(): void {}
 
   async read(dataId: object): Promise<BackendValues> {
     return this.readSync(dataId);
   }
 
+  /**
+   * Returns the values of a tensor that were written in JavaScript and not
+   * uploaded to TensorFlow yet, or null. Never reads TensorFlow memory.
+   */
+  getPendingValues(dataId: DataId): BackendValues {
+    const info = this.tensorMap.get(dataId);
+    return info == null ? null : info.values;
+  }
+
   readSync(dataId: object): BackendValues {
     if (!this.tensorMap.has(dataId)) {
       throw new Error(`Tensor ${dataId} was not registered!`);
@@ -214,12 +409,53 @@ export class NodeJSKernelBackend extends KernelBackend {
     }
   }
 
+  /**
+   * Copies the values of a numeric tensor into `target`, which must have the
+   * same type and length as the tensor's values.
+   */
+  readInto(dataId: object, target: Float32Array|Int32Array|Uint8Array): void {
+    if (!this.tensorMap.has(dataId)) {
+      throw new Error(`Tensor ${dataId} was not registered!`);
+    }
+    const info = this.tensorMap.get(dataId);
+    if (info.values != null) {
+      util.assert(
+          info.values.length === target.length,
+          () => `Expected a target of length ${info.values.length}, but got ` +
+              `${target.length}`);
+      target.set(info.values as Float32Array | Int32Array | Uint8Array);
+    } else {
+      this.binding.tensorDataInto(info.id, target);
+    }
+  }
+
+  /**
+   * Creates the TensorFlow tensor for `tensor` now instead of at its first
+   * use by an op. Returns true if the TensorFlow tensor shares the memory of
+   * the values that `tensor` was created from, so that writes to those values
+   * are visible to later ops.
+   */
+  uploadTensor(tensor: Tensor): boolean {
+    const info = this.tensorMap.get(tensor.dataId);
+    if (info.values == null) {
+      return false;
+    }
+    const before = this.binding.getTensorUploadStats();
+    this.getInputTensorIds([tensor]);
+    const after = this.binding.getTensorUploadStats();
+    return after.numShared > before.numShared &&
+        after.numDeviceCopies === before.numDeviceCopies;
+  }
+
   disposeData(dataId: object): void {
     const id = this.tensorMap.get(dataId).id;
     if (id != null && id >= 0) {
       this.binding.deleteTensor(id);
     }
     this.tensorMap.delete(dataId);
+    if (this.autoReleaseRegistry != null) {
+      this.autoReleaseRegistry.unregister(dataId);
+    }
   }
 
   write(dataId: object, values: BackendValues): void {
@@ -237,6 +473,11 @@ export class NodeJSKernelBackend extends KernelBackend {
       this.tensorMap.set(
           dataId, {shape, dtype: getTFDType(dtype), values: null, id: -1});
     }
+    if (this.autoReleaseRegistry != null) {
+      // The held value must not reference `dataId`, or it is never collected.
+      this.autoReleaseRegistry.register(
+          dataId, this.tensorMap.get(dataId), dataId);
+    }
   }
 
   fill<R extends Rank>(
@@ -324,6 +565,11 @@ export class NodeJSKernelBackend extends KernelBackend {
           `Invalid axis supplied: ${axis} shape length: ${x.shape.length}`);
     }
     const num = x.shape[axis];
+    const views = this.splitIntoViews(
+        x, new Array<number>(num).fill(1), axis, true /* squeezeAxis */);
+    if (views != null) {
+      return views;
+    }
     const opAttrs = [
       {name: 'num', type: this.binding.TF_ATTR_INT, value: num},
       createTypeOpAttr('T', x.dtype),
@@ -394,6 +640,13 @@ export class NodeJSKernelBackend extends KernelBackend {
   }
 
   slice<T extends Tensor>(x: T, begin: number[], size: number[]): T {
+    const offset = getContiguousSliceOffset(x.shape, begin, size);
+    if (offset >= 0) {
+      const view = this.createView<T>(x, offset, size);
+      if (view != null) {
+        return view;
+      }
+    }
     const opAttrs =
         [createTypeOpAttr('T', x.dtype), createTypeOpAttr('Index', 'int32')];
 
@@ -413,6 +666,20 @@ export class NodeJSKernelBackend extends KernelBackend {
   }
 
   concat(tensors: Tensor[], axis: number): Tensor {
+    // Tensors whose values were not uploaded yet are copied into the result
+    // directly, if their values are contiguous in it, i.e., if all axes before
+    // `axis` have size 1.
+    const dtype = tensors[0].dtype;
+    const infos = tensors.map(t => this.tensorMap.get(t.dataId));
+    if (dtype !== 'string' && dtype !== 'complex64' &&
+        util.sizeFromShape(tensors[0].shape.slice(0, axis)) === 1 &&
+        tensors.every((t, i) => t.dtype === dtype && infos[i].values != null)) {
+      const shape = tensors[0].shape.slice();
+      shape[axis] = tensors.reduce((size, t) => size + t.shape[axis], 0);
+      return this.createTensorFromChunks(
+          shape, dtype, infos.map(info => info.values as TypedArray));
+    }
+
     const opAttrs = [
       {name: 'N', type: this.binding.TF_ATTR_INT, value: tensors.length}, {
         name: 'Tidx',
@@ -1270,6 +1537,11 @@ export class NodeJSKernelBackend extends KernelBackend {
 
   reshape<T extends Tensor, R extends Rank>(x: T, shape: ShapeMap[R]):
       Tensor<R> {
+    // The data layout doesn't change, so the result shares the memory of `x`.
+    const view = this.createView<Tensor<R>>(x, 0, shape);
+    if (view != null) {
+      return view;
+    }
     const shapeTensor = tensor1d(shape, 'int32');
 
     const opAttrs = [
@@ -1658,6 +1930,11 @@ export class NodeJSKernelBackend extends KernelBackend {
 
   split<T extends Tensor<Rank>>(value: T, sizeSplits: number[], axis: number):
       T[] {
+    const views = this.splitIntoViews(
+        value, sizeSplits, axis, false /* squeezeAxis */);
+    if (views != null) {
+      return views as T[];
+    }
     const opAttrs = [
       {
         name: 'num_split',
@@ -1707,34 +1984,61 @@ export class NodeJSKernelBackend extends KernelBackend {
       throw new Error('pixels passed to fromPixels() can not be null');
     }
     // tslint:disable-next-line:no-any
-    if ((pixels as any).getContext == null) {
+    const pixelSource = pixels as any;
+    let vals: Uint8ClampedArray;
+    if (pixelSource.data instanceof Uint8ClampedArray) {
+      // ImageData, e.g., from the `canvas` npm package.
+      vals = pixelSource.data;
+    } else if (pixelSource.getContext != null) {
+      vals = pixelSource.getContext('2d')
+                 .getImageData(0, 0, pixels.width, pixels.height)
+                 .data;
+    } else {
       throw new Error(
           'When running in node, pixels must be an HTMLCanvasElement ' +
           'like the one returned by the `canvas` npm package');
     }
-    const vals: Uint8ClampedArray =
-        // tslint:disable-next-line:no-any
-        (pixels as any)
-            .getContext('2d')
-            .getImageData(0, 0, pixels.width, pixels.height)
-            .data;
-    let values: Int32Array;
-    if (numChannels === 4) {
-      values = new Int32Array(vals);
-    } else {
-      const numPixels = pixels.width * pixels.height;
-      values = new Int32Array(numPixels * numChannels);
-      for (let i = 0; i < numPixels; i++) {
-        for (let channel = 0; channel < numChannels; ++channel) {
-          values[i * numChannels + channel] = vals[i * 4 + channel];
-        }
-      }
-    }
-    const outShape: [number, number, number] =
-        [pixels.height, pixels.width, numChannels];
-    return tensor3d(values, outShape, 'int32');
+    return this.createTensorFromPixels(
+        vals, pixels.height, pixels.width, numChannels, 'int32', false);
+  }
+
+  /**
+   * Creates a tensor from the concatenation of typed arrays. The tensor is
+   * allocated once and the arrays are copied into place natively, without
+   * creating a tensor for each of them.
+   * @param shape The shape of the tensor.
+   * @param dtype The dtype of the tensor, which the arrays must match.
+   * @param chunks The values of the tensor, in row-major order.
+   */
+  createTensorFromChunks(
+      shape: number[], dtype: DataType, chunks: TypedArray[]): Tensor {
+    const id = this.binding.createTensorFromChunks(
+        shape, getTFDType(dtype), chunks);
+    return this.createOutputTensor({id, shape, dtype: getTFDType(dtype)});
+  }
+
+  /**
+   * Creates a tensor from RGBA pixels natively, without per-pixel work in
+   * JavaScript.
+   * @param vals The RGBA values of the pixels, in row-major order.
+   * @param numChannels The number of leading channels to keep.
+   * @param dtype The dtype of the tensor.
+   * @param normalize Whether to divide float32 values by 255.
+   */
+  createTensorFromPixels(
+      vals: Uint8Array|Uint8ClampedArray, height: number, width: number,
+      numChannels: number, dtype: 'int32'|'float32',
+      normalize: boolean): Tensor3D {
+    const id = this.binding.createTensorFromPixels(
+        vals, height, width, numChannels, getTFDType(dtype), normalize);
+    return this.createOutputTensor({
+      id,
+      shape: [height, width, numChannels],
+      dtype: getTFDType(dtype)
+    }) as Tensor3D;
   }
 
+
   decodeJpeg(
       contents: Uint8Array, channels: number, ratio: number,
       fancyUpscaling: boolean, tryRecoverTruncated: boolean,
@@ -1785,6 +2089,204 @@ export class NodeJSKernelBackend extends KernelBackend {
         Tensor<Rank.R4>;
   }
 
+  /**
+   * Encodes an int32 image with values in [0, 255] as a JPEG on the libuv
+   * thread pool.
+   */
+  encodeJpegAsync(
+      image: Tensor3D, format: string, quality: number, progressive: boolean,
+      optimizeSize: boolean, chromaDownsampling: boolean): Promise<Uint8Array> {
+    const opAttrs = [
+      {name: 'format', type: this.binding.TF_ATTR_STRING, value: format},
+      {name: 'quality', type: this.binding.TF_ATTR_INT, value: quality}, {
+        name: 'progressive',
+        type: this.binding.TF_ATTR_BOOL,
+        value: progressive
+      },
+      {
+        name: 'optimize_size',
+        type: this.binding.TF_ATTR_BOOL,
+        value: optimizeSize
+      },
+      {
+        name: 'chroma_downsampling',
+        type: this.binding.TF_ATTR_BOOL,
+        value: chromaDownsampling
+      }
+    ];
+    return this.encodeImageAsync('EncodeJpeg', opAttrs, image);
+  }
+
+  /**
+   * Encodes an int32 image with values in [0, 255] as a PNG on the libuv
+   * thread pool.
+   */
+  encodePngAsync(image: Tensor3D, compression: number): Promise<Uint8Array> {
+    const opAttrs = [
+      {name: 'compression', type: this.binding.TF_ATTR_INT, value: compression},
+      {name: 'T', type: this.binding.TF_ATTR_TYPE, value: this.binding.TF_UINT8}
+    ];
+    return this.encodeImageAsync('EncodePng', opAttrs, image);
+  }
+
+  // Casts the image to uint8, executes an image encoding op asynchronously and
+  // returns the bytes of the encoded image. The encoded string tensor is never
+  // registered with tfjs-core.
+  private async encodeImageAsync(
+      opName: string, opAttrs: TFEOpAttr[],
+      image: Tensor3D): Promise<Uint8Array> {
+    let outputMetadata: Promise<TensorMetadata[]>;
+    const uint8Id = this.castTensorId(
+                            this.getInputTensorIds([image])[0],
+                            this.binding.TF_INT32, this.binding.TF_UINT8)
+                        .id;
+    try {
+      outputMetadata =
+          this.binding.executeOpAsync(opName, opAttrs, [uint8Id], 1);
+    } finally {
+      // The op references its input, which can be deleted right away.
+      this.binding.deleteTensor(uint8Id);
+    }
+    const encodedId = (await outputMetadata)[0].id;
+    try {
+      return (this.binding.tensorDataSync(encodedId) as {} as Uint8Array[])[0];
+    } finally {
+      this.binding.deleteTensor(encodedId);
+    }
+  }
+
+  // ------------------------------------------------------------
+  // Audio-related (tfjs-node-specific) backend kernels.
+
+  private decodeWavOpAttrs(desiredChannels: number, desiredSamples: number):
+      TFEOpAttr[] {
+    return [
+      {
+        name: 'desired_channels',
+        type: this.binding.TF_ATTR_INT,
+        value: desiredChannels
+      },
+      {
+        name: 'desired_samples',
+        type: this.binding.TF_ATTR_INT,
+        value: desiredSamples
+      }
+    ];
+  }
+
+  private audioSpectrogramOpAttrs(
+      windowSize: number, stride: number,
+      magnitudeSquared: boolean): TFEOpAttr[] {
+    return [
+      {name: 'window_size', type: this.binding.TF_ATTR_INT, value: windowSize},
+      {name: 'stride', type: this.binding.TF_ATTR_INT, value: stride}, {
+        name: 'magnitude_squared',
+        type: this.binding.TF_ATTR_BOOL,
+        value: magnitudeSquared
+      }
+    ];
+  }
+
+  private mfccOpAttrs(
+      upperFrequencyLimit: number, lowerFrequencyLimit: number,
+      filterbankChannelCount: number,
+      dctCoefficientCount: number): TFEOpAttr[] {
+    return [
+      {
+        name: 'upper_frequency_limit',
+        type: this.binding.TF_ATTR_FLOAT,
+        value: upperFrequencyLimit
+      },
+      {
+        name: 'lower_frequency_limit',
+        type: this.binding.TF_ATTR_FLOAT,
+        value: lowerFrequencyLimit
+      },
+      {
+        name: 'filterbank_channel_count',
+        type: this.binding.TF_ATTR_INT,
+        value: filterbankChannelCount
+      },
+      {
+        name: 'dct_coefficient_count',
+        type: this.binding.TF_ATTR_INT,
+        value: dctCoefficientCount
+      }
+    ];
+  }
+
+  /**
+   * Returns the float32 samples of a WAV file, with shape [samples,
+   * channels], and its sample rate as an int32 scalar.
+   */
+  decodeWav(
+      contents: Uint8Array, desiredChannels: number,
+      desiredSamples: number): [Tensor2D, Scalar] {
+    const opAttrs = this.decodeWavOpAttrs(desiredChannels, desiredSamples);
+    const inputArgs = [scalar(contents, 'string')];
+    return this.executeMultipleOutputs('DecodeWav', opAttrs, inputArgs, 2) as
+        [Tensor2D, Scalar];
+  }
+
+  async decodeWavAsync(
+      contents: Uint8Array, desiredChannels: number,
+      desiredSamples: number): Promise<[Tensor2D, Scalar]> {
+    const opAttrs = this.decodeWavOpAttrs(desiredChannels, desiredSamples);
+    const contentsScalar = scalar(contents, 'string');
+    try {
+      return await this.executeOpAsync(
+                 'DecodeWav', opAttrs, [contentsScalar], 2) as
+          [Tensor2D, Scalar];
+    } finally {
+      contentsScalar.dispose();
+    }
+  }
+
+  audioSpectrogram(
+      input: Tensor2D, windowSize: number, stride: number,
+      magnitudeSquared: boolean): Tensor3D {
+    const opAttrs =
+        this.audioSpectrogramOpAttrs(windowSize, stride, magnitudeSquared);
+    return this.executeSingleOutput('AudioSpectrogram', opAttrs, [input]) as
+        Tensor3D;
+  }
+
+  async audioSpectrogramAsync(
+      input: Tensor2D, windowSize: number, stride: number,
+      magnitudeSquared: boolean): Promise<Tensor3D> {
+    const opAttrs =
+        this.audioSpectrogramOpAttrs(windowSize, stride, magnitudeSquared);
+    const [output] =
+        await this.executeOpAsync('AudioSpectrogram', opAttrs, [input], 1);
+    return output as Tensor3D;
+  }
+
+  mfcc(
+      spectrogram: Tensor3D, sampleRate: Scalar, upperFrequencyLimit: number,
+      lowerFrequencyLimit: number, filterbankChannelCount: number,
+      dctCoefficientCount: number): Tensor3D {
+    const opAttrs = this.mfccOpAttrs(
+        upperFrequencyLimit, lowerFrequencyLimit, filterbankChannelCount,
+        dctCoefficientCount);
+    return this.executeSingleOutput(
+               'Mfcc', opAttrs, [spectrogram, sampleRate]) as Tensor3D;
+  }
+
+  async mfccAsync(
+      spectrogram: Tensor3D, sampleRate: Scalar, upperFrequencyLimit: number,
+      lowerFrequencyLimit: number, filterbankChannelCount: number,
+      dctCoefficientCount: number): Promise<Tensor3D> {
+    const opAttrs = this.mfccOpAttrs(
+        upperFrequencyLimit, lowerFrequencyLimit, filterbankChannelCount,
+        dctCoefficientCount);
+    const [output] = await this.executeOpAsync(
+        'Mfcc', opAttrs, [spectrogram, sampleRate], 1);
+    return output as Tensor3D;
+  }
+
+  // ~ Audio-related (tfjs-node-specific) backend kernels.
+  // ------------------------------------------------------------
+
   // ------------------------------------------------------------
   // TensorBoard-related (tfjs-node-specific) backend kernels.
 
@@ -1814,38 +2316,149 @@ export class NodeJSKernelBackend extends KernelBackend {
     this.executeMultipleOutputs('CreateSummaryFileWriter', [], inputArgs, 0);
   }
 
+  /**
+   * Enqueues a scalar summary.
+   *
+   * `tf.Scalar` values are queued like `number` values, so that summaries
+   * are written in the order they are issued. They are read on the
+   * background thread, without a readback on the calling thread.
+   */
   writeScalarSummary(
       resourceHandle: Tensor, step: number, name: string,
       value: Scalar|number): void {
+    if (typeof value === 'number') {
+      this.writeScalarSummaries(resourceHandle, step, {[name]: value});
+      return;
+    }
+    util.assert(
+        Number.isInteger(step),
+        () => `step is expected to be an integer, but is instead ${step}`);
+    util.assert(
+        value.rank === 0,
+        () => `A non-scalar tensor (rank ${value.rank}) is passed to ` +
+            `writeScalarSummary()`);
+    const [writerId, valueId] = this.getInputTensorIds([resourceHandle, value]);
+    this.binding.writeScalarSummaryTensor(writerId, step, name, valueId);
+  }
+
+  /**
+   * Enqueues scalar summaries that share one step.
+   *
+   * The summaries are written in bulk on a background thread. Errors are
+   * reported by subsequent calls or by `flushSummaryWriter()`. If the queue
+   * of pending writes is full, summaries are dropped and the number of
+   * dropped summaries is logged.
+   */
+  writeScalarSummaries(
+      resourceHandle: Tensor, step: number,
+      values: {[name: string]: number}): void {
+    util.assert(
+        Number.isInteger(step),
+        () => `step is expected to be an integer, but is instead ${step}`);
+    const tags = Object.keys(values);
+    if (tags.length === 0) {
+      return;
+    }
+    const scalarValues = new Float32Array(tags.length);
+    tags.forEach((tag, i) => scalarValues[i] = values[tag]);
+    this.binding.writeScalarSummaries(
+        this.getInputTensorIds([resourceHandle])[0], step, tags, scalarValues);
+  }
+
+  writeHistogramSummary(
+      resourceHandle: Tensor, step: number, name: string, data: Tensor): void {
     tidy(() => {
       util.assert(
           Number.isInteger(step),
           () => `step is expected to be an integer, but is instead ${step}`);
+      util.assert(
+          data.dtype === 'float32' || data.dtype === 'int32',
+          () => `Expected a numeric tensor for writeHistogramSummary(), ` +
+              `but got dtype ${data.dtype}`);
+      // Bucketing is done by the kernel, the values are not read into JS.
       const inputArgs: Array<Tensor|Int64Scalar> =
-          [resourceHandle, new Int64Scalar(step), scalar(name, 'string')];
+          [resourceHandle, new Int64Scalar(step), scalar(name, 'string'), data];
+      const opAttrs = [createTypeOpAttr('T', data.dtype)];
+      this.executeOp('WriteHistogramSummary', opAttrs, inputArgs, 0);
+    });
+  }
 
-      let typeAttr: number;
-      if (typeof value === 'number') {
-        inputArgs.push(scalar(value));
-        typeAttr = this.binding.TF_FLOAT;
-      } else {
-        // `value` is a Scalar.
-        util.assert(
-            value.rank === 0,
-            () => `A non-scalar tensor (rank ${value.rank}) is passed to ` +
-                `writeScalarSummary()`);
-        inputArgs.push(value);
-        typeAttr = this.typeAttributeFromTensor(value);
-      }
-      const opAttrs: TFEOpAttr[] =
-          [{name: 'T', type: this.binding.TF_ATTR_TYPE, value: typeAttr}];
+  writeImageSummary(
+      resourceHandle: Tensor, step: number, name: string, images: Tensor4D,
+      maxImages: number): void {
+    util.assert(
+        Number.isInteger(step),
+        () => `step is expected to be an integer, but is instead ${step}`);
+    util.assert(
+        images.dtype === 'float32' || images.dtype === 'int32',
+        () => `Expected a numeric tensor for writeImageSummary(), ` +
+            `but got dtype ${images.dtype}`);
+    const temporaryIds: number[] = [];
+    try {
+      tidy(() => {
+        const inputIds = this.getInputTensorIds(
+            [resourceHandle, new Int64Scalar(step), scalar(name, 'string')],
+            temporaryIds);
+
+        // float32 images are normalized by the kernel. int32 images hold
+        // pixel values and are cast to uint8 (which tfjs-core lacks) natively.
+        let imageType = this.binding.TF_FLOAT;
+        let imagesId = this.getInputTensorIds([images])[0];
+        if (images.dtype === 'int32') {
+          imageType = this.binding.TF_UINT8;
+          imagesId =
+              this.castTensorId(imagesId, this.binding.TF_INT32, imageType).id;
+          temporaryIds.push(imagesId);
+        }
+        // Color of images with non-finite values: opaque red.
+        const badColor = tensor1d([255, 0, 0, 255], 'int32');
+        const badColorId = this.castTensorId(
+                                   this.getInputTensorIds([badColor])[0],
+                                   this.binding.TF_INT32, this.binding.TF_UINT8)
+                               .id;
+        temporaryIds.push(badColorId);
+
+        const opAttrs = [
+          {name: 'T', type: this.binding.TF_ATTR_TYPE, value: imageType},
+          {name: 'max_images', type: this.binding.TF_ATTR_INT, value: maxImages}
+        ];
+        this.binding.executeOp(
+            'WriteImageSummary', opAttrs,
+            [...inputIds, imagesId, badColorId], 0);
+      });
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+  }
 
-      this.binding.executeOp(
-          'WriteScalarSummary', opAttrs, this.getInputTensorIds(inputArgs), 0);
+  writeTextSummary(
+      resourceHandle: Tensor, step: number, name: string,
+      text: string|Tensor): void {
+    tidy(() => {
+      util.assert(
+          Number.isInteger(step),
+          () => `step is expected to be an integer, but is instead ${step}`);
+      const textTensor = typeof text === 'string' ? scalar(text) : text;
+      util.assert(
+          textTensor.dtype === 'string',
+          () => `Expected a string tensor for writeTextSummary(), ` +
+              `but got dtype ${textTensor.dtype}`);
+      // A serialized SummaryMetadata proto with
+      // `plugin_data {plugin_name: "text"}`, which TensorBoard's text plugin
+      // requires.
+      const textPluginMetadata =
+          new Uint8Array([0x0a, 0x06, 0x0a, 0x04, 0x74, 0x65, 0x78, 0x74]);
+      const inputArgs: Array<Tensor|Int64Scalar> = [
+        resourceHandle, new Int64Scalar(step), textTensor,
+        scalar(name, 'string'), scalar(textPluginMetadata, 'string')
+      ];
+      const opAttrs = [createTypeOpAttr('T', 'string')];
+      this.executeOp('WriteSummary', opAttrs, inputArgs, 0);
     });
   }
 
   flushSummaryWriter(resourceHandle: Tensor): void {
+    this.binding.flushSummaryWrites();
     const inputArgs: Tensor[] = [resourceHandle];
     this.executeMultipleOutputs('FlushSummaryWriter', [], inputArgs, 0);
   }
@@ -1853,11 +2466,586 @@ export class NodeJSKernelBackend extends KernelBackend {
   // ~ TensorBoard-related (tfjs-node-specific) backend kernels.
   // ------------------------------------------------------------
 
+  // ------------------------------------------------------------
+  // tf.data-related (tfjs-node-specific) backend kernels.
+  //
+  // Datasets and iterators are variant- and resource-type Tensors. Reading,
+  // shuffling, batching and prefetching run on TensorFlow's own threads.
+
+  tfRecordDataset(
+      filenames: string[], compressionType: string,
+      bufferSize: number): Tensor {
+    const inputArgs = [
+      tensor1d(filenames, 'string'), scalar(compressionType),
+      new Int64Scalar(bufferSize)
+    ];
+    return this.executeSingleOutput('TFRecordDataset', [], inputArgs);
+  }
+
+  fixedLengthRecordDataset(
+      filenames: string[], headerBytes: number, recordBytes: number,
+      footerBytes: number, bufferSize: number): Tensor {
+    const inputArgs = [
+      tensor1d(filenames, 'string'), new Int64Scalar(headerBytes),
+      new Int64Scalar(recordBytes), new Int64Scalar(footerBytes),
+      new Int64Scalar(bufferSize)
+    ];
+    return this.executeSingleOutput('FixedLengthRecordDataset', [], inputArgs);
+  }
+
+  tensorSliceDataset(components: Tensor[]): Tensor {
+    const opAttrs = [
+      {
+        name: 'Toutput_types',
+        type: this.binding.TF_ATTR_TYPE,
+        value: components.map(c => this.typeAttributeFromTensor(c))
+      },
+      {
+        name: 'output_shapes',
+        type: this.binding.TF_ATTR_SHAPE,
+        value: components.map(c => c.shape.slice(1))
+      }
+    ];
+    return this.executeSingleOutput('TensorSliceDataset', opAttrs, components);
+  }
+
+  shuffleDataset(
+      dataset: Tensor, bufferSize: number, seed: number, seed2: number,
+      outputTypes: number[], outputShapes: number[][]): Tensor {
+    const opAttrs = [
+      {
+        name: 'reshuffle_each_iteration',
+        type: this.binding.TF_ATTR_BOOL,
+        value: true
+      },
+      ...this.createDatasetOpAttrs(outputTypes, outputShapes)
+    ];
+    const inputArgs = [
+      dataset, new Int64Scalar(bufferSize), new Int64Scalar(seed),
+      new Int64Scalar(seed2)
+    ];
+    return this.executeSingleOutput('ShuffleDataset', opAttrs, inputArgs);
+  }
+
+  batchDataset(
+      dataset: Tensor, batchSize: number, dropRemainder: boolean,
+      outputTypes: number[], outputShapes: number[][]): Tensor {
+    const opAttrs = this.createDatasetOpAttrs(outputTypes, outputShapes);
+    const inputArgs =
+        [dataset, new Int64Scalar(batchSize), scalar(dropRemainder, 'bool')];
+    return this.executeSingleOutput('BatchDatasetV2', opAttrs, inputArgs);
+  }
+
+  prefetchDataset(
+      dataset: Tensor, bufferSize: number, outputTypes: number[],
+      outputShapes: number[][]): Tensor {
+    const opAttrs = this.createDatasetOpAttrs(outputTypes, outputShapes);
+    const inputArgs = [dataset, new Int64Scalar(bufferSize)];
+    return this.executeSingleOutput('PrefetchDataset', opAttrs, inputArgs);
+  }
+
+  datasetToTFRecord(dataset: Tensor, filename: string, compressionType: string):
+      void {
+    const inputArgs = [dataset, scalar(filename), scalar(compressionType)];
+    this.executeMultipleOutputs(
+        'ExperimentalDatasetToTFRecord', [], inputArgs, 0);
+  }
+
+  anonymousIterator(outputTypes: number[], outputShapes: number[][]): Tensor {
+    const opAttrs = this.createDatasetOpAttrs(outputTypes, outputShapes);
+    return this.executeSingleOutput('AnonymousIterator', opAttrs, []);
+  }
+
+  makeIterator(dataset: Tensor, iterator: Tensor): void {
+    this.executeMultipleOutputs('MakeIterator', [], [dataset, iterator], 0);
+  }
+
+  /**
+   * Returns the next element of a dataset iterator, or `null` once the
+   * iterator is exhausted. int64 components are cast to int32 natively.
+   */
+  iteratorGetNext(
+      iterator: Tensor, outputTypes: number[],
+      outputShapes: number[][]): Tensor[] {
+    const opAttrs = this.createDatasetOpAttrs(outputTypes, outputShapes);
+    let outputMetadata: TensorMetadata[];
+    try {
+      outputMetadata = this.executeOp(
+          'IteratorGetNext', opAttrs, [iterator], outputTypes.length);
+    } catch (e) {
+      if (e.message != null && e.message.indexOf('End of sequence') !== -1) {
+        return null;
+      }
+      throw e;
+    }
+    return outputMetadata.map(
+        metadata => this.createInt32OutputTensor(metadata));
+  }
+
+  destroyResource(resourceHandle: Tensor): void {
+    const opAttrs = [{
+      name: 'ignore_lookup_error',
+      type: this.binding.TF_ATTR_BOOL,
+      value: true
+    }];
+    this.executeMultipleOutputs(
+        'DestroyResourceOp', opAttrs, [resourceHandle], 0);
+  }
+
+  /**
+   * Parses a batch of serialized `tf.Example` protos into dense Tensors.
+   *
+   * int32-type default values select int64 features: they are parsed as int64
+   * and cast to int32 natively, since tfjs-core has no int64 dtype.
+   */
+  parseExample(
+      serialized: Tensor1D, denseKeys: string[], denseDefaults: Tensor[],
+      denseShapes: number[][]): Tensor[] {
+    const temporaryIds: number[] = [];
+    try {
+      const inputIds = this.getInputTensorIds(
+          [
+            serialized, tensor1d([], 'string'),
+            ...denseKeys.map(key => scalar(key))
+          ],
+          temporaryIds);
+      const denseTypes =
+          this.addDenseDefaultIds(denseDefaults, inputIds, temporaryIds);
+      const opAttrs = [
+        {name: 'Nsparse', type: this.binding.TF_ATTR_INT, value: 0},
+        {
+          name: 'Ndense',
+          type: this.binding.TF_ATTR_INT,
+          value: denseKeys.length
+        },
+        {name: 'sparse_types', type: this.binding.TF_ATTR_TYPE, value: []},
+        {name: 'Tdense', type: this.binding.TF_ATTR_TYPE, value: denseTypes},
+        {
+          name: 'dense_shapes',
+          type: this.binding.TF_ATTR_SHAPE,
+          value: denseShapes
+        }
+      ];
+      const outputMetadata = this.binding.executeOp(
+          'ParseExample', opAttrs, inputIds, denseKeys.length);
+      return outputMetadata.map(
+          metadata => this.createInt32OutputTensor(metadata));
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+  }
+
+  /**
+   * Creates a dataset that parses batches of serialized `tf.Example` protos
+   * on TensorFlow's threads. Each element of `dataset` must be a 1D `string`
+   * Tensor; each output element has one dense Tensor per key.
+   *
+   * As in `parseExample()`, int32-type default values select int64 features.
+   * Those are int64 in the dataset and are cast to int32 by
+   * `iteratorGetNext()`.
+   */
+  parseExampleDataset(
+      dataset: Tensor, denseKeys: string[], denseDefaults: Tensor[],
+      denseShapes: number[][], outputShapes: number[][]): Tensor {
+    const temporaryIds: number[] = [];
+    try {
+      // -1 lets TensorFlow tune the number of parallel calls.
+      const inputIds = this.getInputTensorIds(
+          [dataset, new Int64Scalar(-1)], temporaryIds);
+      const denseTypes =
+          this.addDenseDefaultIds(denseDefaults, inputIds, temporaryIds);
+      const opAttrs = [
+        {name: 'sparse_keys', type: this.binding.TF_ATTR_STRING, value: []},
+        {
+          name: 'dense_keys',
+          type: this.binding.TF_ATTR_STRING,
+          value: denseKeys
+        },
+        {name: 'sparse_types', type: this.binding.TF_ATTR_TYPE, value: []},
+        {name: 'Tdense', type: this.binding.TF_ATTR_TYPE, value: denseTypes},
+        {
+          name: 'dense_shapes',
+          type: this.binding.TF_ATTR_SHAPE,
+          value: denseShapes
+        },
+        ...this.createDatasetOpAttrs(denseTypes, outputShapes)
+      ];
+      const outputMetadata = this.binding.executeOp(
+          'ExperimentalParseExampleDataset', opAttrs, inputIds, 1);
+      return this.createOutputTensor(outputMetadata[0]);
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+  }
+
+  unbatchDataset(
+      dataset: Tensor, outputTypes: number[],
+      outputShapes: number[][]): Tensor {
+    const opAttrs = this.createDatasetOpAttrs(outputTypes, outputShapes);
+    return this.executeSingleOutput(
+        'ExperimentalUnbatchDataset', opAttrs, [dataset]);
+  }
+
+  // Appends the IDs of the default values of dense features to `inputIds` and
+  // returns the types of the features. int32 defaults are cast to int64 and
+  // select int64 features.
+  private addDenseDefaultIds(
+      denseDefaults: Tensor[], inputIds: number[],
+      temporaryIds: number[]): number[] {
+    const denseTypes: number[] = [];
+    for (const denseDefault of denseDefaults) {
+      const id = this.getInputTensorIds([denseDefault])[0];
+      if (denseDefault.dtype === 'int32') {
+        const int64Id = this.castTensorId(
+            id, this.binding.TF_INT32, this.binding.TF_INT64).id;
+        temporaryIds.push(int64Id);
+        inputIds.push(int64Id);
+        denseTypes.push(this.binding.TF_INT64);
+      } else {
+        inputIds.push(id);
+        denseTypes.push(this.typeAttributeFromTensor(denseDefault));
+      }
+    }
+    return denseTypes;
+  }
+
+  // Registers an op output with tfjs-core. int64 outputs, which tfjs-core
+  // can't represent, are cast to int32 natively and released.
+  private createInt32OutputTensor(metadata: TensorMetadata): Tensor {
+    if (metadata.dtype === this.binding.TF_INT64) {
+      const int64Id = metadata.id;
+      try {
+        metadata = this.castTensorId(
+            int64Id, this.binding.TF_INT64, this.binding.TF_INT32);
+      } finally {
+        this.binding.deleteTensor(int64Id);
+      }
+    }
+    return this.createOutputTensor(metadata);
+  }
+
+  private createDatasetOpAttrs(
+      outputTypes: number[], outputShapes: number[][]): TFEOpAttr[] {
+    return [
+      {
+        name: 'output_types',
+        type: this.binding.TF_ATTR_TYPE,
+        value: outputTypes
+      },
+      {
+        name: 'output_shapes',
+        type: this.binding.TF_ATTR_SHAPE,
+        value: outputShapes
+      }
+    ];
+  }
+
+  // Casts a tensor natively, without registering the input or the output with
+  // tfjs-core. Used for dtypes that tfjs-core can't represent, e.g., int64.
+  private castTensorId(id: number, srcType: number, dstType: number):
+      TensorMetadata {
+    const opAttrs = [
+      {name: 'SrcT', type: this.binding.TF_ATTR_TYPE, value: srcType},
+      {name: 'DstT', type: this.binding.TF_ATTR_TYPE, value: dstType},
+      {name: 'Truncate', type: this.binding.TF_ATTR_BOOL, value: false}
+    ];
+    return this.binding.executeOp('Cast', opAttrs, [id], 1)[0];
+  }
+
+  // ~ tf.data-related (tfjs-node-specific) backend kernels.
+  // ------------------------------------------------------------
+
+  // ------------------------------------------------------------
+  // Training-related (tfjs-node-specific) backend kernels.
+  //
+  // Resource variables are resource-type Tensors whose values live in
+  // TensorFlow. The fused optimizer kernels update them in place.
+
+  varHandleOp(dtype: DataType, shape: number[]): Tensor {
+    const opAttrs = [
+      {name: 'container', type: this.binding.TF_ATTR_STRING, value: ''}, {
+        // Every eager VarHandleOp with the same shared name refers to the same
+        // variable, so each handle gets a unique name.
+        name: 'shared_name',
+        type: this.binding.TF_ATTR_STRING,
+        value: `tfjs_node_variable_${this.nextVariableId++}`
+      },
+      createTypeOpAttr('dtype', dtype),
+      {name: 'shape', type: this.binding.TF_ATTR_SHAPE, value: shape}
+    ];
+    return this.executeSingleOutput('VarHandleOp', opAttrs, []);
+  }
+
+  assignVariable(resourceHandle: Tensor, value: Tensor): void {
+    const opAttrs = [createTensorsTypeOpAttr('dtype', value)];
+    this.executeMultipleOutputs(
+        'AssignVariableOp', opAttrs, [resourceHandle, value], 0);
+  }
+
+  readVariable(resourceHandle: Tensor, dtype: DataType): Tensor {
+    const opAttrs = [createTypeOpAttr('dtype', dtype)];
+    return this.executeSingleOutput(
+        'ReadVariableOp', opAttrs, [resourceHandle]);
+  }
+
+  resourceApplyGradientDescent(
+      variable: Tensor, learningRate: Scalar, gradient: Tensor): void {
+    const opAttrs = [
+      createTensorsTypeOpAttr('T', gradient),
+      {name: 'use_locking', type: this.binding.TF_ATTR_BOOL, value: false}
+    ];
+    this.executeMultipleOutputs(
+        'ResourceApplyGradientDescent', opAttrs,
+        [variable, learningRate, gradient], 0);
+  }
+
+  resourceApplyAdam(
+      variable: Tensor, m: Tensor, v: Tensor, beta1Power: Scalar,
+      beta2Power: Scalar, learningRate: Scalar, beta1: Scalar, beta2: Scalar,
+      epsilon: Scalar, gradient: Tensor): void {
+    const opAttrs = [
+      createTensorsTypeOpAttr('T', gradient),
+      {name: 'use_locking', type: this.binding.TF_ATTR_BOOL, value: false},
+      {name: 'use_nesterov', type: this.binding.TF_ATTR_BOOL, value: false}
+    ];
+    const inputArgs = [
+      variable, m, v, beta1Power, beta2Power, learningRate, beta1, beta2,
+      epsilon, gradient
+    ];
+    this.executeMultipleOutputs('ResourceApplyAdam', opAttrs, inputArgs, 0);
+  }
+
+  resourceApplyRMSProp(
+      variable: Tensor, ms: Tensor, mom: Tensor, learningRate: Scalar,
+      rho: Scalar, momentum: Scalar, epsilon: Scalar, gradient: Tensor): void {
+    const opAttrs = [
+      createTensorsTypeOpAttr('T', gradient),
+      {name: 'use_locking', type: this.binding.TF_ATTR_BOOL, value: false}
+    ];
+    const inputArgs =
+        [variable, ms, mom, learningRate, rho, momentum, epsilon, gradient];
+    this.executeMultipleOutputs('ResourceApplyRMSProp', opAttrs, inputArgs, 0);
+  }
+
+  resourceApplyCenteredRMSProp(
+      variable: Tensor, mg: Tensor, ms: Tensor, mom: Tensor,
+      learningRate: Scalar, rho: Scalar, momentum: Scalar, epsilon: Scalar,
+      gradient: Tensor): void {
+    const opAttrs = [
+      createTensorsTypeOpAttr('T', gradient),
+      {name: 'use_locking', type: this.binding.TF_ATTR_BOOL, value: false}
+    ];
+    const inputArgs =
+        [variable, mg, ms, mom, learningRate, rho, momentum, epsilon, gradient];
+    this.executeMultipleOutputs(
+        'ResourceApplyCenteredRMSProp', opAttrs, inputArgs, 0);
+  }
+
+  /**
+   * Points the data of `dataId` at the current value of a resource variable.
+   * The previous data is released. Unlike `readVariable()`, no new tensor is
+   * registered with tfjs-core, so the tensor with this data ID keeps its
+   * identity.
+   */
+  readVariableInto(dataId: object, resourceHandle: Tensor, dtype: DataType):
+      void {
+    const info = this.tensorMap.get(dataId);
+    const opAttrs = [createTypeOpAttr('dtype', dtype)];
+    const metadata = this.binding.executeOp(
+        'ReadVariableOp', opAttrs, this.getInputTensorIds([resourceHandle]),
+        1)[0];
+    this.releaseNativeData(dataId);
+    info.id = metadata.id;
+  }
+
+  /**
+   * Deletes the TensorFlow tensor that holds the data of `dataId`, e.g., so
+   * that a resource variable whose value it shares can be updated in place.
+   * The data must be restored with `readVariableInto()` before it is read.
+   */
+  releaseNativeData(dataId: object): void {
+    const info = this.tensorMap.get(dataId);
+    if (info.id != null && info.id >= 0) {
+      this.binding.deleteTensor(info.id);
+    }
+    info.id = -1;
+    info.values = null;
+  }
+
+  // ~ Training-related (tfjs-node-specific) backend kernels.
+  // ------------------------------------------------------------
+
+  // ------------------------------------------------------------
+  // Sparse-related (tfjs-node-specific) backend kernels.
+  //
+  // A sparse tensor is represented by its int32 indices, its values and its
+  // dense shape, like a tf.SparseTensor in Python.
+
+  sparseTensorDenseMatMul(
+      indices: Tensor2D, values: Tensor1D, denseShape: number[], b: Tensor2D,
+      adjointA: boolean, adjointB: boolean): Tensor2D {
+    const opAttrs = [
+      createTypeOpAttr('T', values.dtype),
+      createTypeOpAttr('Tindices', 'int32'),
+      {name: 'adjoint_a', type: this.binding.TF_ATTR_BOOL, value: adjointA},
+      {name: 'adjoint_b', type: this.binding.TF_ATTR_BOOL, value: adjointB}
+    ];
+    const temporaryIds: number[] = [];
+    try {
+      // The dense shape must be int64.
+      const shapeId = this.createInt64TensorId(denseShape);
+      temporaryIds.push(shapeId);
+      const [indicesId, valuesId, bId] =
+          this.getInputTensorIds([indices, values, b]);
+      const outputMetadata = this.binding.executeOp(
+          'SparseTensorDenseMatMul', opAttrs,
+          [indicesId, valuesId, shapeId, bId], 1);
+      return this.createOutputTensor(outputMetadata[0]) as Tensor2D;
+    } finally {
+      temporaryIds.forEach(id => this.binding.deleteTensor(id));
+    }
+  }
+
+  /**
+   * Reduces the rows `data[indices[i]]` that have the same segment ID. This
+   * gathers and reduces in one kernel, e.g., for embedding lookups. Without
+   * `numSegments`, the number of segments is the last segment ID plus one.
+   */
+  sparseSegmentReduction(
+      reduction: 'Sum'|'Mean'|'SqrtN', data: Tensor, indices: Tensor1D,
+      segmentIds: Tensor1D, numSegments?: number): Tensor {
+    const opAttrs =
+        [createTypeOpAttr('T', data.dtype), createTypeOpAttr('Tidx', 'int32')];
+    if (numSegments == null) {
+      return this.executeSingleOutput(
+          `SparseSegment${reduction}`, opAttrs, [data, indices, segmentIds]);
+    }
+    opAttrs.push(createTypeOpAttr('Tnumsegments', 'int32'));
+    const numSegmentsTensor = scalar(numSegments, 'int32');
+    try {
+      return this.executeSingleOutput(
+          `SparseSegment${reduction}WithNumSegments`, opAttrs,
+          [data, indices, segmentIds, numSegmentsTensor]);
+    } finally {
+      numSegmentsTensor.dispose();
+    }
+  }
+
+  // Creates a 1D int64-type tensor of non-negative int32-range values, e.g.,
+  // a shape, without registering it with tfjs-core. The caller is expected
+  // to delete it.
+  private createInt64TensorId(values: number[]): number {
+    // int64 values are represented as pairs of int32 values (little endian),
+    // see int64_tensors.ts.
+    const pairs = new Int32Array(values.length * 2);
+    values.forEach((value, i) => pairs[i * 2] = value);
+    return this.binding.createTensor(
+        [values.length], this.binding.TF_INT64, pairs);
+  }
+
+  // ~ Sparse-related (tfjs-node-specific) backend kernels.
+  // ------------------------------------------------------------
+
+  // ------------------------------------------------------------
+  // Quantization-related (tfjs-node-specific) backend kernels.
+  //
+  // Quantized Tensors (TF_QUINT8, TF_QINT32) are represented as 'int32'
+  // Tensors in TFJS and are only meant to be passed between these kernels.
+  // Every quantized value is accompanied by the float range it represents.
+
+  private quantizedTypeOpAttr(attrName: string, tfDType: number): TFEOpAttr {
+    return {name: attrName, type: this.binding.TF_ATTR_TYPE, value: tfDType};
+  }
+
+  quantizeV2(x: Tensor, minRange: Scalar, maxRange: Scalar, mode = 'MIN_FIRST'):
+      [Tensor, Scalar, Scalar] {
+    const opAttrs = [
+      this.quantizedTypeOpAttr('T', this.binding.TF_QUINT8),
+      {name: 'mode', type: this.binding.TF_ATTR_STRING, value: mode}, {
+        name: 'round_mode',
+        type: this.binding.TF_ATTR_STRING,
+        value: 'HALF_AWAY_FROM_ZERO'
+      }
+    ];
+    return this.executeMultipleOutputs(
+               'QuantizeV2', opAttrs, [x, minRange, maxRange], 3) as
+        [Tensor, Scalar, Scalar];
+  }
+
+  quantizedMatMul(
+      a: Tensor2D, b: Tensor2D, minA: Scalar, maxA: Scalar, minB: Scalar,
+      maxB: Scalar, transposeA = false,
+      transposeB = false): [Tensor2D, Scalar, Scalar] {
+    const opAttrs = [
+      this.quantizedTypeOpAttr('T1', this.binding.TF_QUINT8),
+      this.quantizedTypeOpAttr('T2', this.binding.TF_QUINT8),
+      this.quantizedTypeOpAttr('Toutput', this.binding.TF_QINT32),
+      {name: 'transpose_a', type: this.binding.TF_ATTR_BOOL, value: transposeA},
+      {name: 'transpose_b', type: this.binding.TF_ATTR_BOOL, value: transposeB},
+      this.quantizedTypeOpAttr('Tactivation', this.binding.TF_QUINT8)
+    ];
+    return this.executeMultipleOutputs(
+               'QuantizedMatMul', opAttrs, [a, b, minA, maxA, minB, maxB],
+               3) as [Tensor2D, Scalar, Scalar];
+  }
+
+  quantizedConv2D(
+      x: Tensor4D, filter: Tensor4D, minX: Scalar, maxX: Scalar,
+      minFilter: Scalar, maxFilter: Scalar,
+      convInfo: Conv2DInfo): [Tensor4D, Scalar, Scalar] {
+    if (convInfo.padInfo.type !== 'VALID' && convInfo.padInfo.type !== 'SAME') {
+      throw new Error(
+          `TF Backend supports only 'valid' and 'same' padding ` +
+          `while padding was ${convInfo.padInfo.type}`);
+    }
+    // The quantized kernel supports only NHWC inputs without dilation.
+    const opAttrs = [
+      this.quantizedTypeOpAttr('Tinput', this.binding.TF_QUINT8),
+      this.quantizedTypeOpAttr('Tfilter', this.binding.TF_QUINT8),
+      this.quantizedTypeOpAttr('out_type', this.binding.TF_QINT32),
+      {
+        name: 'strides',
+        type: this.binding.TF_ATTR_INT,
+        value: [1, convInfo.strideHeight, convInfo.strideWidth, 1]
+      },
+      {
+        name: 'padding',
+        type: this.binding.TF_ATTR_STRING,
+        value: convInfo.padInfo.type
+      },
+      {name: 'dilations', type: this.binding.TF_ATTR_INT, value: [1, 1, 1, 1]}
+    ];
+    const inputArgs = [x, filter, minX, maxX, minFilter, maxFilter];
+    return this.executeMultipleOutputs(
+               'QuantizedConv2D', opAttrs, inputArgs, 3) as
+        [Tensor4D, Scalar, Scalar];
+  }
+
+  dequantize(
+      x: Tensor, minRange: Scalar, maxRange: Scalar, quantizedDType: number,
+      mode = 'MIN_FIRST'): Tensor {
+    const opAttrs = [
+      {name: 'T', type: this.binding.TF_ATTR_TYPE, value: quantizedDType},
+      {name: 'mode', type: this.binding.TF_ATTR_STRING, value: mode}
+    ];
+    return this.executeSingleOutput(
+        'Dequantize', opAttrs, [x, minRange, maxRange]);
+  }
+
+  // ~ Quantization-related (tfjs-node-specific) backend kernels.
+  // ------------------------------------------------------------
+
   memory() {
-    // Due to automatic garbage collection, the numbers are unreliable.
-    // TODO(kreeger): Since there is finalization in C, count the true
-    // number of undisposed tensors.
-    return {unreliable: true};
+    // Due to automatic garbage collection, the numbers are unreliable. The
+    // native numbers count the tensors that are held by TensorFlow.
+    const nativeMemory = this.binding.getMemoryInfo();
+    return {
+      unreliable: true,
+      numNativeTensors: nativeMemory.numTensors,
+      numNativeBytes: nativeMemory.numBytes,
+      numTensorsAutoReleased: this.numTensorsAutoReleased,
+      numBytesAutoReleased: this.numBytesAutoReleased
+    };
   }
 
   async time(f: () => void): Promise<BackendTimingInfo> {
@@ -1869,3 +3057,29 @@ export class NodeJSKernelBackend extends KernelBackend {
     return {kernelMs: elapsed[0] * 1000 + elapsed[1] / 1000000};
   }
 }
+
+/**
+ * Returns the flat offset of the first element of a slice, or -1 if the
+ * elements of the slice are not contiguous in memory. That is the case unless
+ * the slice has size 1 along every axis before some axis, and spans every axis
+ * after it.
+ */
+function getContiguousSliceOffset(
+    shape: number[], begin: number[], size: number[]): number {
+  let axis = 0;
+  while (axis < shape.length && size[axis] === 1) {
+    axis++;
+  }
+  for (let i = axis + 1; i < shape.length; i++) {
+    if (size[i] !== shape[i]) {
+      return -1;
+    }
+  }
+  let offset = 0;
+  let stride = 1;
+  for (let i = shape.length - 1; i >= 0; i--) {
+    offset += begin[i] * stride;
+    stride *= shape[i];
+  }
+  return offset;
+}
@@ -19,8 +19,23 @@ import * as tf from '@tensorflow/tfjs-core';
 import {Tensor5D} from '@tensorflow/tfjs-core/dist/tensor';
 // tslint:disable-next-line:max-line-length
 import {expectArraysClose} from '@tensorflow/tfjs-core/dist/test_util';
+import * as v8 from 'v8';
+import * as vm from 'vm';
+
 import {NodeJSKernelBackend} from './nodejs_kernel_backend';
 
+// Returns a function that forces a full garbage collection. Uses `global.gc`
+// when Node.js runs with `--expose-gc`, and exposes it otherwise.
+function getGC(): () => void {
+  // tslint:disable-next-line:no-any
+  const gc = (global as any).gc;
+  if (gc != null) {
+    return gc;
+  }
+  v8.setFlagsFromString('--expose-gc');
+  return vm.runInNewContext('gc');
+}
+
 describe('delayed upload', () => {
   it('should handle data before op execution', async () => {
     const t = tf.tensor1d([1, 2, 3]);
@@ -64,3 +79,256 @@ describe('conv3d dilations', () => {
     }
   });
 });
+
+describe('native memory', () => {
+  it('counts the bytes of uploaded tensors', () => {
+    const backend = tf.backend() as NodeJSKernelBackend;
+    const before = backend.memory();
+    const numShared = () => backend.binding.getTensorUploadStats().numShared;
+    const numSharedBefore = numShared();
+
+    const t = tf.tensor1d([1, 2, 3]);
+    const r = t.add(t);
+    // An upload that shares the typed array owns no native memory.
+    const numOwning = 2 - (numShared() - numSharedBefore);
+    expect(backend.memory().numNativeTensors)
+        .toEqual(before.numNativeTensors + 2);
+    expect(backend.memory().numNativeBytes)
+        .toEqual(before.numNativeBytes + numOwning * 3 * 4);
+
+    tf.dispose([t, r]);
+    expect(backend.memory().numNativeTensors)
+        .toEqual(before.numNativeTensors);
+    expect(backend.memory().numNativeBytes).toEqual(before.numNativeBytes);
+  });
+
+  it('enableAutoRelease() requires FinalizationRegistry', () => {
+    // tslint:disable-next-line:no-any
+    if ((global as any).FinalizationRegistry == null) {
+      const backend = tf.backend() as NodeJSKernelBackend;
+      expect(() => backend.enableAutoRelease())
+          .toThrowError(/FinalizationRegistry/);
+    }
+  });
+
+  it('releases the native tensors of garbage-collected tensors', async () => {
+    // tslint:disable-next-line:no-any
+    if ((global as any).FinalizationRegistry == null) {
+      return;
+    }
+    // Auto release cannot be turned off, so enable it on a separate backend
+    // to leave the other tests unaffected.
+    const binding = (tf.backend() as NodeJSKernelBackend).binding;
+    const backend =
+        new NodeJSKernelBackend(binding, '@tensorflow/tfjs-node');
+    tf.registerBackend('tensorflow-auto-release', () => backend);
+    tf.setBackend('tensorflow-auto-release');
+    try {
+      backend.enableAutoRelease();
+      const before = backend.memory();
+      // Drops the only references to the inputs and the output of an op,
+      // which all hold native tensors once the op runs.
+      (() => {
+        tf.add(tf.tensor1d([1, 2, 3]), tf.tensor1d([4, 5, 6]));
+      })();
+      expect(backend.memory().numNativeTensors)
+          .toEqual(before.numNativeTensors + 3);
+
+      // Finalization callbacks run in a task after the collection.
+      const gc = getGC();
+      const numReleased = () => backend.memory().numTensorsAutoReleased -
+          before.numTensorsAutoReleased;
+      for (let i = 0; i < 100 && numReleased() < 3; i++) {
+        gc();
+        await new Promise(resolve => setTimeout(resolve, 10));
+      }
+
+      const after = backend.memory();
+      expect(numReleased()).toEqual(3);
+      // The output owns its values, the inputs may share their typed arrays.
+      expect(after.numBytesAutoReleased)
+          .toBeGreaterThanOrEqual(before.numBytesAutoReleased + 3 * 4);
+      expect(after.numNativeTensors).toEqual(before.numNativeTensors);
+    } finally {
+      tf.setBackend('tensorflow');
+      tf.removeBackend('tensorflow-auto-release');
+    }
+  });
+});
+
+describe('tensor views', () => {
+  let backend: NodeJSKernelBackend;
+  let opNames: string[];
+
+  beforeEach(() => {
+    backend = tf.backend() as NodeJSKernelBackend;
+    opNames = [];
+    backend.setOpObserver(name => opNames.push(name));
+  });
+
+  afterEach(() => {
+    backend.setOpObserver(null);
+  });
+
+  // Views are only created for tensors that are placed on the host CPU.
+  function expectNoOpsExecuted() {
+    if (!backend.isGPUPackage) {
+      expect(opNames).toEqual([]);
+    }
+  }
+
+  it('reshape does not execute an op', async () => {
+    const x = tf.tensor1d([1, 2, 3, 4, 5, 6]).neg();
+    opNames = [];
+    const r = x.reshape([2, 3]);
+    expectNoOpsExecuted();
+    expect(r.shape).toEqual([2, 3]);
+    expectArraysClose(await r.data(), [-1, -2, -3, -4, -5, -6]);
+  });
+
+  it('contiguous slices do not execute an op', async () => {
+    const x = tf.tensor3d([1, 2, 3, 4, 5, 6, 7, 8], [2, 2, 2]).neg();
+    opNames = [];
+    const a = x.slice([1, 0, 0], [1, 2, 2]);
+    const b = x.slice([0, 1, 0], [1, 1, 2]);
+    const c = x.slice([1, 1, 1], [1, 1, 1]);
+    expectNoOpsExecuted();
+    expectArraysClose(await a.data(), [-5, -6, -7, -8]);
+    expectArraysClose(await b.data(), [-3, -4]);
+    expectArraysClose(await c.data(), [-8]);
+  });
+
+  it('non-contiguous slices execute Slice', async () => {
+    const x = tf.tensor2d([1, 2, 3, 4, 5, 6], [2, 3]).neg();
+    opNames = [];
+    const r = x.slice([0, 1], [2, 2]);
+    expect(opNames).toEqual(['Slice']);
+    expectArraysClose(await r.data(), [-2, -3, -5, -6]);
+  });
+
+  it('split and unstack along the first axis do not execute an op',
+     async () => {
+       const x = tf.tensor2d([1, 2, 3, 4, 5, 6], [3, 2]).neg();
+       opNames = [];
+       const [a, b] = tf.split(x, [1, 2], 0);
+       const rows = tf.unstack(x);
+       expectNoOpsExecuted();
+       expect(b.shape).toEqual([2, 2]);
+       expectArraysClose(await a.data(), [-1, -2]);
+       expectArraysClose(await b.data(), [-3, -4, -5, -6]);
+       expect(rows.length).toEqual(3);
+       expect(rows[2].shape).toEqual([2]);
+       expectArraysClose(await rows[2].data(), [-5, -6]);
+     });
+
+  it('views do not count as native memory', () => {
+    const x = tf.tensor2d([1, 2, 3, 4, 5, 6], [3, 2]).neg();
+    const numBytes = backend.binding.getMemoryInfo().numBytes;
+    const reshaped = x.reshape([2, 3]);
+    const rows = tf.split(x, 3);
+    if (!backend.isGPUPackage) {
+      expect(backend.binding.getMemoryInfo().numBytes).toEqual(numBytes);
+    }
+    tf.dispose([reshaped, ...rows]);
+    expect(backend.binding.getMemoryInfo().numBytes).toEqual(numBytes);
+  });
+
+  it('views stay valid after the viewed tensor is disposed', async () => {
+    const x = tf.tensor2d([1, 2, 3, 4], [2, 2]).neg();
+    const row = x.slice([1, 0], [1, 2]);
+    x.dispose();
+    expectArraysClose(await row.add(1).data(), [-2, -3]);
+  });
+
+  it('views of tensors that were not uploaded share the values', async () => {
+    const x = tf.tensor2d([1, 2, 3, 4], [2, 2]);
+    const row = x.slice([1, 0], [1, 2]);
+    expectArraysClose(await row.neg().data(), [-3, -4]);
+    expectArraysClose(await x.neg().data(), [-1, -2, -3, -4]);
+  });
+});
+
+describe('concat of values that were not uploaded', () => {
+  let backend: NodeJSKernelBackend;
+  let opNames: string[];
+
+  beforeEach(() => {
+    backend = tf.backend() as NodeJSKernelBackend;
+    opNames = [];
+    backend.setOpObserver(name => opNames.push(name));
+  });
+
+  afterEach(() => {
+    backend.setOpObserver(null);
+  });
+
+  it('copies the values into one tensor without ConcatV2', async () => {
+    const a = tf.tensor2d([1, 2], [1, 2]);
+    const b = tf.tensor2d([3, 4, 5, 6], [2, 2]);
+    const r = tf.concat([a, b], 0);
+    expect(opNames).toEqual([]);
+    expect(r.shape).toEqual([3, 2]);
+    expect(r.dtype).toEqual('float32');
+    expectArraysClose(await r.data(), [1, 2, 3, 4, 5, 6]);
+  });
+
+  it('supports int32 and bool tensors, and stack()', async () => {
+    const ints = tf.stack(
+        [tf.tensor1d([1, 2], 'int32'), tf.tensor1d([3, 4], 'int32')]);
+    const bools = tf.concat([tf.tensor1d([true]), tf.tensor1d([false, true])]);
+    expect(opNames).toEqual([]);
+    expect(ints.dtype).toEqual('int32');
+    expect(ints.shape).toEqual([2, 2]);
+    expectArraysClose(await ints.data(), [1, 2, 3, 4]);
+    expect(bools.dtype).toEqual('bool');
+    expectArraysClose(await bools.data(), [1, 0, 1]);
+  });
+
+  it('executes ConcatV2 for inner axes and uploaded tensors', async () => {
+    const a = tf.tensor2d([1, 2, 3, 4], [2, 2]);
+    const b = tf.tensor2d([5, 6], [2, 1]);
+    const inner = tf.concat([a, b], 1);
+    expect(opNames).toEqual(['ConcatV2']);
+    expectArraysClose(await inner.data(), [1, 2, 5, 3, 4, 6]);
+
+    const uploaded = tf.tensor1d([1, 2]).neg();
+    opNames = [];
+    const mixed = tf.concat([uploaded, tf.tensor1d([3])]);
+    expect(opNames).toEqual(['ConcatV2']);
+    expectArraysClose(await mixed.data(), [-1, -2, 3]);
+  });
+
+  it('createTensorFromChunks() checks the size of the chunks', () => {
+    expect(
+        () => backend.createTensorFromChunks(
+            [3], 'float32', [new Float32Array(1), new Float32Array(1)]))
+        .toThrowError(/Shape does not match/);
+    expect(
+        () => backend.createTensorFromChunks(
+            [2], 'float32', [new Int32Array(1), new Int32Array(1)]))
+        .toThrowError(/Float32Array|Int32Array/);
+    // The chunks are checked before the tensor is allocated.
+    expect(
+        () => backend.createTensorFromChunks(
+            [2 ** 40], 'float32', [new Float32Array(1)]))
+        .toThrowError(/Shape does not match/);
+  });
+
+  it('createTensorFromChunks() copies large chunks in parallel', async () => {
+    const chunkLength = 1 << 18;
+    for (let call = 0; call < 2; call++) {
+      const chunks: Float32Array[] = [];
+      for (let i = 0; i < 4; i++) {
+        chunks.push(new Float32Array(chunkLength).fill(call * 4 + i));
+      }
+      const x = backend.createTensorFromChunks(
+          [4 * chunkLength], 'float32', chunks);
+      const values = await x.data();
+      for (let i = 0; i < 4; i++) {
+        expect(values[i * chunkLength]).toEqual(call * 4 + i);
+        expect(values[(i + 1) * chunkLength - 1]).toEqual(call * 4 + i);
+      }
+      x.dispose();
+    }
+  });
+});
@@ -0,0 +1,413 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {AdamOptimizer, dispose, keep, RMSPropOptimizer, Scalar, scalar, SGDOptimizer, Tensor, tidy, util, Variable} from '@tensorflow/tfjs-core';
+import {ENGINE} from '@tensorflow/tfjs-core/dist/engine';
+// tslint:disable-next-line:max-line-length
+import {NamedTensor, NamedTensorMap} from '@tensorflow/tfjs-core/dist/tensor_types';
+import {nodeBackend} from './ops/op_utils';
+import {ResourceVariable} from './resource_variable';
+
+/** The resource variables that mirror one weight and its optimizer slots. */
+interface MirrorEntry {
+  // Null for a `ResourceVariable`, which is updated directly.
+  weight: Tensor;
+  slots: Tensor[];
+  // The data ID of the weight value that `weight` holds. The weight is copied
+  // to TensorFlow again when the variable was assigned elsewhere.
+  dataId: object;
+}
+
+/**
+ * Mirrors model weights and optimizer slots (e.g., the moments of Adam) in
+ * TensorFlow resource variables, which the fused optimizer kernels update in
+ * place.
+ */
+class ResourceVariableMirrors {
+  private entries: {[name: string]: MirrorEntry} = {};
+
+  /** @param slotNames The suffixes of the slot weight names, e.g. `'m'`. */
+  constructor(private readonly slotNames: string[]) {}
+
+  /**
+   * Runs `apply` to update the weight `variable` and its slots in place. The
+   * slots are created with zeros on first use.
+   *
+   * A `ResourceVariable` is updated directly. Other variables are mirrored in
+   * a resource variable, which is copied back into the variable afterwards.
+   */
+  update(
+      name: string, variable: Variable,
+      apply: (weight: Tensor, slots: Tensor[]) => void) {
+    util.assert(
+        variable.dtype === 'float32',
+        () => `Native optimizers support float32 variables only, but ` +
+            `'${name}' has dtype ${variable.dtype}`);
+    let entry = this.entries[name];
+    if (entry == null) {
+      entry = {weight: null, slots: [], dataId: null};
+      const zeros = variable.zerosLike();
+      for (let i = 0; i < this.slotNames.length; ++i) {
+        entry.slots.push(this.createVariable(zeros));
+      }
+      zeros.dispose();
+      this.entries[name] = entry;
+    }
+    if (variable instanceof ResourceVariable) {
+      variable.update(handle => apply(handle, entry.slots));
+      return;
+    }
+
+    const backend = nodeBackend();
+    if (entry.weight == null) {
+      entry.weight = this.createVariable(variable);
+    } else if (entry.dataId !== variable.dataId) {
+      backend.assignVariable(entry.weight, variable);
+    }
+    apply(entry.weight, entry.slots);
+    tidy(() => {
+      variable.assign(backend.readVariable(entry.weight, 'float32'));
+    });
+    entry.dataId = variable.dataId;
+  }
+
+  /**
+   * Returns the slot values, all values of the first slot first, named
+   * `<variable name>/<slot name>` as the tfjs-core optimizers do.
+   */
+  getSlotWeights(): NamedTensor[] {
+    const backend = nodeBackend();
+    const weights: NamedTensor[] = [];
+    this.slotNames.forEach((slotName, i) => {
+      for (const name of Object.keys(this.entries)) {
+        weights.push({
+          name: `${name}/${slotName}`,
+          tensor: backend.readVariable(this.entries[name].slots[i], 'float32')
+        });
+      }
+    });
+    return weights;
+  }
+
+  /** Replaces the slot values with ones returned by `getSlotWeights()`. */
+  setSlotWeights(weights: NamedTensor[]) {
+    this.dispose();
+    for (const {name, tensor} of weights) {
+      const separator = name.lastIndexOf('/');
+      const variableName = name.slice(0, separator);
+      const slotIndex = this.slotNames.indexOf(name.slice(separator + 1));
+      util.assert(
+          slotIndex >= 0, () => `Unexpected optimizer weight name: ${name}`);
+      if (this.entries[variableName] == null) {
+        this.entries[variableName] = {weight: null, slots: [], dataId: null};
+      }
+      this.entries[variableName].slots[slotIndex] =
+          this.createVariable(tensor);
+    }
+  }
+
+  dispose() {
+    const backend = nodeBackend();
+    for (const name of Object.keys(this.entries)) {
+      const entry = this.entries[name];
+      for (const handle of [entry.weight, ...entry.slots]) {
+        if (handle != null) {
+          backend.destroyResource(handle);
+          handle.dispose();
+        }
+      }
+    }
+    this.entries = {};
+  }
+
+  private createVariable(initialValue: Tensor): Tensor {
+    const backend = nodeBackend();
+    const handle =
+        keep(backend.varHandleOp(initialValue.dtype, initialValue.shape));
+    backend.assignVariable(handle, initialValue);
+    return handle;
+  }
+}
+
+/** Normalizes the argument of `Optimizer.applyGradients()`. */
+function getNamedGradients(variableGradients: NamedTensorMap|
+                           NamedTensor[]): NamedTensor[] {
+  if (Array.isArray(variableGradients)) {
+    return variableGradients;
+  }
+  return Object.keys(variableGradients)
+      .map(name => ({name, tensor: variableGradients[name]}));
+}
+
+/** Returns the registered variable for a gradient. */
+function getVariable(name: string): Variable {
+  const variable = ENGINE.registeredVariables[name];
+  util.assert(variable != null, () => `Unknown variable: ${name}`);
+  return variable;
+}
+
+/**
+ * Stochastic gradient descent that updates the weights with TensorFlow's
+ * fused `ResourceApplyGradientDescent` kernel.
+ */
+export class NativeSGDOptimizer extends SGDOptimizer {
+  private readonly mirrors = new ResourceVariableMirrors([]);
+  private learningRateScalar: Scalar = null;
+
+  constructor(learningRate: number) {
+    super(learningRate);
+  }
+
+  applyGradients(variableGradients: NamedTensorMap|NamedTensor[]) {
+    const backend = nodeBackend();
+    if (this.learningRateScalar == null) {
+      this.learningRateScalar = keep(scalar(this.learningRate));
+    }
+    for (const {name, tensor: gradient} of getNamedGradients(
+             variableGradients)) {
+      if (gradient == null) {
+        continue;
+      }
+      this.mirrors.update(
+          name, getVariable(name),
+          weight => backend.resourceApplyGradientDescent(
+              weight, this.learningRateScalar, gradient));
+    }
+    this.incrementIterations();
+  }
+
+  setLearningRate(learningRate: number) {
+    super.setLearningRate(learningRate);
+    if (this.learningRateScalar != null) {
+      this.learningRateScalar.dispose();
+      this.learningRateScalar = null;
+    }
+  }
+
+  dispose() {
+    super.dispose();
+    this.mirrors.dispose();
+    if (this.learningRateScalar != null) {
+      this.learningRateScalar.dispose();
+      this.learningRateScalar = null;
+    }
+  }
+
+  async getWeights(): Promise<NamedTensor[]> {
+    return [await this.saveIterations()];
+  }
+
+  async setWeights(weightValues: NamedTensor[]): Promise<void> {
+    weightValues = await this.extractIterations(weightValues);
+    if (weightValues.length !== 0) {
+      throw new Error('SGD optimizer does not have settable weights.');
+    }
+  }
+}
+
+/**
+ * The Adam algorithm, with the first and second moments in TensorFlow
+ * resource variables that the fused `ResourceApplyAdam` kernel updates.
+ *
+ * Note that TensorFlow applies `epsilon` after the bias correction of the
+ * learning rate ("epsilon hat" in the Adam paper), so results differ slightly
+ * from `tf.train.adam()` for large `epsilon` values.
+ */
+export class NativeAdamOptimizer extends AdamOptimizer {
+  private readonly mirrors = new ResourceVariableMirrors(['m', 'v']);
+  private hyperparameters: Scalar[] = null;
+
+  constructor(
+      learningRate: number, beta1: number, beta2: number, epsilon?: number) {
+    super(learningRate, beta1, beta2, epsilon);
+  }
+
+  applyGradients(variableGradients: NamedTensorMap|NamedTensor[]) {
+    const backend = nodeBackend();
+    if (this.hyperparameters == null) {
+      this.hyperparameters = [
+        this.learningRate, this.beta1, this.beta2, this.epsilon
+      ].map(value => keep(scalar(value)));
+    }
+    const [learningRate, beta1, beta2, epsilon] = this.hyperparameters;
+    const step = this.iterations + 1;
+    tidy(() => {
+      const beta1Power = scalar(Math.pow(this.beta1, step));
+      const beta2Power = scalar(Math.pow(this.beta2, step));
+      for (const {name, tensor: gradient} of getNamedGradients(
+               variableGradients)) {
+        if (gradient == null) {
+          continue;
+        }
+        this.mirrors.update(
+            name, getVariable(name),
+            (weight, [m, v]) => backend.resourceApplyAdam(
+                weight, m, v, beta1Power, beta2Power, learningRate, beta1,
+                beta2, epsilon, gradient));
+      }
+    });
+    this.incrementIterations();
+  }
+
+  dispose() {
+    super.dispose();
+    this.mirrors.dispose();
+    if (this.hyperparameters != null) {
+      dispose(this.hyperparameters);
+      this.hyperparameters = null;
+    }
+  }
+
+  async getWeights(): Promise<NamedTensor[]> {
+    return [await this.saveIterations(), ...this.mirrors.getSlotWeights()];
+  }
+
+  async setWeights(weightValues: NamedTensor[]): Promise<void> {
+    weightValues = await this.extractIterations(weightValues);
+    this.mirrors.setSlotWeights(weightValues);
+  }
+}
+
+/**
+ * The RMSProp algorithm, with the slots in TensorFlow resource variables that
+ * the fused `ResourceApplyRMSProp` or `ResourceApplyCenteredRMSProp` kernel
+ * updates.
+ */
+export class NativeRMSPropOptimizer extends RMSPropOptimizer {
+  private readonly mirrors: ResourceVariableMirrors;
+  private hyperparameters: Scalar[] = null;
+
+  constructor(
+      learningRate: number, decay = 0.9, momentum = 0.0, epsilon?: number,
+      private readonly isCentered = false) {
+    super(learningRate, decay, momentum, epsilon, isCentered);
+    this.mirrors = new ResourceVariableMirrors(
+        isCentered ? ['rms', 'momentum', 'mg'] : ['rms', 'momentum']);
+  }
+
+  applyGradients(variableGradients: NamedTensorMap|NamedTensor[]) {
+    const backend = nodeBackend();
+    if (this.hyperparameters == null) {
+      this.hyperparameters = [
+        this.learningRate, this.decay, this.momentum, this.epsilon
+      ].map(value => keep(scalar(value)));
+    }
+    const [learningRate, decay, momentum, epsilon] = this.hyperparameters;
+    for (const {name, tensor: gradient} of getNamedGradients(
+             variableGradients)) {
+      if (gradient == null) {
+        continue;
+      }
+      this.mirrors.update(name, getVariable(name), (weight, [ms, mom, mg]) => {
+        if (this.isCentered) {
+          backend.resourceApplyCenteredRMSProp(
+              weight, mg, ms, mom, learningRate, decay, momentum, epsilon,
+              gradient);
+        } else {
+          backend.resourceApplyRMSProp(
+              weight, ms, mom, learningRate, decay, momentum, epsilon,
+              gradient);
+        }
+      });
+    }
+    this.incrementIterations();
+  }
+
+  dispose() {
+    super.dispose();
+    this.mirrors.dispose();
+    if (this.hyperparameters != null) {
+      dispose(this.hyperparameters);
+      this.hyperparameters = null;
+    }
+  }
+
+  async getWeights(): Promise<NamedTensor[]> {
+    return [await this.saveIterations(), ...this.mirrors.getSlotWeights()];
+  }
+
+  async setWeights(weightValues: NamedTensor[]): Promise<void> {
+    weightValues = await this.extractIterations(weightValues);
+    this.mirrors.setSlotWeights(weightValues);
+  }
+}
+
+/**
+ * Constructs a `tf.SGDOptimizer` that updates the weights with TensorFlow's
+ * fused `ResourceApplyGradientDescent` kernel.
+ *
+ * The native optimizers keep the weights and optimizer state in TensorFlow
+ * resource variables and update them in place with one kernel per weight,
+ * instead of a chain of elementwise ops. They are drop-in replacements for
+ * the optimizers in `tf.train`:
+ *
+ * ```js
+ * model.compile({optimizer: tf.node.train.sgd(0.1), loss: 'meanSquaredError'});
+ * ```
+ *
+ * @param learningRate The learning rate to use for the SGD algorithm.
+ */
+/**
+ * @doc {heading: 'Training', subheading: 'Optimizers', namespace: 'node'}
+ */
+function sgd(learningRate: number): NativeSGDOptimizer {
+  return new NativeSGDOptimizer(learningRate);
+}
+
+/**
+ * Constructs a `tf.AdamOptimizer` that updates the weights with TensorFlow's
+ * fused `ResourceApplyAdam` kernel. See `tf.node.train.sgd()`.
+ *
+ * @param learningRate The learning rate to use for the Adam algorithm.
+ * @param beta1 The exponential decay rate for the 1st moment estimates.
+ * @param beta2 The exponential decay rate for the 2nd moment estimates.
+ * @param epsilon A small constant for numerical stability.
+ */
+/**
+ * @doc {heading: 'Training', subheading: 'Optimizers', namespace: 'node'}
+ */
+function adam(
+    learningRate = 0.001, beta1 = 0.9, beta2 = 0.999,
+    epsilon: number = null): NativeAdamOptimizer {
+  return new NativeAdamOptimizer(learningRate, beta1, beta2, epsilon);
+}
+
+/**
+ * Constructs a `tf.RMSPropOptimizer` that updates the weights with
+ * TensorFlow's fused `ResourceApplyRMSProp` kernel, or
+ * `ResourceApplyCenteredRMSProp` if `centered` is true. See
+ * `tf.node.train.sgd()`.
+ *
+ * @param learningRate The learning rate to use for the RMSProp algorithm.
+ * @param decay The discounting factor for the history/coming gradient.
+ * @param momentum The momentum to use for the RMSProp algorithm.
+ * @param epsilon Small value to avoid zero denominator.
+ * @param centered If true, gradients are normalized by the estimated
+ *   variance of the gradient.
+ */
+/**
+ * @doc {heading: 'Training', subheading: 'Optimizers', namespace: 'node'}
+ */
+function rmsprop(
+    learningRate: number, decay = .9, momentum = 0.0, epsilon: number = null,
+    centered = false): NativeRMSPropOptimizer {
+  return new NativeRMSPropOptimizer(
+      learningRate, decay, momentum, epsilon, centered);
+}
+
+export const train = {sgd, adam, rmsprop};
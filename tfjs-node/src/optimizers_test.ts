@@ -0,0 +1,129 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+/**
+ * Minimizes `sum((x - target)^2)` with `optimizer` and returns the values of
+ * `x` after `numSteps` steps.
+ */
+function minimize(
+    optimizer: tf.Optimizer, numSteps: number): Float32Array|Int32Array|
+    Uint8Array {
+  const x = tf.variable(tf.tensor1d([1, -2, 3, 0.5]));
+  const target = tf.tensor1d([0.5, 1, -1, 2]);
+  for (let i = 0; i < numSteps; ++i) {
+    optimizer.minimize(() => x.sub(target).square().sum() as tf.Scalar);
+  }
+  const values = x.dataSync();
+  x.dispose();
+  target.dispose();
+  return values;
+}
+
+describe('tf.node.train', () => {
+  it('sgd matches tf.train.sgd', () => {
+    const optimizer = tf.node.train.sgd(0.1);
+    tf.test_util.expectArraysClose(
+        minimize(optimizer, 5), minimize(tf.train.sgd(0.1), 5));
+    expect(optimizer.iterations).toEqual(5);
+    optimizer.dispose();
+  });
+
+  it('adam matches tf.train.adam', () => {
+    const optimizer = tf.node.train.adam(0.1, 0.9, 0.999, 1e-8);
+    tf.test_util.expectArraysClose(
+        minimize(optimizer, 5),
+        minimize(tf.train.adam(0.1, 0.9, 0.999, 1e-8), 5));
+    optimizer.dispose();
+  });
+
+  it('rmsprop matches tf.train.rmsprop', () => {
+    const optimizer = tf.node.train.rmsprop(0.05, 0.9, 0.5, 1e-8);
+    tf.test_util.expectArraysClose(
+        minimize(optimizer, 5),
+        minimize(tf.train.rmsprop(0.05, 0.9, 0.5, 1e-8), 5));
+    optimizer.dispose();
+  });
+
+  it('centered rmsprop matches tf.train.rmsprop', () => {
+    const optimizer = tf.node.train.rmsprop(0.05, 0.9, 0.5, 1e-8, true);
+    tf.test_util.expectArraysClose(
+        minimize(optimizer, 5),
+        minimize(tf.train.rmsprop(0.05, 0.9, 0.5, 1e-8, true), 5));
+    optimizer.dispose();
+  });
+
+  it('Does not leak tensors while training', () => {
+    const optimizer = tf.node.train.adam(0.1);
+    const x = tf.variable(tf.tensor1d([1, 2, 3]));
+    optimizer.minimize(() => x.square().sum() as tf.Scalar);
+    const numTensors = tf.memory().numTensors;
+    for (let i = 0; i < 5; ++i) {
+      optimizer.minimize(() => x.square().sum() as tf.Scalar);
+    }
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    x.dispose();
+    optimizer.dispose();
+  });
+
+  it('Picks up weights that are assigned between steps', () => {
+    const optimizer = tf.node.train.sgd(0.5);
+    const x = tf.variable(tf.scalar(4));
+    optimizer.minimize(() => x.square() as tf.Scalar);
+    x.assign(tf.scalar(10));
+    optimizer.minimize(() => x.square() as tf.Scalar);
+    // x -= 0.5 * 2x
+    tf.test_util.expectArraysClose(x.dataSync(), [0]);
+    x.dispose();
+    optimizer.dispose();
+  });
+
+  it('Trains a model with model.fit()', async () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 1, inputShape: [2]}));
+    model.compile(
+        {optimizer: tf.node.train.adam(0.05), loss: 'meanSquaredError'});
+    const xs = tf.randomNormal([16, 2]);
+    const ys = xs.sum(1, true);
+    const history = await model.fit(xs, ys, {epochs: 20, verbose: 0});
+    const losses = history.history.loss as number[];
+    expect(losses[losses.length - 1]).toBeLessThan(losses[0]);
+  });
+
+  it('getWeights() and setWeights() restore the optimizer state', async () => {
+    const optimizer = tf.node.train.adam(0.1);
+    minimize(optimizer, 3);
+    const weights = await optimizer.getWeights();
+    expect(weights.length).toEqual(3);
+    expect(weights[0].name).toEqual('iter');
+    expect(weights[1].name).toMatch(/\/m$/);
+    expect(weights[2].name).toMatch(/\/v$/);
+
+    const restored = tf.node.train.adam(0.1);
+    await restored.setWeights(weights);
+    expect(restored.iterations).toEqual(3);
+    const restoredWeights = await restored.getWeights();
+    for (let i = 1; i < weights.length; ++i) {
+      expect(restoredWeights[i].name).toEqual(weights[i].name);
+      tf.test_util.expectArraysClose(
+          restoredWeights[i].tensor.dataSync(), weights[i].tensor.dataSync());
+    }
+    optimizer.dispose();
+    restored.dispose();
+  });
+});
@@ -0,0 +1,191 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {dispose, InferenceModel, Tensor, tensor, tidy, util} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+import {allocTensorBuffer, TensorBufferDataType} from './tensor_buffer';
+
+type TypedArray = Float32Array|Int32Array|Uint8Array;
+
+/** The shape and dtype of one model input. */
+export interface InputSpec {
+  /** The fully defined shape of the input, including the batch dimension. */
+  shape: number[];
+
+  /**
+   * The data type of the input.
+   *
+   * Default: `'float32'`.
+   */
+  dtype?: TensorBufferDataType;
+}
+
+/**
+ * Inference with a fixed set of input shapes and dtypes over reused buffers.
+ *
+ * Users are expected to access this class through the `prepareSignature()`
+ * factory method instead.
+ */
+export class PreparedSignature {
+  /**
+   * The input values, one typed array per model input. Write the inputs of
+   * the next `execute()` call into these arrays in place.
+   */
+  readonly inputs: TypedArray[];
+
+  /**
+   * The output values, one typed array per model output. Every `execute()`
+   * call overwrites them in place.
+   */
+  readonly outputs: TypedArray[];
+
+  /** The shapes of the model outputs, in the order of `outputs`. */
+  readonly outputShapes: number[][];
+
+  private readonly inputSpecs: InputSpec[];
+  // Input tensors that share the memory of `inputs`. Null when TensorFlow
+  // holds a copy of the values (e.g., on GPU), in which case the input tensors
+  // are created for every execution.
+  private inputTensors: Tensor[];
+  private disposed = false;
+
+  constructor(private readonly model: InferenceModel, inputSpecs: InputSpec[]) {
+    ensureTensorflowBackend();
+    util.assert(
+        inputSpecs.length > 0, () => 'Expected at least one input spec');
+    this.inputSpecs = inputSpecs.map(spec => {
+      for (const dim of spec.shape) {
+        util.assert(
+            Number.isInteger(dim) && dim >= 0,
+            () => `Expected a fully defined input shape, but got ` +
+                `[${spec.shape}]`);
+      }
+      return {shape: spec.shape, dtype: spec.dtype || 'float32'};
+    });
+    this.inputs =
+        this.inputSpecs.map(spec => allocTensorBuffer(spec.dtype, spec.shape));
+
+    this.inputTensors = this.createInputTensors();
+    const backend = nodeBackend();
+    const shared = this.inputTensors.every(t => backend.uploadTensor(t));
+    if (!shared) {
+      dispose(this.inputTensors);
+      this.inputTensors = null;
+    }
+
+    // Run the model once to find the output shapes and dtypes.
+    const outputs = this.predict();
+    util.assert(
+        outputs.every(t => t.dtype !== 'string'),
+        () => 'Models with string outputs are not supported');
+    this.outputShapes = outputs.map(t => t.shape);
+    this.outputs = outputs.map(
+        t => t.dtype === 'float32' ?
+            new Float32Array(t.size) :
+            t.dtype === 'int32' ? new Int32Array(t.size) :
+                                  new Uint8Array(t.size));
+    dispose(outputs);
+  }
+
+  /**
+   * Executes the model with the current values of `inputs` and copies the
+   * results into `outputs`.
+   *
+   * @returns `outputs`.
+   */
+  execute(): TypedArray[] {
+    util.assert(!this.disposed, () => 'PreparedSignature is disposed');
+    const outputs = this.predict();
+    try {
+      const backend = nodeBackend();
+      for (let i = 0; i < outputs.length; ++i) {
+        util.assert(
+            util.arraysEqual(outputs[i].shape, this.outputShapes[i]),
+            () => `Expected output ${i} to have shape ` +
+                `[${this.outputShapes[i]}], but got [${outputs[i].shape}]`);
+        backend.readInto(outputs[i].dataId, this.outputs[i]);
+      }
+    } finally {
+      dispose(outputs);
+    }
+    return this.outputs;
+  }
+
+  /** Releases the input tensors. */
+  dispose() {
+    if (this.inputTensors != null) {
+      dispose(this.inputTensors);
+      this.inputTensors = null;
+    }
+    this.disposed = true;
+  }
+
+  private createInputTensors(): Tensor[] {
+    return this.inputs.map(
+        (values, i) =>
+            tensor(values, this.inputSpecs[i].shape, this.inputSpecs[i].dtype));
+  }
+
+  private predict(): Tensor[] {
+    return tidy(() => {
+      const inputs = this.inputTensors != null ? this.inputTensors :
+                                                 this.createInputTensors();
+      const output = this.model.predict(
+          inputs.length === 1 ? inputs[0] : inputs, {}) as Tensor | Tensor[];
+      return Array.isArray(output) ? output : [output];
+    });
+  }
+}
+
+/**
+ * Prepare a model for inference with a fixed set of input shapes and dtypes.
+ *
+ * A `PreparedSignature` allocates the input and output buffers once. For
+ * every request, write the inputs into `signature.inputs` in place, call
+ * `execute()`, and read the results from `signature.outputs`, which are
+ * overwritten by the next call. No typed arrays are allocated per request,
+ * so memory use stays flat at high request rates.
+ *
+ * On CPU, the input tensors share the memory of `signature.inputs` and are
+ * created only once. The model is executed once when the signature is
+ * prepared, to determine the output shapes.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const model = await tf.loadLayersModel('file:///tmp/my-model/model.json');
+ * const signature = tf.node.prepareSignature(model, [{shape: [1, 784]}]);
+ *
+ * // In a request handler:
+ * signature.inputs[0].set(features);
+ * const [probabilities] = signature.execute();
+ * ```
+ *
+ * @param model The model to execute, e.g., a `tf.LayersModel` or a
+ *   `tf.GraphModel`.
+ * @param inputSpecs The shape and dtype of every model input.
+ * @returns An instance of `PreparedSignature`.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function prepareSignature(
+    model: InferenceModel, inputSpecs: InputSpec[]): PreparedSignature {
+  return new PreparedSignature(model, inputSpecs);
+}
@@ -0,0 +1,106 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+import {nodeBackend} from './ops/op_utils';
+
+describe('prepareSignature', () => {
+  let model: tf.Sequential;
+
+  beforeEach(() => {
+    model = tf.sequential();
+    model.add(tf.layers.dense({units: 2, inputShape: [3]}));
+  });
+
+  it('Executes with the values written to the inputs', () => {
+    const signature = tf.node.prepareSignature(model, [{shape: [2, 3]}]);
+    expect(signature.outputShapes).toEqual([[2, 2]]);
+
+    for (const values of [[1, 2, 3, 4, 5, 6], [-1, 0, 1, 2, 3, 4]]) {
+      signature.inputs[0].set(values);
+      const [output] = signature.execute();
+      const expected = model.predict(tf.tensor2d(values, [2, 3])) as tf.Tensor;
+      tf.test_util.expectArraysClose(output, expected.dataSync());
+    }
+    signature.dispose();
+  });
+
+  it('Reuses the output buffers', () => {
+    const signature = tf.node.prepareSignature(model, [{shape: [1, 3]}]);
+    const outputs = signature.outputs;
+    expect(signature.execute()).toBe(outputs);
+    expect(signature.execute()[0]).toBe(outputs[0]);
+    signature.dispose();
+  });
+
+  it('Does not leak tensors', () => {
+    const signature = tf.node.prepareSignature(model, [{shape: [4, 3]}]);
+    signature.execute();
+    const numTensors = tf.memory().numTensors;
+    for (let i = 0; i < 10; ++i) {
+      signature.execute();
+    }
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    signature.dispose();
+  });
+
+  it('Supports models with multiple inputs and outputs', () => {
+    const a = tf.input({shape: [2]});
+    const b = tf.input({shape: [2]});
+    const sum = tf.layers.add().apply([a, b]) as tf.SymbolicTensor;
+    const dense =
+        tf.layers.dense({units: 1, kernelInitializer: 'ones'}).apply(sum) as
+        tf.SymbolicTensor;
+    const multiModel = tf.model({inputs: [a, b], outputs: [sum, dense]});
+
+    const signature = tf.node.prepareSignature(
+        multiModel, [{shape: [1, 2]}, {shape: [1, 2]}]);
+    expect(signature.outputShapes).toEqual([[1, 2], [1, 1]]);
+    signature.inputs[0].set([1, 2]);
+    signature.inputs[1].set([3, 4]);
+    const [sumOutput, denseOutput] = signature.execute();
+    tf.test_util.expectArraysClose(sumOutput, [4, 6]);
+    tf.test_util.expectArraysClose(denseOutput, [10]);
+    signature.dispose();
+  });
+
+  it('Throws for shapes that are not fully defined', () => {
+    expect(() => tf.node.prepareSignature(model, [{shape: [-1, 3]}]))
+        .toThrowError(/fully defined/);
+  });
+
+  it('Throws after dispose()', () => {
+    const signature = tf.node.prepareSignature(model, [{shape: [1, 3]}]);
+    signature.dispose();
+    expect(() => signature.execute()).toThrowError(/disposed/);
+  });
+});
+
+describe('tensorDataInto', () => {
+  it('Copies tensor values into an existing typed array', () => {
+    const x = tf.tensor1d([1, 2, 3]).add(tf.scalar(1));
+    const target = new Float32Array(3);
+    nodeBackend().readInto(x.dataId, target);
+    expect(target).toEqual(new Float32Array([2, 3, 4]));
+  });
+
+  it('Throws for a mismatched length', () => {
+    const x = tf.tensor1d([1, 2, 3]).add(tf.scalar(1));
+    expect(() => nodeBackend().readInto(x.dataId, new Float32Array(2)))
+        .toThrowError(/byte length/);
+  });
+});
@@ -0,0 +1,313 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {add, dispose, keep, layers, max, min, Scalar, scalar, Sequential, Tensor, Tensor2D, Tensor4D, tidy, util} from '@tensorflow/tfjs';
+import {computeConv2DInfo} from '@tensorflow/tfjs-core/dist/ops/conv_util';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+export interface QuantizeModelArgs {
+  /**
+   * Representative model inputs. When provided, the input range of every
+   * quantized layer is fixed to the range observed on this data. Otherwise
+   * the range is computed from every batch at inference time, which costs
+   * an extra reduction per quantized layer.
+   */
+  calibrationData?: Tensor|Tensor[];
+}
+
+/** The quint8 values of a tensor and the float range they represent. */
+interface QuantizedTensor {
+  values: Tensor;
+  min: Scalar;
+  max: Scalar;
+}
+
+/** A Dense or Conv2D layer whose kernel is stored as quint8. */
+interface QuantizedLayer {
+  kind: 'dense'|'conv2d';
+  kernel: QuantizedTensor;
+  bias: Tensor|null;
+  activation: layers.Layer|null;
+  strides: [number, number];
+  padding: 'valid'|'same';
+  // Calibrated input range. `null` before calibration.
+  inputMin: Scalar|null;
+  inputMax: Scalar|null;
+}
+
+/** One step of the model: a quantized layer or an original float layer. */
+interface Stage {
+  layer: layers.Layer;
+  quantized: QuantizedLayer|null;
+}
+
+/**
+ * Runs a `tf.Sequential` model with the Dense and Conv2D layers executed by
+ * TensorFlow's quantized kernels.
+ *
+ * The model is taken over: the float kernels of the quantized layers are
+ * released once they are quantized, and `dispose()` releases the remaining
+ * weights (biases and the weights of the other layers).
+ *
+ * Users are expected to access this class through the `quantizeModel()`
+ * factory method instead.
+ */
+export class QuantizedModel {
+  private readonly stages: Stage[] = [];
+
+  constructor(model: Sequential) {
+    ensureTensorflowBackend();
+    util.assert(
+        model instanceof Sequential,
+        () => 'quantizeModel() supports only tf.Sequential models');
+    for (const layer of model.layers) {
+      this.stages.push({layer, quantized: quantizeLayer(layer)});
+    }
+  }
+
+  /** The number of quantized layers. */
+  get numQuantizedLayers(): number {
+    return this.stages.filter(stage => stage.quantized != null).length;
+  }
+
+  /** The size in bytes of the quint8 kernels. */
+  get quantizedWeightBytes(): number {
+    return this.stages.filter(stage => stage.quantized != null)
+        .reduce((sum, stage) => sum + stage.quantized.kernel.values.size, 0);
+  }
+
+  /**
+   * Runs inference on `x`. Layers that are not quantized are executed with
+   * the float weights of the original model.
+   */
+  predict(x: Tensor): Tensor {
+    return tidy(() => {
+      let output = x;
+      for (const stage of this.stages) {
+        output = stage.quantized == null ?
+            stage.layer.apply(output) as Tensor :
+            applyQuantized(stage.quantized, output);
+      }
+      return output;
+    });
+  }
+
+  /**
+   * Records the input range of every quantized layer on representative
+   * data. The ranges of successive calls are merged. Each layer sees the
+   * outputs of the quantized layers before it, as in `predict()`.
+   */
+  calibrate(data: Tensor|Tensor[]) {
+    const batches = Array.isArray(data) ? data : [data];
+    for (const batch of batches) {
+      tidy(() => {
+        let output = batch;
+        for (const stage of this.stages) {
+          if (stage.quantized == null) {
+            output = stage.layer.apply(output) as Tensor;
+          } else {
+            updateInputRange(stage.quantized, output);
+            output = applyQuantized(stage.quantized, output);
+          }
+        }
+      });
+    }
+  }
+
+  /**
+   * Releases the quantized weights and the remaining float weights of the
+   * original model, which can't be used afterwards.
+   */
+  dispose() {
+    for (const stage of this.stages) {
+      const quantized = stage.quantized;
+      // The kernel of a quantized layer was released by `quantizeLayer()`.
+      stage.layer.weights.forEach((weight, i) => {
+        if (quantized == null || i !== 0) {
+          weight.dispose();
+        }
+      });
+      if (quantized != null) {
+        dispose([
+          quantized.kernel.values, quantized.kernel.min, quantized.kernel.max
+        ]);
+        dispose([quantized.inputMin, quantized.inputMax].filter(
+            range => range != null));
+      }
+    }
+  }
+}
+
+/** Returns the range of `x` as float scalars, with 0 included. */
+function rangeOf(x: Tensor): [Scalar, Scalar] {
+  return [min(x).minimum(0) as Scalar, max(x).maximum(0) as Scalar];
+}
+
+function quantize(x: Tensor, range: [Scalar, Scalar]): QuantizedTensor {
+  const [values, minValue, maxValue] =
+      nodeBackend().quantizeV2(x, range[0], range[1]);
+  return {values, min: minValue, max: maxValue};
+}
+
+function toPair(value: number|number[]): [number, number] {
+  return Array.isArray(value) ? [value[0], value[1]] : [value, value];
+}
+
+/**
+ * Quantizes the kernel of a Dense or a Conv2D layer and releases the float
+ * kernel. Returns `null` for other layers and for configurations the
+ * quantized kernels do not support.
+ */
+function quantizeLayer(layer: layers.Layer): QuantizedLayer|null {
+  const className = layer.getClassName();
+  const config = layer.getConfig();
+  if (className === 'Conv2D') {
+    const dilations = toPair(config.dilationRate as number | number[]);
+    if (config.dataFormat !== 'channelsLast' || dilations[0] !== 1 ||
+        dilations[1] !== 1 || config.padding === 'causal') {
+      return null;
+    }
+  } else if (className !== 'Dense') {
+    return null;
+  }
+
+  const weights = layer.getWeights();
+  const kernelRange = tidy(() => rangeOf(weights[0]));
+  const kernel = quantize(weights[0], kernelRange);
+  dispose(kernelRange);
+  // Only the quint8 kernel is kept, so that the weights take about a quarter
+  // of the memory of the float model. The bias stays float.
+  layer.weights[0].dispose();
+  const activationName = config.activation as string;
+  return {
+    kind: className === 'Dense' ? 'dense' : 'conv2d',
+    kernel,
+    bias: config.useBias ? weights[1] : null,
+    activation: activationName == null || activationName === 'linear' ?
+        null :
+        // tslint:disable-next-line:no-any
+        layers.activation({activation: activationName as any}),
+    strides: className === 'Dense' ?
+        [1, 1] :
+        toPair(config.strides as number | number[]),
+    padding: config.padding as 'valid' | 'same',
+    inputMin: null,
+    inputMax: null
+  };
+}
+
+function applyQuantized(layer: QuantizedLayer, x: Tensor): Tensor {
+  const backend = nodeBackend();
+  const inputRange: [Scalar, Scalar] = layer.inputMin == null ?
+      rangeOf(x) :
+      [layer.inputMin, layer.inputMax];
+  const kernel = layer.kernel;
+
+  let output: Tensor;
+  if (layer.kind === 'dense') {
+    // Dense layers apply the kernel to the last axis of inputs of any rank.
+    const inputDim = x.shape[x.rank - 1];
+    const input = quantize(x.reshape([-1, inputDim]), inputRange);
+    const [acc, minAcc, maxAcc] = backend.quantizedMatMul(
+        input.values as Tensor2D, kernel.values as Tensor2D, input.min,
+        input.max, kernel.min, kernel.max);
+    const units = kernel.values.shape[1];
+    output = backend
+                 .dequantize(acc, minAcc, maxAcc, backend.binding.TF_QINT32)
+                 .reshape(x.shape.slice(0, -1).concat([units]));
+  } else {
+    const convInfo = computeConv2DInfo(
+        x.shape as [number, number, number, number],
+        kernel.values.shape as [number, number, number, number],
+        layer.strides, 1, layer.padding);
+    const input = quantize(x, inputRange);
+    const [acc, minAcc, maxAcc] = backend.quantizedConv2D(
+        input.values as Tensor4D, kernel.values as Tensor4D, input.min,
+        input.max, kernel.min, kernel.max, convInfo);
+    output =
+        backend.dequantize(acc, minAcc, maxAcc, backend.binding.TF_QINT32);
+  }
+
+  if (layer.bias != null) {
+    output = add(output, layer.bias);
+  }
+  if (layer.activation != null) {
+    output = layer.activation.apply(output) as Tensor;
+  }
+  return output;
+}
+
+function updateInputRange(layer: QuantizedLayer, x: Tensor) {
+  let [minValue, maxValue] = rangeOf(x);
+  if (layer.inputMin != null) {
+    minValue = minValue.minimum(layer.inputMin);
+    maxValue = maxValue.maximum(layer.inputMax);
+    layer.inputMin.dispose();
+    layer.inputMax.dispose();
+  }
+  // Calibrated ranges are plain values, so they do not depend on `x`.
+  layer.inputMin = keep(scalar(minValue.dataSync()[0]));
+  layer.inputMax = keep(scalar(maxValue.dataSync()[0]));
+}
+
+/**
+ * Quantize a `tf.Sequential` model for int8 inference.
+ *
+ * The kernels of Dense and Conv2D layers are quantized to 8 bits, and these
+ * layers are executed with TensorFlow's `QuantizedMatMul` and
+ * `QuantizedConv2D` kernels, which are typically faster than their float
+ * counterparts on CPU and use a quarter of the memory bandwidth. Inputs of
+ * the quantized layers are quantized on the fly, and results are dequantized
+ * before the bias and activation are applied in float. Other layers run with
+ * the float weights of the original model.
+ *
+ * The original model is taken over by the quantized model: the float kernels
+ * of the quantized layers are released, so that the model takes about a
+ * quarter of the memory for these weights. Don't use or dispose the original
+ * model afterwards; `QuantizedModel.dispose()` releases its remaining
+ * weights.
+ *
+ * Quantization changes the results slightly. Passing representative
+ * `calibrationData` fixes the input ranges and avoids computing them for
+ * every batch.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const model = await tf.loadLayersModel('file:///tmp/my-model/model.json');
+ * const quantized =
+ *     tf.node.quantizeModel(model, {calibrationData: sampleInputs});
+ * const output = quantized.predict(inputs);
+ * ```
+ *
+ * @param model The `tf.Sequential` model to quantize.
+ * @param args Optional configuration arguments.
+ * @returns An instance of `QuantizedModel`.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function quantizeModel(
+    model: Sequential, args?: QuantizeModelArgs): QuantizedModel {
+  const quantizedModel = new QuantizedModel(model);
+  if (args != null && args.calibrationData != null) {
+    quantizedModel.calibrate(args.calibrationData);
+  }
+  return quantizedModel;
+}
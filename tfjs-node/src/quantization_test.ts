@@ -0,0 +1,137 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+import {nodeBackend} from './ops/op_utils';
+
+describe('quantizeModel', () => {
+  it('Dense layers match the float model approximately', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense(
+        {units: 8, inputShape: [4], activation: 'relu'}));
+    model.add(tf.layers.dense({units: 3}));
+    const x = tf.randomUniform([5, 4], -1, 1);
+    const expected = model.predict(x) as tf.Tensor;
+    const quantized = tf.node.quantizeModel(model);
+    expect(quantized.numQuantizedLayers).toEqual(2);
+    expect(quantized.quantizedWeightBytes).toEqual(4 * 8 + 8 * 3);
+
+    const y = quantized.predict(x);
+    expect(y.shape).toEqual([5, 3]);
+    expect(y.dtype).toEqual('float32');
+    tf.test_util.expectArraysClose(y.dataSync(), expected.dataSync(), 0.05);
+    quantized.dispose();
+  });
+
+  it('Conv2D layers match the float model approximately', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.conv2d({
+      filters: 4,
+      kernelSize: 3,
+      strides: 2,
+      padding: 'same',
+      activation: 'relu',
+      inputShape: [8, 8, 2]
+    }));
+    model.add(tf.layers.flatten());
+    model.add(tf.layers.dense({units: 2}));
+    const x = tf.randomUniform([2, 8, 8, 2], 0, 1);
+    const expected = model.predict(x) as tf.Tensor;
+    const quantized = tf.node.quantizeModel(model);
+    expect(quantized.numQuantizedLayers).toEqual(2);
+
+    const y = quantized.predict(x);
+    expect(y.shape).toEqual([2, 2]);
+    tf.test_util.expectArraysClose(y.dataSync(), expected.dataSync(), 0.05);
+    quantized.dispose();
+  });
+
+  it('Calibrated ranges are used for inference', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 4, inputShape: [4]}));
+    const calibrationData = tf.randomUniform([16, 4], -1, 1);
+    const x = tf.randomUniform([3, 4], -1, 1);
+    const expected = model.predict(x) as tf.Tensor;
+    // Values outside the calibrated range are clipped.
+    const outside = tf.fill([1, 4], 10);
+    const expectedClipped = model.predict(tf.fill([1, 4], 1)) as tf.Tensor;
+    const quantized = tf.node.quantizeModel(model, {calibrationData});
+
+    tf.test_util.expectArraysClose(
+        quantized.predict(x).dataSync(), expected.dataSync(), 0.05);
+    tf.test_util.expectArraysClose(
+        quantized.predict(outside).dataSync(), expectedClipped.dataSync(),
+        0.05);
+    quantized.dispose();
+  });
+
+  it('Quantized layers do not leak tensors', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 4, inputShape: [4]}));
+    const quantized = tf.node.quantizeModel(model);
+    const x = tf.ones([2, 4]);
+    quantized.predict(x).dispose();
+
+    const numTensors = tf.memory().numTensors;
+    quantized.predict(x).dispose();
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    quantized.dispose();
+  });
+
+  it('Releases the float kernels of quantized layers', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 64, inputShape: [64]}));
+    const floatKernelBytes = 64 * 64 * 4;
+    const backend = nodeBackend();
+    const numBytesBefore = backend.memory().numNativeBytes;
+    const quantized = tf.node.quantizeModel(model);
+    // The quint8 kernel takes a quarter of the float kernel.
+    expect(numBytesBefore - backend.memory().numNativeBytes)
+        .toBeGreaterThanOrEqual(floatKernelBytes * 3 / 4 - 8);
+
+    const numTensors = tf.memory().numTensors;
+    quantized.dispose();
+    // The quint8 kernel with its range, and the float bias.
+    expect(numTensors - tf.memory().numTensors).toEqual(4);
+  });
+
+  it('Throws for models that are not sequential', () => {
+    const input = tf.input({shape: [4]});
+    const output =
+        tf.layers.dense({units: 2}).apply(input) as tf.SymbolicTensor;
+    const model = tf.model({inputs: input, outputs: output});
+    expect(() => tf.node.quantizeModel(model as tf.Sequential))
+        .toThrowError(/tf.Sequential/);
+  });
+});
+
+describe('quantized kernels', () => {
+  it('QuantizeV2 and Dequantize round trip', async () => {
+    const backend = nodeBackend();
+    const x = tf.tensor1d([-1, -0.5, 0, 0.25, 1]);
+    const [q, minValue, maxValue] =
+        backend.quantizeV2(x, tf.scalar(-1), tf.scalar(1));
+    expect(q.dtype).toEqual('int32');
+    const values = await q.data();
+    expect(values[0]).toEqual(0);
+    expect(values[4]).toEqual(255);
+    const dequantized =
+        backend.dequantize(q, minValue, maxValue, backend.binding.TF_QUINT8);
+    tf.test_util.expectArraysClose(
+        await dequantized.data(), await x.data(), 0.01);
+  });
+});
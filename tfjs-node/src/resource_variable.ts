@@ -0,0 +1,217 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {DataType, LayersModel, Rank, Tensor, tidy, util, Variable, variable} from '@tensorflow/tfjs';
+import {ENGINE} from '@tensorflow/tfjs-core/dist/engine';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/**
+ * A `tf.Variable` whose value lives in a TensorFlow resource variable
+ * (`VarHandleOp`).
+ *
+ * `assign()` writes the new value into the existing resource variable with
+ * `AssignVariableOp` and keeps the data ID of the variable, so no tensor is
+ * registered or disposed. The native optimizers in `tf.node.train` update
+ * resource variables in place.
+ *
+ * Users are expected to create instances through the `resourceVariable()`
+ * factory method instead. tfjs-core registers variables in its `variable()`
+ * factory rather than in the `Variable` constructor, so `create()` makes a
+ * registered `tf.Variable` and turns it into a `ResourceVariable`.
+ */
+export class ResourceVariable<R extends Rank = Rank> extends Variable<R> {
+  /** The resource-type tensor of the TensorFlow variable. */
+  handle: Tensor;
+
+  static create<R extends Rank>(
+      initialValue: Tensor<R>, trainable = true,
+      name?: string): ResourceVariable<R> {
+    ensureTensorflowBackend();
+    const backend = nodeBackend();
+    const handle = backend.varHandleOp(initialValue.dtype, initialValue.shape);
+    let result: ResourceVariable<R>;
+    try {
+      backend.assignVariable(handle, initialValue);
+      // The variable gets a data ID of its own, which shares the buffer of
+      // the TensorFlow variable. The engine holds a reference to it, so it
+      // outlives `value`.
+      const value =
+          backend.readVariable(handle, initialValue.dtype) as Tensor<R>;
+      try {
+        result = variable(value, trainable, name) as ResourceVariable<R>;
+      } finally {
+        value.dispose();
+      }
+    } catch (e) {
+      backend.destroyResource(handle);
+      handle.dispose();
+      throw e;
+    }
+    Object.setPrototypeOf(result, ResourceVariable.prototype);
+    result.handle = handle;
+    return result;
+  }
+
+  /**
+   * Assigns a new value to the variable. The shape and dtype of the variable
+   * cannot change.
+   */
+  assign(newValue: Tensor<R>): void {
+    util.assert(
+        newValue.dtype === this.dtype,
+        () => `dtype of the new value (${newValue.dtype}) and ` +
+            `previous value (${this.dtype}) must match`);
+    util.assert(
+        util.arraysEqual(newValue.shape, this.shape),
+        () => `shape of the new value (${newValue.shape}) and ` +
+            `previous value (${this.shape}) must match`);
+    this.update(handle => nodeBackend().assignVariable(handle, newValue));
+  }
+
+  /**
+   * Runs `apply`, which modifies the TensorFlow variable in place, and makes
+   * the new value visible through this variable.
+   *
+   * TensorFlow copies a variable's buffer before an in-place update while
+   * other tensors share it. The tensor of this variable is released during
+   * the update to avoid that copy. When other tfjs tensors share the data ID
+   * of this variable (e.g., from `clone()`), the variable switches to a new
+   * data ID instead, so those tensors keep the old value.
+   */
+  update(apply: (handle: Tensor) => void): void {
+    const backend = nodeBackend();
+    if (this.isDataShared()) {
+      apply(this.handle);
+      tidy(() => {
+        super.assign(backend.readVariable(this.handle, this.dtype) as
+                     Tensor<R>);
+      });
+      return;
+    }
+    backend.releaseNativeData(this.dataId);
+    try {
+      apply(this.handle);
+    } finally {
+      backend.readVariableInto(this.dataId, this.handle, this.dtype);
+    }
+  }
+
+  dispose(): void {
+    if (this.isDisposed) {
+      return;
+    }
+    nodeBackend().destroyResource(this.handle);
+    this.handle.dispose();
+    super.dispose();
+  }
+
+  private isDataShared(): boolean {
+    // tslint:disable-next-line:no-any
+    const tensorInfo = (ENGINE as any).state.tensorInfo.get(this.dataId);
+    return tensorInfo != null && tensorInfo.refCount > 1;
+  }
+}
+
+/**
+ * Create a `tf.Variable` that is backed by a TensorFlow resource variable.
+ *
+ * Assigning to a resource variable writes the new value into the existing
+ * TensorFlow buffer, instead of registering a new tensor and disposing the
+ * old one, so weight memory stays fixed during training. The native
+ * optimizers in `tf.node.train` update resource variables in place.
+ *
+ * ```js
+ * const x = tf.node.resourceVariable(tf.tensor([1, 2, 3]));
+ * x.assign(tf.tensor([4, 5, 6]));
+ * ```
+ *
+ * @param initialValue Initial value for the variable.
+ * @param trainable If true, optimizers are allowed to update it.
+ * @param name Name of the variable. Defaults to a unique id.
+ * @param dtype If set, initialValue will be converted to the given type.
+ */
+/**
+ * @doc {heading: 'Tensors', subheading: 'Creation', namespace: 'node'}
+ */
+export function resourceVariable<R extends Rank>(
+    initialValue: Tensor<R>, trainable = true, name?: string,
+    dtype?: DataType): ResourceVariable<R> {
+  if (dtype == null || dtype === initialValue.dtype) {
+    return ResourceVariable.create(initialValue, trainable, name);
+  }
+  // The variable copies its initial value, so the cast one is not needed.
+  const castValue = initialValue.asType(dtype);
+  try {
+    return ResourceVariable.create(castValue, trainable, name);
+  } finally {
+    castValue.dispose();
+  }
+}
+
+/**
+ * Replace the weights of a model with resource variables.
+ *
+ * Every weight of `model` is replaced by a `ResourceVariable` with the same
+ * name and value, so that training updates the weights in place, e.g., with
+ * the native optimizers in `tf.node.train`:
+ *
+ * ```js
+ * tf.node.useResourceVariables(model);
+ * model.compile({optimizer: tf.node.train.adam(), loss: 'meanSquaredError'});
+ * await model.fit(xs, ys);
+ * ```
+ *
+ * @param model The model whose weights to replace. Weights are replaced
+ *   in place; tensors previously returned by `getWeights()` are disposed.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export function useResourceVariables(model: LayersModel): void {
+  for (const weight of model.weights) {
+    // `LayerVariable` keeps its `tf.Variable` in a private field.
+    // tslint:disable-next-line:no-any
+    const layerVariable = weight as any;
+    const variable = layerVariable.val as Variable;
+    if (variable instanceof ResourceVariable) {
+      continue;
+    }
+    // Variable names are unique, so the resource variable is created under a
+    // generated name and takes over the name once the old variable is gone.
+    // If `create()` throws, the layer keeps its old variable.
+    const value = variable.clone();
+    let newVariable: ResourceVariable;
+    try {
+      newVariable = ResourceVariable.create(value, variable.trainable);
+    } finally {
+      value.dispose();
+    }
+    variable.dispose();
+    renameVariable(newVariable, variable.name);
+    layerVariable.val = newVariable;
+  }
+}
+
+// Registers `variable` with the engine under `name` instead of its own name.
+function renameVariable(variable: Variable, name: string) {
+  delete ENGINE.registeredVariables[variable.name];
+  // `name` is read-only in the `Variable` typings.
+  // tslint:disable-next-line:no-any
+  (variable as any).name = name;
+  ENGINE.registeredVariables[name] = variable;
+}
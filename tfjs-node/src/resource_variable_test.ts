@@ -0,0 +1,159 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+import {ResourceVariable} from './resource_variable';
+
+describe('resourceVariable', () => {
+  it('Holds the initial value', () => {
+    const x = tf.node.resourceVariable(tf.tensor2d([[1, 2], [3, 4]]));
+    expect(x instanceof tf.Variable).toBe(true);
+    expect(x.shape).toEqual([2, 2]);
+    tf.test_util.expectArraysClose(x.dataSync(), [1, 2, 3, 4]);
+    x.dispose();
+  });
+
+  it('Is registered with the engine and outlives its initial value', () => {
+    const initialValue = tf.tensor1d([1, 2, 3]);
+    const x = tf.node.resourceVariable(initialValue, true, 'registeredVar');
+    initialValue.dispose();
+
+    expect(x instanceof ResourceVariable).toBe(true);
+    expect(x.name).toEqual('registeredVar');
+    expect(tf.engine().registeredVariables[x.name]).toBe(x);
+    tf.test_util.expectArraysClose(x.dataSync(), [1, 2, 3]);
+    x.dispose();
+    expect(tf.engine().registeredVariables[x.name]).toBeUndefined();
+  });
+
+  it('Does not keep the cast initial value', () => {
+    const initialValue = tf.tensor1d([1, 2, 3], 'int32');
+    const numTensors = tf.memory().numTensors;
+    const x = tf.node.resourceVariable(initialValue, true, null, 'float32');
+    // The variable and its handle.
+    expect(tf.memory().numTensors).toEqual(numTensors + 2);
+    expect(x.dtype).toEqual('float32');
+    tf.test_util.expectArraysClose(x.dataSync(), [1, 2, 3]);
+    x.dispose();
+    initialValue.dispose();
+  });
+
+  it('assign() keeps the data ID and the tensor count', () => {
+    const x = tf.node.resourceVariable(tf.tensor1d([1, 2, 3]));
+    const dataId = x.dataId;
+    const numTensors = tf.memory().numTensors;
+    const newValue = tf.tensor1d([4, 5, 6]);
+    x.assign(newValue);
+    newValue.dispose();
+
+    expect(x.dataId).toBe(dataId);
+    expect(tf.memory().numTensors).toEqual(numTensors);
+    tf.test_util.expectArraysClose(x.dataSync(), [4, 5, 6]);
+    x.dispose();
+  });
+
+  it('Does not change the initial value or clones', () => {
+    const initialValue = tf.tensor1d([1, 2]);
+    const x = tf.node.resourceVariable(initialValue);
+    const clone = x.clone();
+    x.assign(tf.tensor1d([3, 4]));
+
+    tf.test_util.expectArraysClose(initialValue.dataSync(), [1, 2]);
+    tf.test_util.expectArraysClose(clone.dataSync(), [1, 2]);
+    tf.test_util.expectArraysClose(x.dataSync(), [3, 4]);
+    x.dispose();
+  });
+
+  it('Can be used in ops and gradients', () => {
+    const x = tf.node.resourceVariable(tf.tensor1d([1, 2, 3]));
+    const grad = tf.grad(v => v.square().sum())(x);
+    tf.test_util.expectArraysClose(grad.dataSync(), [2, 4, 6]);
+    tf.test_util.expectArraysClose(x.add(x).dataSync(), [2, 4, 6]);
+    x.dispose();
+  });
+
+  it('assign() validates the shape and dtype', () => {
+    const x = tf.node.resourceVariable(tf.tensor1d([1, 2]));
+    expect(() => x.assign(tf.tensor1d([1, 2, 3])))
+        .toThrowError(/shape of the new value/);
+    expect(() => x.assign(tf.tensor1d([1, 2], 'int32')))
+        .toThrowError(/dtype of the new value/);
+    x.dispose();
+  });
+
+  it('Native optimizers update it in place', () => {
+    const x = tf.node.resourceVariable(tf.tensor1d([1, -2]));
+    const dataId = x.dataId;
+    const optimizer = tf.node.train.sgd(0.25);
+    optimizer.minimize(() => x.square().sum() as tf.Scalar);
+    // x -= 0.25 * 2x
+    expect(x.dataId).toBe(dataId);
+    tf.test_util.expectArraysClose(x.dataSync(), [0.5, -1]);
+    optimizer.dispose();
+    x.dispose();
+  });
+});
+
+describe('useResourceVariables', () => {
+  it('Replaces the weights and keeps their values', async () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 2, inputShape: [3]}));
+    const x = tf.ones([1, 3]);
+    const before = (model.predict(x) as tf.Tensor).dataSync();
+
+    tf.node.useResourceVariables(model);
+    for (const weight of model.weights) {
+      expect(weight.read() instanceof ResourceVariable).toBe(true);
+    }
+    tf.test_util.expectArraysClose(
+        (model.predict(x) as tf.Tensor).dataSync(), before);
+
+    model.compile(
+        {optimizer: tf.node.train.adam(0.05), loss: 'meanSquaredError'});
+    const history = await model.fit(
+        tf.randomNormal([8, 3]), tf.randomNormal([8, 2]),
+        {epochs: 5, verbose: 0});
+    expect(history.history.loss.length).toEqual(5);
+  });
+
+  it('Keeps the names of the weights', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 2, inputShape: [3]}));
+    const names = model.weights.map(weight => weight.read().name);
+
+    tf.node.useResourceVariables(model);
+    model.weights.forEach((weight, i) => {
+      const variable = weight.read();
+      expect(variable.name).toEqual(names[i]);
+      expect(tf.engine().registeredVariables[names[i]]).toBe(variable);
+    });
+  });
+
+  it('Keeps the old weights if a resource variable cannot be created', () => {
+    const model = tf.sequential();
+    model.add(tf.layers.dense({units: 2, inputShape: [3]}));
+    const kernel = model.weights[0].read();
+    const numTensors = tf.memory().numTensors;
+    spyOn(ResourceVariable, 'create').and.throwError('create failed');
+
+    expect(() => tf.node.useResourceVariables(model))
+        .toThrowError(/create failed/);
+    expect(model.weights[0].read()).toBe(kernel);
+    expect(kernel.isDisposed).toBe(false);
+    expect(tf.memory().numTensors).toEqual(numTensors);
+  });
+});
@@ -0,0 +1,250 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {div, gather, greater, mul, scatterND, sqrt, square, Tensor, Tensor1D, tensor1d, Tensor2D, tensor2d, tidy, unsortedSegmentSum, util, where, zerosLike} from '@tensorflow/tfjs-core';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/**
+ * A tensor that stores only its non-zero values, like `tf.SparseTensor` in
+ * TensorFlow Python.
+ *
+ * Users are expected to create instances through the `sparse.tensor()` or
+ * `sparse.fromRaggedIds()` factory methods instead.
+ */
+export class SparseTensor {
+  /**
+   * @param indices An int32 tensor of shape `[nnz, rank]` with the indices of
+   *   the non-zero values, in row-major order.
+   * @param values A tensor of shape `[nnz]` with the non-zero values.
+   * @param denseShape The shape of the dense tensor.
+   */
+  constructor(
+      readonly indices: Tensor2D, readonly values: Tensor1D,
+      readonly denseShape: number[]) {
+    ensureTensorflowBackend();
+    util.assert(
+        indices.dtype === 'int32',
+        () => `Expected int32 indices, but got ${indices.dtype}`);
+    util.assert(
+        indices.rank === 2 && indices.shape[1] === denseShape.length,
+        () => `Expected indices of shape [nnz, ${denseShape.length}], but ` +
+            `got [${indices.shape}]`);
+    util.assert(
+        values.rank === 1 && values.shape[0] === indices.shape[0],
+        () => `Expected values of shape [${indices.shape[0]}], but got ` +
+            `[${values.shape}]`);
+  }
+
+  /** The rank of the dense tensor. */
+  get rank(): number {
+    return this.denseShape.length;
+  }
+
+  /** The number of stored values. */
+  get nnz(): number {
+    return this.values.shape[0];
+  }
+
+  get dtype() {
+    return this.values.dtype;
+  }
+
+  /** Returns the dense tensor. */
+  toDense(): Tensor {
+    return scatterND(this.indices, this.values, this.denseShape);
+  }
+
+  dispose() {
+    this.indices.dispose();
+    this.values.dispose();
+  }
+}
+
+/**
+ * Create a `SparseTensor` from the indices and values of its non-zero
+ * elements.
+ *
+ * @param indices The indices of the non-zero values as an int32 tensor or an
+ *   array of shape `[nnz, rank]`, in row-major order.
+ * @param values The non-zero values.
+ * @param denseShape The shape of the dense tensor.
+ */
+function sparseTensor(
+    indices: Tensor2D|number[][], values: Tensor1D|number[],
+    denseShape: number[]): SparseTensor {
+  const indicesTensor = indices instanceof Tensor ?
+      indices :
+      tensor2d(indices, [indices.length, denseShape.length], 'int32');
+  const valuesTensor = values instanceof Tensor ? values : tensor1d(values);
+  return new SparseTensor(indicesTensor, valuesTensor, denseShape);
+}
+
+/**
+ * Create a 2D int32 `SparseTensor` of IDs, e.g., the multi-hot feature IDs of
+ * a batch of examples. Row `i` holds `ids[i]`, so the dense shape is
+ * `[ids.length, maxLength]`.
+ *
+ * @param ids The IDs of every example.
+ */
+function fromRaggedIds(ids: number[][]): SparseTensor {
+  const indices: number[] = [];
+  const values: number[] = [];
+  let maxLength = 0;
+  ids.forEach((row, i) => {
+    row.forEach((id, j) => {
+      indices.push(i, j);
+      values.push(id);
+    });
+    maxLength = Math.max(maxLength, row.length);
+  });
+  return new SparseTensor(
+      tensor2d(indices, [values.length, 2], 'int32'),
+      tensor1d(values, 'int32'), [ids.length, maxLength]);
+}
+
+/**
+ * Multiply a 2D `SparseTensor` by a dense matrix with TensorFlow's
+ * `SparseTensorDenseMatMul` kernel. The cost scales with the number of
+ * non-zero values of `a`.
+ *
+ * @param a The sparse left-hand matrix.
+ * @param b The dense right-hand matrix.
+ * @param transposeA Whether `a` is transposed before the multiplication.
+ * @param transposeB Whether `b` is transposed before the multiplication.
+ */
+function matMul(
+    a: SparseTensor, b: Tensor2D, transposeA = false,
+    transposeB = false): Tensor2D {
+  util.assert(
+      a.rank === 2, () => `Expected a 2D SparseTensor, but got rank ${a.rank}`);
+  return nodeBackend().sparseTensorDenseMatMul(
+      a.indices, a.values, a.denseShape, b, transposeA, transposeB);
+}
+
+/**
+ * Sum the rows `data[indices[i]]` that have the same (sorted) segment ID.
+ *
+ * @param data The tensor to gather rows from.
+ * @param indices int32 row indices into `data`.
+ * @param segmentIds Sorted int32 segment IDs, one per index.
+ * @param numSegments The number of output rows. Default: the last segment ID
+ *   plus one.
+ */
+function segmentSum(
+    data: Tensor, indices: Tensor1D, segmentIds: Tensor1D,
+    numSegments?: number): Tensor {
+  return nodeBackend().sparseSegmentReduction(
+      'Sum', data, indices, segmentIds, numSegments);
+}
+
+/** Like `segmentSum()`, but averages the rows of every segment. */
+function segmentMean(
+    data: Tensor, indices: Tensor1D, segmentIds: Tensor1D,
+    numSegments?: number): Tensor {
+  return nodeBackend().sparseSegmentReduction(
+      'Mean', data, indices, segmentIds, numSegments);
+}
+
+/**
+ * Like `segmentSum()`, but divides the sum of every segment by the square
+ * root of its size.
+ */
+function segmentSqrtN(
+    data: Tensor, indices: Tensor1D, segmentIds: Tensor1D,
+    numSegments?: number): Tensor {
+  return nodeBackend().sparseSegmentReduction(
+      'SqrtN', data, indices, segmentIds, numSegments);
+}
+
+/**
+ * Look up and combine the embeddings of sparse IDs, like
+ * `tf.nn.embedding_lookup_sparse` in TensorFlow Python.
+ *
+ * Row `i` of the result combines the embeddings `params[id]` of the IDs in
+ * row `i` of `ids`. Without `weights`, the lookup and the reduction run in a
+ * single `SparseSegment*WithNumSegments` kernel, so neither a dense
+ * multi-hot matrix nor the gathered embeddings are materialized. Rows
+ * without IDs are zero.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const params = tf.randomNormal([100000, 16]);
+ * const ids = tf.node.sparse.fromRaggedIds([[3, 17, 42], [5], []]);
+ * const embeddings = tf.node.sparse.embeddingLookup(params, ids);  // [3, 16]
+ * ```
+ *
+ * @param params The embedding matrix of shape `[vocabularySize, dim]`.
+ * @param ids A 2D `SparseTensor` of int32 IDs of shape `[batch, maxIds]`.
+ * @param weights An optional `SparseTensor` with a weight for every ID, with
+ *   the same indices as `ids`.
+ * @param combiner How the embeddings of a row are combined: `'sum'`,
+ *   `'mean'` (the weighted mean) or `'sqrtn'` (the weighted sum divided by
+ *   the square root of the sum of the squared weights). Default: `'mean'`.
+ */
+function embeddingLookup(
+    params: Tensor2D, ids: SparseTensor, weights?: SparseTensor,
+    combiner: 'sum'|'mean'|'sqrtn' = 'mean'): Tensor2D {
+  util.assert(
+      ids.rank === 2,
+      () => `Expected 2D SparseTensor ids, but got rank ${ids.rank}`);
+  const numRows = ids.denseShape[0];
+  return tidy(() => {
+    const segmentIds = ids.indices.slice([0, 0], [ids.nnz, 1]).as1D();
+    if (weights == null) {
+      const reduction =
+          combiner === 'sum' ? 'Sum' : combiner === 'mean' ? 'Mean' : 'SqrtN';
+      return nodeBackend().sparseSegmentReduction(
+                 reduction, params, ids.values, segmentIds, numRows) as
+          Tensor2D;
+    }
+
+    util.assert(
+        weights.nnz === ids.nnz,
+        () => `Expected ${ids.nnz} weights, but got ${weights.nnz}`);
+    const weighted =
+        mul(gather(params, ids.values), weights.values.as2D(-1, 1));
+    const sum = unsortedSegmentSum(weighted, segmentIds, numRows) as Tensor2D;
+    if (combiner === 'sum') {
+      return sum;
+    }
+    let normalizer: Tensor;
+    if (combiner === 'mean') {
+      normalizer = unsortedSegmentSum(weights.values, segmentIds, numRows);
+    } else {
+      normalizer = sqrt(
+          unsortedSegmentSum(square(weights.values), segmentIds, numRows));
+    }
+    normalizer = normalizer.as2D(-1, 1);
+    // Rows without IDs have a normalizer of 0 and stay 0.
+    return where(
+               greater(normalizer, 0).tile([1, sum.shape[1]]),
+               div(sum, normalizer), zerosLike(sum)) as Tensor2D;
+  });
+}
+
+export const sparse = {
+  tensor: sparseTensor,
+  fromRaggedIds,
+  matMul,
+  segmentSum,
+  segmentMean,
+  segmentSqrtN,
+  embeddingLookup
+};
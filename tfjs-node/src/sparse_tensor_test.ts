@@ -0,0 +1,118 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+
+describe('sparse', () => {
+  it('tensor() and toDense()', async () => {
+    const a = tf.node.sparse.tensor([[0, 1], [2, 0]], [5, 6], [3, 2]);
+    expect(a.rank).toEqual(2);
+    expect(a.nnz).toEqual(2);
+    tf.test_util.expectArraysClose(
+        await a.toDense().data(), [0, 5, 0, 0, 6, 0]);
+  });
+
+  it('tensor() validates the shapes of indices and values', () => {
+    expect(() => tf.node.sparse.tensor([[0, 1]], [1, 2], [2, 2]))
+        .toThrowError(/Expected values of shape \[1\]/);
+    expect(() => tf.node.sparse.tensor([[0, 1, 0]], [1], [2, 2]))
+        .toThrowError();
+  });
+
+  it('fromRaggedIds()', async () => {
+    const ids = tf.node.sparse.fromRaggedIds([[3, 1], [], [7]]);
+    expect(ids.denseShape).toEqual([3, 2]);
+    expect(ids.dtype).toEqual('int32');
+    expect(await ids.indices.array()).toEqual([[0, 0], [0, 1], [2, 0]]);
+    expect(await ids.values.array()).toEqual([3, 1, 7]);
+  });
+
+  it('matMul() matches the dense product', async () => {
+    const a =
+        tf.node.sparse.tensor([[0, 1], [1, 0], [1, 2]], [2, 3, 4], [2, 3]);
+    const b = tf.tensor2d([[1, 2], [3, 4], [5, 6]]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.matMul(a, b).data(),
+        await tf.matMul(a.toDense() as tf.Tensor2D, b).data());
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.matMul(a, b.transpose(), false, true).data(),
+        await tf.matMul(a.toDense() as tf.Tensor2D, b).data());
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.matMul(a, tf.ones([2, 1]), true).data(),
+        [3, 2, 4]);
+  });
+
+  it('segmentSum() and segmentMean()', async () => {
+    const data = tf.tensor2d([[1, 2], [3, 4], [5, 6]]);
+    const indices = tf.tensor1d([0, 2, 1], 'int32');
+    const segmentIds = tf.tensor1d([0, 0, 1], 'int32');
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.segmentSum(data, indices, segmentIds).data(),
+        [6, 8, 3, 4]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.segmentMean(data, indices, segmentIds).data(),
+        [3, 4, 3, 4]);
+    const numTensors = tf.memory().numTensors;
+    const sum = tf.node.sparse.segmentSum(data, indices, segmentIds, 3);
+    // Only the result is kept, not the number of segments.
+    expect(tf.memory().numTensors).toEqual(numTensors + 1);
+    expect(sum.shape).toEqual([3, 2]);
+    tf.test_util.expectArraysClose(
+        await sum.data(), [6, 8, 3, 4, 0, 0]);
+  });
+
+  it('embeddingLookup() combiners', async () => {
+    const params = tf.tensor2d([[1, 1], [2, 4], [3, 9], [4, 16]]);
+    const ids = tf.node.sparse.fromRaggedIds([[1, 3], [], [2]]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids).data(),
+        [3, 10, 0, 0, 3, 9]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids, null, 'sum').data(),
+        [6, 20, 0, 0, 3, 9]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids, null, 'sqrtn')
+            .data(),
+        [6 / Math.SQRT2, 20 / Math.SQRT2, 0, 0, 3, 9]);
+  });
+
+  it('embeddingLookup() with weights', async () => {
+    const params = tf.tensor2d([[1, 1], [2, 4], [3, 9], [4, 16]]);
+    const ids = tf.node.sparse.fromRaggedIds([[1, 3], [], [2]]);
+    const weights = tf.node.sparse.tensor(
+        ids.indices, tf.tensor1d([1, 3, 2]), ids.denseShape);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids, weights, 'sum')
+            .data(),
+        [14, 52, 0, 0, 6, 18]);
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids, weights, 'mean')
+            .data(),
+        [3.5, 13, 0, 0, 3, 9]);
+  });
+
+  it('embeddingLookup() matches a dense multi-hot product', async () => {
+    const params = tf.randomNormal([50, 8]) as tf.Tensor2D;
+    const rows = [[0, 7, 49], [3], [10, 11]];
+    const ids = tf.node.sparse.fromRaggedIds(rows);
+    const multiHot = tf.buffer([3, 50]);
+    rows.forEach((row, i) => row.forEach(id => multiHot.set(1, i, id)));
+    tf.test_util.expectArraysClose(
+        await tf.node.sparse.embeddingLookup(params, ids, null, 'sum').data(),
+        await tf.matMul(multiHot.toTensor() as tf.Tensor2D, params).data());
+  });
+});
@@ -0,0 +1,80 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import {util} from '@tensorflow/tfjs-core';
+import {DataTypeMap} from '@tensorflow/tfjs-core/dist/types';
+import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
+
+/** Data types that can be backed by a native tensor buffer. */
+export type TensorBufferDataType = 'float32'|'int32'|'bool';
+
+/**
+ * Allocate a typed array for tensor data in native memory.
+ *
+ * The memory is aligned as TensorFlow requires, so a tensor created from the
+ * returned array (e.g., with `tf.tensor()`) shares the memory with the
+ * TensorFlow tensor instead of copying it. Typed arrays allocated by
+ * JavaScript make no alignment guarantee, and TensorFlow copies the ones that
+ * are misaligned.
+ *
+ * The array is zero-initialized. Its memory is released when both the array
+ * and all tensors created from it have been garbage collected or disposed.
+ * Writing to the array after a tensor has been created from it changes the
+ * values of that tensor.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const values = tf.node.allocTensorBuffer('float32', [2, 3]);
+ * values.set([1, 2, 3, 4, 5, 6]);
+ * const x = tf.tensor(values, [2, 3]);
+ * ```
+ *
+ * @param dtype The data type of the tensor, one of `'float32'`, `'int32'` or
+ *   `'bool'`.
+ * @param shape The shape of the tensor.
+ * @returns A `Float32Array`, `Int32Array` or `Uint8Array`, depending on
+ *   `dtype`, with one element per element of the tensor.
+ */
+/**
+ * @doc {heading: 'Tensors', subheading: 'Creation', namespace: 'node'}
+ */
+export function allocTensorBuffer<D extends TensorBufferDataType>(
+    dtype: D, shape: number[]): DataTypeMap[D] {
+  ensureTensorflowBackend();
+  for (const dim of shape) {
+    util.assert(
+        Number.isInteger(dim) && dim >= 0,
+        () => `Expected shape to contain non-negative integers, but got ` +
+            `[${shape}]`);
+  }
+  const size = util.sizeFromShape(shape);
+  switch (dtype) {
+    case 'float32':
+      return new Float32Array(nodeBackend().binding.allocTensorBuffer(
+                 size * Float32Array.BYTES_PER_ELEMENT)) as DataTypeMap[D];
+    case 'int32':
+      return new Int32Array(nodeBackend().binding.allocTensorBuffer(
+                 size * Int32Array.BYTES_PER_ELEMENT)) as DataTypeMap[D];
+    case 'bool':
+      return new Uint8Array(nodeBackend().binding.allocTensorBuffer(size)) as
+          DataTypeMap[D];
+    default:
+      throw new Error(`Unsupported dtype for a tensor buffer: ${dtype}`);
+  }
+}
@@ -0,0 +1,104 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as tf from './index';
+import {nodeBackend} from './ops/op_utils';
+
+describe('allocTensorBuffer', () => {
+  it('Returns zero-initialized typed arrays of the right type', () => {
+    const floats = tf.node.allocTensorBuffer('float32', [2, 3]);
+    expect(floats instanceof Float32Array).toBe(true);
+    expect(floats).toEqual(new Float32Array(6));
+
+    const ints = tf.node.allocTensorBuffer('int32', [4]);
+    expect(ints instanceof Int32Array).toBe(true);
+    expect(ints.length).toEqual(4);
+
+    const bools = tf.node.allocTensorBuffer('bool', [2, 2]);
+    expect(bools instanceof Uint8Array).toBe(true);
+    expect(bools.length).toEqual(4);
+  });
+
+  it('Supports empty shapes', () => {
+    expect(tf.node.allocTensorBuffer('float32', []).length).toEqual(1);
+    expect(tf.node.allocTensorBuffer('float32', [0, 3]).length).toEqual(0);
+  });
+
+  it('Tensors are created without copying the data', async () => {
+    const binding = nodeBackend().binding;
+    const values = tf.node.allocTensorBuffer('float32', [2, 2]);
+    values.set([1, 2, 3, 4]);
+
+    const before = binding.getTensorUploadStats();
+    const x = tf.tensor(values, [2, 2]);
+    const y = x.add(x);
+    const after = binding.getTensorUploadStats();
+
+    expect(after.numShared - before.numShared).toEqual(1);
+    expect(after.numCopied).toEqual(before.numCopied);
+    tf.test_util.expectArraysClose(await y.data(), [2, 4, 6, 8]);
+  });
+
+  it('Misaligned typed arrays are counted as copies', () => {
+    const binding = nodeBackend().binding;
+    const buffer = binding.allocTensorBuffer(5 * 4);
+    const values = new Float32Array(buffer, 4, 4);
+
+    const before = binding.getTensorUploadStats();
+    const id = binding.createTensor([4], binding.TF_FLOAT, values);
+    const after = binding.getTensorUploadStats();
+    binding.deleteTensor(id);
+
+    expect(after.numCopied - before.numCopied).toEqual(1);
+  });
+
+  it('Tensors built natively are not counted as copies', () => {
+    const binding = nodeBackend().binding;
+
+    const before = binding.getTensorUploadStats();
+    const ids = [
+      binding.createTensorFromPixels(
+          new Uint8Array(4), 1, 1, 3, binding.TF_INT32, false),
+      binding.createTensorFromChunks(
+          [2], binding.TF_FLOAT, [new Float32Array(1), new Float32Array(1)])
+    ];
+    const after = binding.getTensorUploadStats();
+    ids.forEach(id => binding.deleteTensor(id));
+
+    expect(after.numCopied).toEqual(before.numCopied);
+  });
+
+  it('Same-device uploads are not copied', () => {
+    if (nodeBackend().isGPUPackage) {
+      return;
+    }
+    const binding = nodeBackend().binding;
+    const before = binding.getTensorUploadStats();
+    const id = binding.createTensor(
+        [2], binding.TF_FLOAT, tf.node.allocTensorBuffer('float32', [2]));
+    binding.deleteTensor(id);
+    expect(binding.getTensorUploadStats().numDeviceCopies)
+        .toEqual(before.numDeviceCopies);
+  });
+
+  it('Throws for invalid shapes', () => {
+    expect(() => tf.node.allocTensorBuffer('float32', [-1]))
+        .toThrowError(/non-negative integers/);
+    expect(() => tf.node.allocTensorBuffer('int32', [1.5]))
+        .toThrowError(/non-negative integers/);
+  });
+});
@@ -16,7 +16,8 @@
  * =============================================================================
  */
 
-import {Scalar, Tensor, util} from '@tensorflow/tfjs';
+// tslint:disable-next-line:max-line-length
+import {Rank, Scalar, Tensor, Tensor3D, Tensor4D, tensor1d, util} from '@tensorflow/tfjs';
 import {NodeJSKernelBackend} from './nodejs_kernel_backend';
 import {ensureTensorflowBackend, nodeBackend} from './ops/op_utils';
 
@@ -31,6 +32,9 @@ export class SummaryFileWriter {
   /**
    * Write a scalar summary.
    *
+   * The summary is queued and written on a background thread, in order with
+   * the other scalar summaries; call `flush()` to wait for it to be written.
+   *
    * @param name A name of the summary. The summary tag for TensorBoard will be
    *   this name.
    * @param value A real numeric scalar value, as `tf.Scalar` or a JavaScript
@@ -50,8 +54,110 @@ export class SummaryFileWriter {
     this.backend.writeScalarSummary(this.resourceHandle, step, name, value);
   }
 
+  /**
+   * Write several scalar summaries that share one step.
+   *
+   * The summaries are queued and written together on a background thread;
+   * call `flush()` to wait for them to be written.
+   *
+   * @param values A map from summary names to real numeric values.
+   * @param step Required `int64`-castable, monotically-increasing step value.
+   */
+  scalars(values: {[name: string]: number}, step: number) {
+    this.backend.writeScalarSummaries(this.resourceHandle, step, values);
+  }
+
+  /**
+   * Write a histogram summary.
+   *
+   * The histogram is computed by TensorFlow where the tensor lives; the
+   * values are not read into JavaScript.
+   *
+   * @param name A name of the summary. The summary tag for TensorBoard will be
+   *   this name.
+   * @param data A numeric `tf.Tensor` of any shape, or a flat array of
+   *   values.
+   * @param step Required `int64`-castable, monotically-increasing step value.
+   */
+  histogram(
+      name: string, data: Tensor|number[]|Float32Array|Int32Array,
+      step: number) {
+    if (data instanceof Tensor) {
+      this.backend.writeHistogramSummary(this.resourceHandle, step, name, data);
+    } else {
+      const values = tensor1d(data);
+      try {
+        this.backend.writeHistogramSummary(
+            this.resourceHandle, step, name, values);
+      } finally {
+        values.dispose();
+      }
+    }
+  }
+
+  /**
+   * Write an image summary.
+   *
+   * The images are encoded as PNG by TensorFlow, without a round trip
+   * through JavaScript.
+   *
+   * @param name A name of the summary. The summary tag for TensorBoard will be
+   *   this name.
+   * @param images A `tf.Tensor3D` (one image) or `tf.Tensor4D` (a batch of
+   *   images) of shape `[..., height, width, channels]`, where `channels` is
+   *   1 (grayscale), 3 (RGB) or 4 (RGBA). `int32` images hold pixel values in
+   *   `[0, 255]`. `float32` images are normalized: if all values are
+   *   non-negative, they are scaled so that the largest value is 255;
+   *   otherwise they are shifted so that 0 maps to 127.
+   * @param step Required `int64`-castable, monotically-increasing step value.
+   * @param maxImages Maximum number of images of the batch to write (default:
+   *   `3`).
+   */
+  image(
+      name: string, images: Tensor3D|Tensor4D, step: number, maxImages = 3) {
+    util.assert(
+        images.rank === 3 || images.rank === 4,
+        () => `Expected images to be of rank 3 or 4, but got rank ` +
+            `${images.rank}`);
+    const channels = images.shape[images.rank - 1];
+    util.assert(
+        channels === 1 || channels === 3 || channels === 4,
+        () => `Expected images to have 1, 3 or 4 channels, but got ` +
+            `${channels}`);
+    util.assert(
+        Number.isInteger(maxImages) && maxImages > 0,
+        () => `Expected maxImages to be a positive integer, but got ` +
+            `${maxImages}`);
+    const batch = images.rank === 3 ? images.expandDims<Rank.R4>(0) : images;
+    try {
+      this.backend.writeImageSummary(
+          this.resourceHandle, step, name, batch as Tensor4D, maxImages);
+    } finally {
+      if (batch !== images) {
+        batch.dispose();
+      }
+    }
+  }
+
+  /**
+   * Write a text summary.
+   *
+   * TensorBoard renders the text as Markdown.
+   *
+   * @param name A name of the summary. The summary tag for TensorBoard will be
+   *   this name.
+   * @param text The text, as a JavaScript `string` or a `string`-type
+   *   `tf.Tensor` (a tensor of strings is rendered as a table).
+   * @param step Required `int64`-castable, monotically-increasing step value.
+   */
+  text(name: string, text: string|Tensor, step: number) {
+    this.backend.writeTextSummary(this.resourceHandle, step, name, text);
+  }
+
   /**
    * Force summary writer to send all buffered data to storage.
+   *
+   * Blocks until all queued summaries have been written.
    */
   flush() {
     this.backend.flushSummaryWriter(this.resourceHandle);
@@ -20,6 +20,7 @@ import * as fs from 'fs';
 import * as path from 'path';
 import {promisify} from 'util';
 
+import {DeferredLogs} from './callbacks';
 import * as tfn from './index';
 
 // tslint:disable-next-line:no-require-imports
@@ -29,6 +30,12 @@ const tmp = require('tmp');
 
 const rimrafPromise = promisify(rimraf);
 
+function getEventFileSize(logDir: string): number {
+  const fileNames = fs.readdirSync(logDir);
+  expect(fileNames.length).toEqual(1);
+  return fs.statSync(path.join(logDir, fileNames[0])).size;
+}
+
 describe('tensorboard', () => {
   let tmpLogDir: string;
 
@@ -133,6 +140,111 @@ describe('tensorboard', () => {
     expect(fileSize2Num2 - fileSize2Num1).toEqual(2 * incrementPerScalar);
   });
 
+  it('scalars() writes several tags in one call', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    writer.scalar('foo', 42, 0);
+    writer.flush();
+    const fileNames = fs.readdirSync(tmpLogDir);
+    expect(fileNames.length).toEqual(1);
+    const eventFilePath = path.join(tmpLogDir, fileNames[0]);
+    const fileSize0 = fs.statSync(eventFilePath).size;
+
+    writer.scalar('foo', 43, 1);
+    writer.flush();
+    const fileSize1 = fs.statSync(eventFilePath).size;
+    const incrementPerScalar = fileSize1 - fileSize0;
+
+    // Tags of the same length lead to events of the same size.
+    writer.scalars({foo: 44, bar: 45, baz: 46}, 2);
+    writer.flush();
+    const fileSize2 = fs.statSync(eventFilePath).size;
+    expect(fileSize2 - fileSize1).toEqual(3 * incrementPerScalar);
+  });
+
+  it('Scalar values are queued without a readback', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    writer.scalar('foo', 42, 0);
+    writer.flush();
+    const fileSize0 = getEventFileSize(tmpLogDir);
+
+    const binding = writer.backend.binding;
+    const numberSpy =
+        spyOn(binding, 'writeScalarSummaries').and.callThrough();
+    const tensorSpy =
+        spyOn(binding, 'writeScalarSummaryTensor').and.callThrough();
+    const value1 = scalar(43);
+    const value2 = scalar(44, 'int32');
+    const readSpy = spyOn(value1, 'dataSync').and.callThrough();
+    writer.scalar('foo', value1, 1);
+    writer.scalar('foo', 45, 2);
+    writer.scalar('foo', value2, 3);
+    // The values are only read on the writer thread.
+    value1.dispose();
+    value2.dispose();
+    writer.flush();
+
+    expect(numberSpy).toHaveBeenCalledTimes(1);
+    expect(tensorSpy).toHaveBeenCalledTimes(2);
+    expect(readSpy).not.toHaveBeenCalled();
+    expect(getEventFileSize(tmpLogDir) - fileSize0).toBeGreaterThan(0);
+  });
+
+  it('scalars() with a non-integer step leads to error', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    expect(() => writer.scalars({foo: 42}, 1.5)).toThrowError(/integer/);
+  });
+
+  it('Write histogram of a tensor and of an array', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    writer.histogram('foo', tfn.randomNormal([100, 10]), 0);
+    writer.flush();
+    const fileSize0 = getEventFileSize(tmpLogDir);
+    expect(fileSize0).toBeGreaterThan(0);
+
+    writer.histogram('bar', [1, 2, 2, 3, 3, 3], 1);
+    writer.flush();
+    expect(getEventFileSize(tmpLogDir)).toBeGreaterThan(fileSize0);
+  });
+
+  it('histogram() of a string tensor leads to error', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    expect(() => writer.histogram('foo', tfn.tensor1d(['a']), 0))
+        .toThrowError(/numeric/);
+  });
+
+  it('Write float32 and int32 images', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    writer.image(
+        'float', tfn.randomUniform([2, 8, 8, 3]) as tfn.Tensor4D, 0);
+    writer.flush();
+    const fileSize0 = getEventFileSize(tmpLogDir);
+    expect(fileSize0).toBeGreaterThan(0);
+
+    const pixels =
+        tfn.randomUniform([8, 8, 1], 0, 255, 'int32') as tfn.Tensor3D;
+    writer.image('int', pixels, 1);
+    writer.flush();
+    expect(getEventFileSize(tmpLogDir)).toBeGreaterThan(fileSize0);
+  });
+
+  it('image() with an invalid number of channels leads to error', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    const images = tfn.zeros([1, 8, 8, 2]) as tfn.Tensor4D;
+    expect(() => writer.image('foo', images, 0)).toThrowError(/channels/);
+  });
+
+  it('Write text', () => {
+    const writer = tfn.node.summaryFileWriter(tmpLogDir);
+    writer.text('foo', '**Hello** TensorBoard', 0);
+    writer.flush();
+    const fileSize0 = getEventFileSize(tmpLogDir);
+    expect(fileSize0).toBeGreaterThan(0);
+
+    writer.text('bar', tfn.tensor2d([['a', 'b'], ['c', 'd']]), 1);
+    writer.flush();
+    expect(getEventFileSize(tmpLogDir)).toBeGreaterThan(fileSize0);
+  });
+
   it('Writing into existing directory works', () => {
     fs.mkdirSync(tmpLogDir, {recursive: true});
     const writer = tfn.node.summaryFileWriter(path.join(tmpLogDir, '22'));
@@ -290,6 +402,88 @@ describe('tensorBoard callback', () => {
     expect(trainFileSize1).toBeGreaterThan(valFileSize1);
   });
 
+  it('fit(): histogramFreq writes weight histograms', async () => {
+    const model = createModelForTest();
+    const xs = tfn.randomUniform([100, 10]);
+    const ys = tfn.randomUniform([100, 1]);
+
+    await model.fit(xs, ys, {
+      epochs: 2,
+      verbose: 0,
+      callbacks: tfn.node.tensorBoard(path.join(tmpLogDir, 'no_histograms'))
+    });
+    await model.fit(xs, ys, {
+      epochs: 2,
+      verbose: 0,
+      callbacks: tfn.node.tensorBoard(
+          path.join(tmpLogDir, 'histograms'), {histogramFreq: 1})
+    });
+
+    const sizeWithout =
+        getEventFileSize(path.join(tmpLogDir, 'no_histograms', 'train'));
+    const sizeWith =
+        getEventFileSize(path.join(tmpLogDir, 'histograms', 'train'));
+    expect(sizeWith).toBeGreaterThan(sizeWithout);
+  });
+
+  it('fit(): deferLogs writes the same batch logs', async () => {
+    const model = createModelForTest();
+    const xs = tfn.randomUniform([100, 10]);
+    const ys = tfn.randomUniform([100, 1]);
+
+    await model.fit(xs, ys, {
+      epochs: 2,
+      batchSize: 10,
+      verbose: 0,
+      callbacks: tfn.node.tensorBoard(
+          path.join(tmpLogDir, 'immediate'), {updateFreq: 'batch'})
+    });
+    await model.fit(xs, ys, {
+      epochs: 2,
+      batchSize: 10,
+      verbose: 0,
+      callbacks: tfn.node.tensorBoard(
+          path.join(tmpLogDir, 'deferred'),
+          {updateFreq: 'batch', deferLogs: true})
+    });
+
+    // The same tags are written for the same steps.
+    expect(getEventFileSize(path.join(tmpLogDir, 'deferred', 'train')))
+        .toEqual(getEventFileSize(path.join(tmpLogDir, 'immediate', 'train')));
+  });
+
+  it('fit(): failed reads of deferred logs are logged', async () => {
+    const model = createModelForTest();
+    const xs = tfn.randomUniform([20, 10]);
+    const ys = tfn.randomUniform([20, 1]);
+    const read = DeferredLogs.prototype.read;
+    let numReads = 0;
+    spyOn(DeferredLogs.prototype, 'read')
+        .and.callFake(function(this: DeferredLogs) {
+          return numReads++ === 0 ? Promise.reject(new Error('read failed')) :
+                                    read.call(this);
+        });
+    const warnSpy = spyOn(console, 'warn');
+
+    // Training goes on, and the logs of later reads are written.
+    await model.fit(xs, ys, {
+      epochs: 2,
+      batchSize: 10,
+      verbose: 0,
+      callbacks: tfn.node.tensorBoard(
+          tmpLogDir, {updateFreq: 'batch', deferLogs: true})
+    });
+    expect(numReads).toBeGreaterThan(1);
+    expect(warnSpy).toHaveBeenCalledTimes(1);
+    expect(warnSpy.calls.argsFor(0)[0]).toMatch(/read failed/);
+    expect(getEventFileSize(path.join(tmpLogDir, 'train'))).toBeGreaterThan(0);
+  });
+
+  it('Invalid histogramFreq value causes error', () => {
+    expect(() => tfn.node.tensorBoard(tmpLogDir, {histogramFreq: -1}))
+        .toThrowError(/Expected histogramFreq/);
+  });
+
   it('Invalid updateFreq value causes error', async () => {
     expect(() => tfn.node.tensorBoard(tmpLogDir, {
       // tslint:disable-next-line:no-any
@@ -29,6 +29,31 @@ export declare class TFEOpAttr {
   value: boolean | number | object | string | number[];
 }
 
+export interface TensorUploadStats {
+  numShared: number;
+  numCopied: number;
+  numDeviceCopies: number;
+}
+
+export interface OpMetrics {
+  name: string;
+  count: number;
+  totalNanos: number;
+  // Bucket i counts executions of at most 2^i microseconds; the last bucket
+  // counts the rest.
+  latencyBuckets: number[];
+}
+
+export interface BackendMetrics {
+  ops: OpMetrics[];
+  numAllocations: number;
+  numAllocatedBytes: number;
+  numUploads: number;
+  numUploadBytes: number;
+  numReadbacks: number;
+  numReadbackBytes: number;
+}
+
 export interface TFJSBinding {
   TensorMetadata: typeof TensorMetadata;
   TFEOpAttr: typeof TFEOpAttr;
@@ -36,17 +61,84 @@ export interface TFJSBinding {
   // Creates a tensor with the backend:
   createTensor(shape: number[], dtype: number, buffer: BackendValues): number;
 
+  // Creates a tensor from the concatenation of typed arrays, copying each of
+  // them into place without creating a tensor per chunk:
+  createTensorFromChunks(
+      shape: number[], dtype: number,
+      chunks: Array<Float32Array|Int32Array|Uint8Array>): number;
+
+  // Creates an int32 or float32 tensor with shape [height, width, numChannels]
+  // from RGBA pixels, keeping the first numChannels channels. Float values are
+  // divided by 255 if normalize is true:
+  createTensorFromPixels(
+      pixels: Uint8Array|Uint8ClampedArray, height: number, width: number,
+      numChannels: number, dtype: number, normalize: boolean): number;
+
+  // Creates a tensor with the given shape that shares the memory of an
+  // existing tensor from elementOffset on. Returns -1 if the memory can't be
+  // shared, e.g., because the tensor is placed on a GPU:
+  createTensorView(tensorId: number, elementOffset: number, shape: number[]):
+      number;
+
   // Deletes a tensor with the backend:
   deleteTensor(tensorId: number): void;
 
+  // Allocates a zero-initialized ArrayBuffer over native memory that is
+  // aligned for zero-copy use by createTensor():
+  allocTensorBuffer(byteLength: number): ArrayBuffer;
+
+  // Returns how many typed-array uploads in createTensor() shared the JS
+  // memory, were copied by TensorFlow, and were copied to another device:
+  getTensorUploadStats(): TensorUploadStats;
+
+  // Returns the number of live tensors and the bytes of data they hold:
+  getMemoryInfo(): {numTensors: number, numBytes: number};
+
+  // Returns per-op execution counts and latency histograms, and counters of
+  // tensor allocations, uploads and readbacks:
+  getMetrics(): BackendMetrics;
+
+  // Creates the TensorFlow eager context, which is otherwise created by the
+  // first createTensor() or executeOp() call:
+  initContext(): void;
+
+  // Returns whether the TensorFlow eager context has been created:
+  isContextInitialized(): boolean;
+
   // Reads data-sync from a tensor on the backend:
   tensorDataSync(tensorId: number): Float32Array | Int32Array | Uint8Array;
 
+  // Copies the data of a tensor into an existing typed array of the matching
+  // type and length:
+  tensorDataInto(
+    tensorId: number, array: Float32Array | Int32Array | Uint8Array): void;
+
   // Executes an Op on the backend, returns an array of output TensorMetadata:
   executeOp(
     opName: string, opAttrs: TFEOpAttr[], inputTensorIds: number[],
     numOutputs: number): TensorMetadata[];
 
+  // Executes an Op on the libuv thread pool, returns a promise of an array of
+  // output TensorMetadata:
+  executeOpAsync(
+    opName: string, opAttrs: TFEOpAttr[], inputTensorIds: number[],
+    numOutputs: number): Promise<TensorMetadata[]>;
+
+  // Enqueues scalar summaries that share one step, to be written on a
+  // background thread:
+  writeScalarSummaries(
+    writerTensorId: number, step: number, tags: string[],
+    values: Float32Array): void;
+
+  // Enqueues a scalar summary whose value is a scalar tensor, which is read
+  // on the background thread:
+  writeScalarSummaryTensor(
+    writerTensorId: number, step: number, tag: string,
+    valueTensorId: number): void;
+
+  // Blocks until all enqueued summaries have been written:
+  flushSummaryWrites(): void;
+
   // TF Types
   TF_FLOAT: number;
   TF_INT32: number;
@@ -56,6 +148,10 @@ export interface TFJSBinding {
   TF_STRING: number;
   TF_RESOURCE: number;
   TF_UINT8: number;
+  TF_VARIANT: number;
+  TF_QINT8: number;
+  TF_QUINT8: number;
+  TF_QINT32: number;
 
   // TF OpAttrTypes
   TF_ATTR_STRING: number;
@@ -0,0 +1,333 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// tslint:disable-next-line:max-line-length
+import {DataType, InferenceModel, Tensor, tidy, util, zeros} from '@tensorflow/tfjs-core';
+import {BackendValues} from '@tensorflow/tfjs-core/dist/types';
+import * as fs from 'fs';
+import {promisify} from 'util';
+import {Int64Scalar} from './int64_tensors';
+import {ensureTensorflowBackend, getTFDType, nodeBackend} from './ops/op_utils';
+import {TFEOpAttr} from './tfjs_binding';
+
+const readFile = promisify(fs.readFile);
+const writeFile = promisify(fs.writeFile);
+
+const WARMUP_RECORD_FORMAT = 'tfjs-node-warmup';
+const WARMUP_RECORD_VERSION = 1;
+
+// The values of small int32 and int64 inputs (shapes, axes, permutations,
+// ...) are recorded while they are still held in JavaScript, i.e., before
+// their first upload. Other inputs are replayed as zeros.
+const MAX_RECORDED_VALUES = 16;
+
+// Number of recorded ops that `prewarm()` replays before yielding to the
+// event loop.
+const OPS_PER_TICK = 32;
+
+/** The shape and dtype of one model input. */
+export interface WarmupInput {
+  /**
+   * The shape of the input. `null` or `-1` dimensions (typically the batch
+   * dimension) are replaced by each of the `batchSizes`.
+   */
+  shape: number[];
+
+  /** Default: `'float32'`. */
+  dtype?: DataType;
+}
+
+export interface WarmupArgs {
+  /**
+   * The sizes that replace the unknown dimensions of the input signature.
+   * The model is executed once per size, so these should cover the shapes
+   * that are expected in production.
+   *
+   * Default: `[1]`.
+   */
+  batchSizes?: number[];
+
+  /**
+   * How many times the model is executed for each batch size. The first run
+   * instantiates the kernels, later runs let the allocator reach its steady
+   * state.
+   *
+   * Default: `2`.
+   */
+  numRuns?: number;
+
+  /**
+   * If set, the warm-up record is also written to this file as JSON, for
+   * `prewarm()` in later processes.
+   */
+  recordPath?: string;
+}
+
+/** An input of a recorded op. */
+export interface RecordedInput {
+  shape: number[];
+  dtype: DataType|'int64';
+  values?: number[];
+}
+
+/** An op execution recorded by `warmup()`. */
+export interface RecordedOp {
+  name: string;
+  attrs: TFEOpAttr[];
+  inputs: RecordedInput[];
+  numOutputs: number;
+}
+
+/** The distinct ops that a model executed during `warmup()`. */
+export interface WarmupRecord {
+  format: string;
+  version: number;
+  ops: RecordedOp[];
+}
+
+/** Resolves on the next turn of the event loop. */
+function nextTick(): Promise<void> {
+  return new Promise<void>(resolve => setImmediate(resolve));
+}
+
+function recordInput(input: Tensor|Int64Scalar): RecordedInput {
+  if (input instanceof Int64Scalar) {
+    return {shape: [], dtype: 'int64', values: [input.value]};
+  }
+  const recorded: RecordedInput = {
+    shape: input.shape.slice(),
+    dtype: input.dtype
+  };
+  if (input.dtype === 'int32' && input.size <= MAX_RECORDED_VALUES) {
+    // Values are never read back from TensorFlow, which would synchronize
+    // on every op.
+    const values = nodeBackend().getPendingValues(input.dataId);
+    if (values != null) {
+      recorded.values = Array.from(values as Int32Array);
+    }
+  }
+  return recorded;
+}
+
+function createInputValues(input: RecordedInput): BackendValues {
+  const size = util.sizeFromShape(input.shape);
+  switch (input.dtype) {
+    case 'float32':
+      return new Float32Array(size);
+    case 'int32':
+      return input.values != null ? new Int32Array(input.values) :
+                                    new Int32Array(size);
+    case 'bool':
+      return new Uint8Array(size);
+    case 'string':
+      return Array.from({length: size}, () => new Uint8Array(0));
+    case 'int64':
+      return new Int64Scalar(input.values[0]).valueArray;
+    default:
+      throw new Error(`Cannot replay an input of dtype ${input.dtype}`);
+  }
+}
+
+/**
+ * Executes a recorded op on new input tensors and deletes its outputs.
+ * Returns false if the op could not be executed.
+ */
+function replayOp(op: RecordedOp): boolean {
+  const binding = nodeBackend().binding;
+  const inputIds: number[] = [];
+  try {
+    for (const input of op.inputs) {
+      inputIds.push(binding.createTensor(
+          input.shape, getTFDType(input.dtype as DataType),
+          createInputValues(input)));
+    }
+    const outputs =
+        binding.executeOp(op.name, op.attrs, inputIds, op.numOutputs);
+    outputs.forEach(output => binding.deleteTensor(output.id));
+    return true;
+  } catch (e) {
+    // Zeros are not valid inputs of every op, e.g., of a Gather with
+    // recorded indices.
+    return false;
+  } finally {
+    inputIds.forEach(id => binding.deleteTensor(id));
+  }
+}
+
+/**
+ * Warm up a model and record the kernels that it uses.
+ *
+ * The first execution of a model is much slower than later ones: TensorFlow
+ * looks up and instantiates a kernel for every op and shape, and grows its
+ * allocator. `warmup()` executes the model on zero-filled inputs for each of
+ * the `batchSizes`, yielding to the event loop between executions so that a
+ * server can keep handling requests meanwhile.
+ *
+ * Each execution is a synchronous `model.predict()` call on the main thread,
+ * so warm-up does not run in the background: the event loop is blocked for
+ * the duration of one prediction at a time.
+ *
+ * Every distinct op (name, attributes and input shapes) executed during the
+ * first run of each batch size is returned as a `WarmupRecord`. Short-lived
+ * processes can pass this record to `tf.node.prewarm()` at startup to
+ * instantiate the same kernels without loading the model first.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * const model = await tf.loadLayersModel('file:///tmp/my-model/model.json');
+ * await tf.node.warmup(model, {shape: [null, 224, 224, 3]}, {
+ *   batchSizes: [1, 8],
+ *   recordPath: '/tmp/my-model/warmup.json'
+ * });
+ * ```
+ *
+ * @param model The model to warm up, e.g., a `tf.LayersModel` or a
+ *   `tf.GraphModel`.
+ * @param inputSignature The shape and dtype of the model input, or an array
+ *   with one entry per input for models with multiple inputs.
+ * @param args Optional configuration arguments.
+ * @returns The recorded ops.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export async function warmup(
+    model: InferenceModel, inputSignature: WarmupInput|WarmupInput[],
+    args?: WarmupArgs): Promise<WarmupRecord> {
+  ensureTensorflowBackend();
+  args = args == null ? {} : args;
+  const signature =
+      Array.isArray(inputSignature) ? inputSignature : [inputSignature];
+  const batchSizes = args.batchSizes == null ? [1] : args.batchSizes;
+  const numRuns = args.numRuns == null ? 2 : args.numRuns;
+  util.assert(
+      signature.length > 0,
+      () => 'warmup() requires the signature of at least one input');
+  util.assert(
+      batchSizes.every(size => Number.isInteger(size) && size > 0),
+      () => `Expected batchSizes to be positive integers, but got ` +
+          `[${batchSizes}]`);
+  util.assert(
+      Number.isInteger(numRuns) && numRuns > 0,
+      () => `Expected numRuns to be a positive integer, but got ${numRuns}`);
+
+  const backend = nodeBackend();
+  const ops: RecordedOp[] = [];
+  const recordedKeys = new Set<string>();
+  const recordOp =
+      (name: string, opAttrs: TFEOpAttr[], inputs: Array<Tensor|Int64Scalar>,
+       numOutputs: number) => {
+        if (inputs.some(input => input.dtype === 'complex64')) {
+          return;
+        }
+        const op = {
+          name,
+          attrs: opAttrs,
+          inputs: inputs.map(recordInput),
+          numOutputs
+        };
+        const key = JSON.stringify(op);
+        if (!recordedKeys.has(key)) {
+          recordedKeys.add(key);
+          ops.push(op);
+        }
+      };
+
+  for (const batchSize of batchSizes) {
+    const shapes = signature.map(
+        input => input.shape.map(
+            dim => dim == null || dim < 0 ? batchSize : dim));
+    for (let run = 0; run < numRuns; ++run) {
+      await nextTick();
+      // The observer is only installed while the model executes
+      // synchronously, so ops of concurrent work are not recorded.
+      const previousObserver =
+          backend.setOpObserver(run === 0 ? recordOp : null);
+      try {
+        tidy(() => {
+          const inputs =
+              shapes.map((shape, i) => zeros(shape, signature[i].dtype));
+          model.predict(inputs.length === 1 ? inputs[0] : inputs, {});
+        });
+      } finally {
+        backend.setOpObserver(previousObserver);
+      }
+    }
+  }
+
+  const record: WarmupRecord = {
+    format: WARMUP_RECORD_FORMAT,
+    version: WARMUP_RECORD_VERSION,
+    ops
+  };
+  if (args.recordPath != null) {
+    await writeFile(args.recordPath, JSON.stringify(record));
+  }
+  return record;
+}
+
+/**
+ * Instantiate the kernels recorded by `tf.node.warmup()`.
+ *
+ * The TensorFlow context is created on the first op execution. `prewarm()`
+ * creates it right away and replays every recorded op once on zero-filled
+ * inputs, so that the kernels are instantiated before the first request
+ * arrives. Ops that fail with zero inputs are skipped.
+ *
+ * Example:
+ * ```js
+ * const tf = require('@tensorflow/tfjs-node');
+ *
+ * // At process startup, while the model is still loading:
+ * const prewarmed = tf.node.prewarm('/tmp/my-model/warmup.json');
+ * const model = await tf.loadLayersModel('file:///tmp/my-model/model.json');
+ * await prewarmed;
+ * ```
+ *
+ * @param record A record returned by `tf.node.warmup()`, or the path of a
+ *   file that it was saved to with the `recordPath` argument.
+ * @returns The number of ops that were replayed successfully.
+ */
+/**
+ * @doc {heading: 'Models', namespace: 'node'}
+ */
+export async function prewarm(record: WarmupRecord|string): Promise<number> {
+  ensureTensorflowBackend();
+  if (typeof record === 'string') {
+    record = JSON.parse(await readFile(record, 'utf8')) as WarmupRecord;
+  }
+  const warmupRecord = record;
+  util.assert(
+      warmupRecord.format === WARMUP_RECORD_FORMAT &&
+          warmupRecord.version === WARMUP_RECORD_VERSION,
+      () => `Unsupported warm-up record: format ${warmupRecord.format}, ` +
+          `version ${warmupRecord.version}`);
+
+  nodeBackend().binding.initContext();
+  let numReplayed = 0;
+  for (let i = 0; i < warmupRecord.ops.length; ++i) {
+    if (i > 0 && i % OPS_PER_TICK === 0) {
+      await nextTick();
+    }
+    if (replayOp(warmupRecord.ops[i])) {
+      numReplayed++;
+    }
+  }
+  return numReplayed;
+}
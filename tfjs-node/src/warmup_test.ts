@@ -0,0 +1,121 @@
+/**
+ * @license
+ * Copyright 2019 Google Inc. All Rights Reserved.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as rimraf from 'rimraf';
+import {promisify} from 'util';
+
+import * as tf from './index';
+import {nodeBackend} from './ops/op_utils';
+
+describe('warmup', () => {
+  const mkdtemp = promisify(fs.mkdtemp);
+  const rimrafPromise = promisify(rimraf);
+
+  let testDir: string;
+  let model: tf.Sequential;
+
+  beforeEach(async () => {
+    testDir = await mkdtemp('tfjs_node_warmup_test');
+    model = tf.sequential();
+    model.add(tf.layers.dense({units: 4, inputShape: [3], activation: 'relu'}));
+    model.add(tf.layers.dense({units: 1}));
+  });
+
+  afterEach(async () => {
+    await rimrafPromise(testDir);
+  });
+
+  it('records the ops of every batch size once', async () => {
+    const predictSpy = spyOn(model, 'predict').and.callThrough();
+    const record = await tf.node.warmup(
+        model, {shape: [null, 3]}, {batchSizes: [1, 4], numRuns: 2});
+
+    expect(predictSpy).toHaveBeenCalledTimes(4);
+    const names = record.ops.map(op => op.name);
+    expect(names).toContain('MatMul');
+    expect(names).toContain('Relu');
+    const matMulBatchSizes =
+        record.ops.filter(op => op.name === 'MatMul')
+            .map(op => op.inputs[0].shape[0]);
+    expect(matMulBatchSizes).toContain(1);
+    expect(matMulBatchSizes).toContain(4);
+    const keys = record.ops.map(op => JSON.stringify(op));
+    expect(new Set(keys).size).toEqual(keys.length);
+  });
+
+  it('records small int32 inputs without reading them back', async () => {
+    const permuteModel = tf.sequential();
+    permuteModel.add(tf.layers.permute({dims: [2, 1], inputShape: [2, 3]}));
+    const readSpy = spyOn(nodeBackend(), 'readSync').and.callThrough();
+    const record = await tf.node.warmup(permuteModel, {shape: [null, 2, 3]});
+
+    expect(readSpy).not.toHaveBeenCalled();
+    const transpose = record.ops.find(op => op.name === 'Transpose');
+    expect(transpose.inputs[0].values).toBeUndefined();
+    expect(transpose.inputs[1])
+        .toEqual({shape: [3], dtype: 'int32', values: [0, 2, 1]});
+  });
+
+  it('does not leak tensors', async () => {
+    await tf.node.warmup(model, {shape: [null, 3]});
+    const numTensors = tf.memory().numTensors;
+    await tf.node.warmup(model, {shape: [null, 3]}, {batchSizes: [2, 3]});
+    expect(tf.memory().numTensors).toEqual(numTensors);
+  });
+
+  it('stops recording after warm-up', async () => {
+    const record = await tf.node.warmup(model, {shape: [null, 3]});
+    const numOps = record.ops.length;
+    tf.square(tf.ones([2])).dispose();
+    expect(record.ops.length).toEqual(numOps);
+  });
+
+  it('prewarm() replays a saved record', async () => {
+    const recordPath = path.join(testDir, 'warmup.json');
+    const record = await tf.node.warmup(
+        model, {shape: [null, 3]}, {batchSizes: [2], recordPath});
+    expect(fs.existsSync(recordPath)).toBe(true);
+
+    const numNativeTensors = nodeBackend().binding.getMemoryInfo().numTensors;
+    const numReplayed = await tf.node.prewarm(recordPath);
+    expect(numReplayed).toEqual(record.ops.length);
+    expect(nodeBackend().binding.isContextInitialized()).toBe(true);
+    expect(nodeBackend().binding.getMemoryInfo().numTensors)
+        .toEqual(numNativeTensors);
+  });
+
+  it('prewarm() skips ops that cannot be replayed', async () => {
+    const numReplayed = await tf.node.prewarm({
+      format: 'tfjs-node-warmup',
+      version: 1,
+      ops: [{name: 'NoSuchOp', attrs: [], inputs: [], numOutputs: 1}]
+    });
+    expect(numReplayed).toEqual(0);
+  });
+
+  it('prewarm() rejects unknown records', async done => {
+    try {
+      await tf.node.prewarm({format: 'other', version: 1, ops: []});
+      done.fail('prewarm() should have failed');
+    } catch (e) {
+      expect(e.message).toMatch(/Unsupported warm-up record/);
+      done();
+    }
+  });
+});